@@ -20,9 +20,16 @@
 #ifndef SKYWELL_BASICS_LOG_H_INCLUDED
 #define SKYWELL_BASICS_LOG_H_INCLUDED
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <thread>
 #include <utility>
+#include <vector>
 #include <beast/utility/Journal.h>
 #include <boost/filesystem.hpp>
 #include <common/base/UnorderedContainers.h>
@@ -139,18 +146,47 @@ private:
         }
         /** @} */
 
+        /** Push buffered output to the system file. */
+        void flush ();
+
     private:
         std::unique_ptr <std::ofstream> m_stream;
         boost::filesystem::path m_path;
     };
 
+    struct Entry;
+    class Ring;
+
     std::mutex mutable mutex_;
     std::map <std::string, Sink> sinks_;
     beast::Journal::Severity level_;
+
+    // Identifies this object to the threads holding rings for it
+    std::uint64_t const id_;
+
+    std::mutex ringsMutex_;
+    std::vector <std::shared_ptr <Ring>> rings_;
+
+    // Held by whoever drains the rings and writes the file
+    std::mutex writeMutex_;
     File file_;
+    std::vector <Entry> batch_;
+    std::time_t stampTime_;
+    std::string stamp_;
+    std::uint64_t reportedDrops_;
+
+    std::mutex wakeMutex_;
+    std::condition_variable wakeup_;
+    std::condition_variable room_;      // Signalled after each drain
+    bool stop_;
+    std::atomic <bool> running_;
+    std::thread writer_;
+
+    std::atomic <std::uint64_t> dropped_;
 
 public:
     Logs();
+    ~Logs();
 
     Logs (Logs const&) = delete;
     Logs& operator= (Logs const&) = delete;
@@ -176,6 +212,13 @@ public:
     std::vector<std::pair<std::string, std::string>>
     partition_severities() const;
 
+    /** Queue a line for the log file and the console.
+
+        Lines are formatted and written by a dedicated thread. If the
+        calling thread has too many lines waiting, lines below warning
+        severity are dropped and the rest wait for room. Fatal lines are
+        written before this returns.
+    */
     void
     write (beast::Journal::Severity level, std::string const& partition,
         std::string const& text, bool console);
@@ -183,6 +226,10 @@ public:
     std::string
     rotate();
 
+    /** Returns the number of lines dropped because the writer fell behind. */
+    std::uint64_t
+    dropped() const;
+
 public:
     static
     LogSeverity
@@ -208,6 +255,25 @@ private:
         maximumMessageCharacters = 12 * 1024
     };
 
+    Ring&
+    ring();
+
+    void
+    wake();
+
+    void
+    run();
+
+    void
+    drain();
+
+    void
+    append (std::string& output, Entry const& entry);
+
+    static void prepareFork();
+    static void parentFork();
+    static void childFork();
+
     static
     std::string
     scrub (std::string s);
@@ -22,11 +22,117 @@
 #include <boost/algorithm/string.hpp>
 //  TODO Use std::chrono
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <algorithm>
 #include <cassert>
 #include <fstream>
+#include <iostream>
+#include <new>
+#ifdef __unix__
+#include <pthread.h>
+#endif
 
 namespace skywell {
 
+namespace {
+
+// Lines each thread can have waiting for the writer, a power of two
+std::size_t const ringCapacity = 1024;
+
+// Longest the writer waits before looking for lines
+std::chrono::milliseconds const writerInterval (10);
+
+std::atomic <std::uint64_t> nextLogsId (1);
+
+// Every Logs object, so that forking can stop and restart their writers
+std::mutex liveMutex;
+std::once_flag forkHandlers;
+
+std::vector <Logs*>&
+liveLogs ()
+{
+    static std::vector <Logs*> logs;
+    return logs;
+}
+
+}
+
+struct Logs::Entry
+{
+    std::chrono::system_clock::time_point time;
+    beast::Journal::Severity level;
+    std::string partition;
+    std::string text;
+};
+
+/** Lines from one thread on their way to the writer.
+    Only the thread which owns the ring pushes, and only the holder of
+    the write mutex pops, so the indexes need no lock.
+*/
+class Logs::Ring
+{
+public:
+    Ring ()
+        : slots_ (ringCapacity)
+        , head_ (0)
+        , tail_ (0)
+        , detached_ (false)
+    {
+    }
+
+    // The entry is moved from only if there was room
+    bool
+    push (Entry& entry)
+    {
+        std::size_t const tail = tail_.load (std::memory_order_relaxed);
+        if (tail - head_.load (std::memory_order_acquire) == slots_.size ())
+            return false;
+
+        slots_[tail & (slots_.size () - 1)] = std::move (entry);
+        tail_.store (tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool
+    pop (Entry& entry)
+    {
+        std::size_t const head = head_.load (std::memory_order_relaxed);
+        if (head == tail_.load (std::memory_order_acquire))
+            return false;
+
+        entry = std::move (slots_[head & (slots_.size () - 1)]);
+        head_.store (head + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::size_t
+    size () const
+    {
+        return tail_.load (std::memory_order_acquire) -
+            head_.load (std::memory_order_acquire);
+    }
+
+    // Called when the owning thread exits
+    void
+    detach ()
+    {
+        detached_ = true;
+    }
+
+    bool
+    detached () const
+    {
+        return detached_;
+    }
+
+private:
+    std::vector <Entry> slots_;
+    std::atomic <std::size_t> head_;
+    std::atomic <std::size_t> tail_;
+    std::atomic <bool> detached_;
+};
+
+//------------------------------------------------------------------------------
+
 Logs::Sink::Sink (std::string const& partition,
     beast::Journal::Severity severity, Logs& logs)
     : logs_(logs)
@@ -106,16 +212,56 @@ void Logs::File::writeln (char const* text)
     }
 }
 
+void Logs::File::flush ()
+{
+    if (m_stream != nullptr)
+        m_stream->flush ();
+}
+
 //------------------------------------------------------------------------------
 
 Logs::Logs()
     : level_ (beast::Journal::kWarning) // default severity
+    , id_ (nextLogsId++)
+    , stampTime_ (0)
+    , reportedDrops_ (0)
+    , stop_ (false)
+    , running_ (true)
+    , dropped_ (0)
 {
+#ifdef __unix__
+    std::call_once (forkHandlers, []
+    {
+        pthread_atfork (&Logs::prepareFork,
+            &Logs::parentFork, &Logs::childFork);
+    });
+#endif
+
+    std::lock_guard <std::mutex> lock (liveMutex);
+    liveLogs ().push_back (this);
+    writer_ = std::thread (&Logs::run, this);
+}
+
+Logs::~Logs()
+{
+    {
+        std::lock_guard <std::mutex> lock (liveMutex);
+        auto& live = liveLogs ();
+        live.erase (std::find (live.begin (), live.end (), this));
+    }
+
+    {
+        std::lock_guard <std::mutex> lock (wakeMutex_);
+        stop_ = true;
+    }
+    wakeup_.notify_one ();
+    writer_.join ();
 }
 
 bool
 Logs::open (boost::filesystem::path const& pathToLogFile)
 {
+    std::lock_guard <std::mutex> lock (writeMutex_);
     return file_.open(pathToLogFile);
 }
 
@@ -172,26 +318,258 @@ void
 Logs::write (beast::Journal::Severity level, std::string const& partition,
     std::string const& text, bool console)
 {
-    std::string s;
-    format (s, text, level, partition);
-    std::lock_guard <std::mutex> lock (mutex_);
-    file_.writeln (s);
-    std::cerr << s << '\n';
+    Entry entry {std::chrono::system_clock::now (), level, partition, text};
     //  TODO Fix console output
     //if (console)
     //    out_.write_console(s);
+
+    // Fatal lines usually come right before the process dies
+    if (level >= beast::Journal::kFatal || !running_)
+    {
+        std::lock_guard <std::mutex> lock (writeMutex_);
+        drain ();
+
+        std::string s;
+        append (s, entry);
+        file_.write (s);
+        file_.flush ();
+        std::cerr << s;
+        return;
+    }
+
+    Ring& r = ring ();
+    if (r.push (entry))
+    {
+        if (r.size () > ringCapacity / 2)
+            wake ();
+        return;
+    }
+
+    if (level < beast::Journal::kWarning)
+    {
+        ++dropped_;
+        return;
+    }
+
+    // Wait for room rather than lose a warning or an error
+    bool pushed;
+    {
+        std::unique_lock <std::mutex> lock (wakeMutex_);
+        while (!(pushed = r.push (entry)) && running_)
+        {
+            wakeup_.notify_one ();
+            room_.wait (lock);
+        }
+    }
+
+    if (!pushed)
+        write (level, partition, text, console);
 }
 
 std::string
 Logs::rotate()
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    std::lock_guard <std::mutex> lock (writeMutex_);
     bool const wasOpened = file_.closeAndReopen ();
     if (wasOpened)
         return "The log file was closed and reopened.";
     return "The log file could not be closed and reopened.";
 }
 
+std::uint64_t
+Logs::dropped() const
+{
+    return dropped_;
+}
+
+Logs::Ring&
+Logs::ring()
+{
+    // The rings this thread writes to, one per Logs object
+    struct Local
+    {
+        std::vector <std::pair <std::uint64_t, std::shared_ptr <Ring>>> rings;
+
+        ~Local ()
+        {
+            for (auto const& r : rings)
+                r.second->detach ();
+        }
+    };
+
+    static thread_local Local local;
+
+    for (auto const& r : local.rings)
+    {
+        if (r.first == id_)
+            return *r.second;
+    }
+
+    auto const r = std::make_shared <Ring> ();
+    {
+        std::lock_guard <std::mutex> lock (ringsMutex_);
+        rings_.push_back (r);
+    }
+    local.rings.emplace_back (id_, r);
+    return *r;
+}
+
+void
+Logs::wake()
+{
+    wakeup_.notify_one ();
+}
+
+void
+Logs::run()
+{
+    for (;;)
+    {
+        bool stopping;
+        {
+            std::unique_lock <std::mutex> lock (wakeMutex_);
+            if (!stop_)
+                wakeup_.wait_for (lock, writerInterval);
+            stopping = stop_;
+        }
+
+        {
+            std::lock_guard <std::mutex> lock (writeMutex_);
+            drain ();
+
+            // Later lines are written by their callers
+            if (stopping)
+            {
+                running_ = false;
+                drain ();
+            }
+        }
+
+        // Taking the lock orders this after any caller's failed push
+        {
+            std::lock_guard <std::mutex> lock (wakeMutex_);
+        }
+        room_.notify_all ();
+
+        if (stopping)
+            break;
+    }
+}
+
+void
+Logs::drain()
+{
+    std::vector <std::shared_ptr <Ring>> rings;
+    {
+        std::lock_guard <std::mutex> lock (ringsMutex_);
+        rings_.erase (std::remove_if (rings_.begin (), rings_.end (),
+            [](std::shared_ptr <Ring> const& r)
+            {
+                return r->detached () && r->size () == 0;
+            }), rings_.end ());
+        rings = rings_;
+    }
+
+    batch_.clear ();
+    for (auto const& r : rings)
+    {
+        Entry entry;
+        for (std::size_t n = 0; n < ringCapacity && r->pop (entry); ++n)
+            batch_.push_back (std::move (entry));
+    }
+
+    std::uint64_t const dropped = dropped_;
+    if (batch_.empty () && dropped == reportedDrops_)
+        return;
+
+    // Interleave the threads' lines in the order they were logged
+    std::stable_sort (batch_.begin (), batch_.end (),
+        [](Entry const& a, Entry const& b)
+        {
+            return a.time < b.time;
+        });
+
+    std::string s;
+    for (auto const& entry : batch_)
+        append (s, entry);
+
+    if (dropped != reportedDrops_)
+    {
+        Entry const notice {std::chrono::system_clock::now (),
+            beast::Journal::kWarning, "Logs", std::to_string (
+                dropped - reportedDrops_) + " lines dropped"};
+        append (s, notice);
+        reportedDrops_ = dropped;
+    }
+
+    file_.write (s);
+    file_.flush ();
+    std::cerr << s;
+}
+
+void
+Logs::append (std::string& output, Entry const& entry)
+{
+    // Lines arrive in bursts within the same second
+    std::time_t const t = std::chrono::system_clock::to_time_t (entry.time);
+    if (t != stampTime_)
+    {
+        stampTime_ = t;
+        stamp_ = boost::posix_time::to_simple_string (
+            boost::posix_time::from_time_t (t));
+    }
+
+    std::string line (stamp_);
+    format (line, entry.text, entry.level, entry.partition);
+    output += line;
+    output += '\n';
+}
+
+// Forking copies only the calling thread, so the writers are stopped
+// at a clean point and the child starts its own.
+
+void
+Logs::prepareFork()
+{
+    liveMutex.lock ();
+    for (auto const logs : liveLogs ())
+    {
+        logs->writeMutex_.lock ();
+        logs->drain ();
+        logs->ringsMutex_.lock ();
+        logs->wakeMutex_.lock ();
+    }
+}
+
+void
+Logs::parentFork()
+{
+    for (auto const logs : liveLogs ())
+    {
+        logs->wakeMutex_.unlock ();
+        logs->ringsMutex_.unlock ();
+        logs->writeMutex_.unlock ();
+    }
+    liveMutex.unlock ();
+}
+
+void
+Logs::childFork()
+{
+    for (auto const logs : liveLogs ())
+    {
+        logs->wakeMutex_.unlock ();
+        logs->ringsMutex_.unlock ();
+        logs->writeMutex_.unlock ();
+
+        // The parent's writer does not exist here, so its handle is
+        // abandoned rather than detached or destroyed
+        if (logs->writer_.joinable ())
+            new (&logs->writer_) std::thread (&Logs::run, logs);
+    }
+    liveMutex.unlock ();
+}
+
 LogSeverity
 Logs::fromSeverity (beast::Journal::Severity level)
 {
@@ -298,10 +676,7 @@ void
 Logs::format (std::string& output, std::string const& message,
     beast::Journal::Severity severity, std::string const& partition)
 {
-    output.reserve (message.size() + partition.size() + 100);
-
-    output = boost::posix_time::to_simple_string (
-        boost::posix_time::second_clock::universal_time ());
+    output.reserve (output.size() + message.size() + partition.size() + 100);
 
     output += " ";
     if (! partition.empty ())
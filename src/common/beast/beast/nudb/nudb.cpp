@@ -18,6 +18,8 @@
 //==============================================================================
 
 #include <beast/nudb/tests/callgrind_test.cpp>
+#include <beast/nudb/tests/fetch_test.cpp>
+#include <beast/nudb/tests/insert_test.cpp>
 #include <beast/nudb/tests/recover_test.cpp>
 #include <beast/nudb/tests/store_test.cpp>
 #include <beast/nudb/tests/varint_test.cpp>
@@ -37,6 +37,7 @@
 
 #if BEAST_NUDB_POSIX_FILE
 # include <fcntl.h>
+# include <sys/mman.h>
 # include <sys/types.h>
 # include <sys/uio.h>
 # include <sys/stat.h>
@@ -134,6 +135,17 @@ public:
     void
     trunc (std::size_t length);
 
+    // Map the first size bytes of the file for reading, hinting
+    // random access. The size may exceed the file; pages past the
+    // end become readable once the file grows to cover them.
+    // Returns nullptr if the file cannot be mapped.
+    void const*
+    map (std::size_t size) const;
+
+    static
+    void
+    unmap (void const* p, std::size_t size);
+
 private:
     static
     std::pair<int, int>
@@ -281,6 +293,25 @@ posix_file<_>::read (std::size_t offset,
     }
 }
 
+template <class _>
+void const*
+posix_file<_>::map (std::size_t size) const
+{
+    void* const p = ::mmap (nullptr, size,
+        PROT_READ, MAP_SHARED, fd_, 0);
+    if (p == MAP_FAILED)
+        return nullptr;
+    ::madvise (p, size, MADV_RANDOM);
+    return p;
+}
+
+template <class _>
+void
+posix_file<_>::unmap (void const* p, std::size_t size)
+{
+    ::munmap (const_cast<void*>(p), size);
+}
+
 template <class _>
 void
 posix_file<_>::write (std::size_t offset,
@@ -51,6 +51,7 @@
 #include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #if DOXYGEN
 #include <beast/nudb/README.md>
@@ -96,7 +97,13 @@ private:
         bulk_write_size     = 16 * 1024 * 1024,
 
         // Size of bulk reads during recover
-        recover_read_size   = 16 * 1024 * 1024
+        recover_read_size   = 16 * 1024 * 1024,
+
+        // Largest run of adjacent buckets read at once by fetch_batch
+        batch_read_size     = 1024 * 1024,
+
+        // Number of locks serializing insert(), chosen by key hash
+        insert_shards       = 16
     };
 
     using clock_type =
@@ -147,7 +154,9 @@ private:
     std::size_t buckets_;           // number of buckets
     std::size_t modulus_;           // hash modulus
 
-    std::mutex u_;                  // serializes insert()
+    // Serializes insert() for keys with the same hash shard, so
+    // inserts of different keys check for existence concurrently.
+    std::array<std::mutex, insert_shards> u_;
     detail::gentex g_;
     boost::shared_mutex m_;
     std::thread thread_;
@@ -160,9 +169,29 @@ private:
     std::size_t commit_limit_ = 1UL * 1024 * 1024 * 1024;
     std::condition_variable_any cond_limit_;
 
+    // Pools are numbered as they leave p1, so that flush() can wait
+    // for the pool holding its caller's inserts to be committed.
+    std::uint64_t p1_gen_ = 1;      // number p1 will take
+    std::uint64_t p0_gen_ = 0;      // number of the pool in p0
+    std::uint64_t done_gen_ = 0;    // last pool committed and synced
+    std::uint64_t flush_gen_ = 0;   // pool a flush() waits for
+    std::condition_variable_any cond_flush_;
+
     std::atomic<bool> epb_;         // `true` when ep_ set
     std::exception_ptr ep_;
 
+    // A read-only map of the key file. A map that is outgrown is
+    // replaced but not unmapped until close, so readers may use a
+    // bucket in place without holding a lock.
+    struct key_map
+    {
+        void const* p;
+        std::size_t size;
+    };
+    std::atomic<key_map const*> km_ {nullptr};
+    std::mutex km_m_;               // serializes remapping
+    std::vector<std::unique_ptr<key_map>> kms_;
+
 public:
     store() = default;
     store (store const&) = delete;
@@ -239,6 +268,18 @@ public:
         std::size_t arena_alloc_size,
         Args&&... args);
 
+    /** Read key file buckets through a memory map.
+
+        Fetches, and the duplicate check in insert, then use
+        buckets in place instead of copying each one with a
+        read. The map grows with the key file. Call after open.
+
+        @return `false` if the key file could not be mapped, in
+                which case buckets are read as before.
+    */
+    bool
+    map_key_file();
+
     /** Fetch a value.
 
         If key is found, Handler will be called as:
@@ -253,8 +294,25 @@ public:
     bool
     fetch (void const* key, Handler&& handler);
 
+    /** Fetch several values.
+
+        For each key that is found, Handler will be called as:
+            `(void)()(std::size_t i, void const* data, std::size_t size)`
+
+        where i is the index of the key. Keys are visited in bucket
+        order, and runs of adjacent buckets are read from the key file
+        with a single read, so the handler may be called in any order.
+        This may be called concurrently with itself and fetch().
+    */
+    template <class Handler>
+    void
+    fetch_batch (std::size_t n, void const* const* keys,
+        Handler&& handler);
+
     /** Insert a value.
 
+        This may be called concurrently with itself.
+
         Returns:
             `true` if the key was inserted,
             `false` if the key already existed
@@ -263,6 +321,19 @@ public:
     insert (void const* key, void const* data,
         std::size_t bytes);
 
+    /** Commit every value inserted so far.
+
+        Blocks until values inserted before the call are
+        written and synced to the data and key files, even
+        if the pool is below the size that starts a commit.
+        This may be called concurrently with insert().
+
+        Throws:
+            store_error
+    */
+    void
+    flush();
+
 private:
     void
     rethrow()
@@ -271,6 +342,21 @@ private:
             std::rethrow_exception(ep_);
     }
 
+    // Map at least the first end bytes of the key file.
+    // Requires km_m_ to be held.
+    bool
+    remap (std::size_t end);
+
+    // Returns a pointer to bucket n in the key
+    // file map, or nullptr if there is no map.
+    void*
+    mapped_bucket (std::size_t n);
+
+    // Returns bucket n of the key file, in place in the
+    // key file map if there is one, else read into buf.
+    detail::bucket
+    read_bucket (std::size_t n, detail::buffer& buf);
+
     // Fetch key in loaded bucket b or its spills.
     //
     template <class Handler>
@@ -406,6 +492,10 @@ store<Hasher, Codec, File>::close()
         open_ = false;
         cond_.notify_all();
         thread_.join();
+        km_.store(nullptr);
+        for (auto const& e : kms_)
+            File::unmap(e->p, e->size);
+        kms_.clear();
         rethrow();
         s_->lf.close();
         File::erase(s_->lp);
@@ -450,13 +540,125 @@ next:
     //  Audit for concurrency
     genlock <gentex> g (g_);
     m.unlock();
-    buffer buf (s_->kh.block_size);
-    //  Constructs with garbage here
-    bucket b (s_->kh.block_size,
-        buf.get());
-    b.read (s_->kf,
-        (n + 1) * b.block_size());
-    return fetch(h, key, b, handler);
+    buffer buf;
+    return fetch(h, key,
+        read_bucket(n, buf), handler);
+}
+
+template <class Hasher, class Codec, class File>
+template <class Handler>
+void
+store<Hasher, Codec, File>::fetch_batch (std::size_t n,
+    void const* const* keys, Handler&& handler)
+{
+    using namespace detail;
+    rethrow();
+    struct item
+    {
+        std::size_t n;  // bucket index
+        std::size_t h;  // hash
+        std::size_t i;  // key index
+    };
+    std::vector<item> v;
+    v.reserve(n);
+    shared_lock_type m (m_);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        auto const key = keys[i];
+        auto iter = s_->p1.find(key);
+        bool pooled = iter != s_->p1.end();
+        if (! pooled)
+        {
+            iter = s_->p0.find(key);
+            pooled = iter != s_->p0.end();
+        }
+        if (pooled)
+        {
+            buffer buf;
+            auto const result =
+                s_->codec.decompress(
+                    iter->first.data,
+                        iter->first.size, buf);
+            handler(i, result.first, result.second);
+            continue;
+        }
+        auto const h = hash<Hasher>(
+            key, s_->kh.key_size, s_->kh.salt);
+        auto const bn = bucket_index(
+            h, buckets_, modulus_);
+        auto const ci = s_->c1.find(bn);
+        if (ci != s_->c1.end())
+        {
+            fetch(h, key, ci->second,
+                [&](void const* data, std::size_t size)
+                {
+                    handler(i, data, size);
+                });
+            continue;
+        }
+        v.push_back({bn, h, i});
+    }
+    if (v.empty())
+        return;
+    //  Audit for concurrency
+    genlock <gentex> g (g_);
+    m.unlock();
+    std::sort(v.begin(), v.end(),
+        [](item const& lhs, item const& rhs)
+        {
+            return lhs.n < rhs.n;
+        });
+    auto const block_size = s_->kh.block_size;
+    auto const max_run = std::max<std::size_t>(
+        1, batch_read_size / block_size);
+    auto const visit =
+        [&](item const& e, bucket b)
+        {
+            auto const i = e.i;
+            fetch(e.h, keys[i], b,
+                [&](void const* data, std::size_t size)
+                {
+                    handler(i, data, size);
+                });
+        };
+    buffer buf;
+    for (auto first = v.begin(); first != v.end();)
+    {
+        // A mapped key file is read in place
+        if (km_.load())
+        {
+            visit(*first, read_bucket(first->n, buf));
+            ++first;
+            continue;
+        }
+        // Extend the run while the next bucket is the
+        // same or immediately follows the last one.
+        auto last = std::next(first);
+        while (last != v.end() &&
+            last->n - first->n < max_run &&
+                last->n - std::prev(last)->n <= 1)
+            ++last;
+        auto const count =
+            std::prev(last)->n - first->n + 1;
+        // Only the first bucket_size bytes of a block hold
+        // bucket data, the rest is zero padding, so the
+        // last block of a run is read without its padding.
+        auto const size = (count - 1) * block_size +
+            s_->kh.bucket_size;
+        buf.reserve(count * block_size);
+        s_->kf.read((first->n + 1) * block_size,
+            buf.get(), size);
+        for (auto it = first; it != last; ++it)
+        {
+            bucket b (block_size, buf.get() +
+                (it->n - first->n) * block_size);
+            if (b.size() > s_->kh.capacity)
+                throw store_corrupt_error(
+                    "bad bucket size");
+            visit(*it, b);
+        }
+        first = last;
+    }
 }
 
 template <class Hasher, class Codec, class File>
@@ -474,7 +676,8 @@ store<Hasher, Codec, File>::insert (
             "nudb: size too large");
     auto const h = hash<Hasher>(
         key, s_->kh.key_size, s_->kh.salt);
-    std::lock_guard<std::mutex> u (u_);
+    std::lock_guard<std::mutex> u (
+        u_[h % insert_shards]);
     {
         shared_lock_type m (m_);
         if (s_->p1.find(key) != s_->p1.end())
@@ -496,12 +699,8 @@ store<Hasher, Codec, File>::insert (
             //  Audit for concurrency
             genlock <gentex> g (g_);
             m.unlock();
-            buf.reserve(s_->kh.block_size);
-            bucket b (s_->kh.block_size,
-                buf.get());
-            b.read (s_->kf,
-                (n + 1) * s_->kh.block_size);
-            if (exists(h, key, nullptr, b))
+            if (exists(h, key, nullptr,
+                    read_bucket(n, buf)))
                 return false;
         }
     }
@@ -531,6 +730,84 @@ store<Hasher, Codec, File>::insert (
     return true;
 }
 
+template <class Hasher, class Codec, class File>
+bool
+store<Hasher, Codec, File>::map_key_file()
+{
+    std::lock_guard<std::mutex> lock (km_m_);
+    if (km_.load())
+        return true;
+    return remap(s_->kf.actual_size());
+}
+
+template <class Hasher, class Codec, class File>
+bool
+store<Hasher, Codec, File>::remap (std::size_t end)
+{
+    // Leave room to grow so remaps are rare
+    auto const size = 2 * std::max(
+        end, s_->kf.actual_size());
+    auto const p = s_->kf.map(size);
+    if (! p)
+        return false;
+    kms_.emplace_back(beast::make_unique<key_map>());
+    kms_.back()->p = p;
+    kms_.back()->size = size;
+    km_.store(kms_.back().get());
+    return true;
+}
+
+template <class Hasher, class Codec, class File>
+void*
+store<Hasher, Codec, File>::mapped_bucket (std::size_t n)
+{
+    auto km = km_.load();
+    if (! km)
+        return nullptr;
+    auto const offset =
+        (n + 1) * s_->kh.block_size;
+    auto const end =
+        offset + s_->kh.bucket_size;
+    if (end > km->size)
+    {
+        std::lock_guard<std::mutex> lock (km_m_);
+        km = km_.load();
+        if (end > km->size)
+        {
+            if (! remap(end))
+                return nullptr;
+            km = km_.load();
+        }
+    }
+    // Buckets are only ever read through the map
+    return const_cast<std::uint8_t*>(
+        reinterpret_cast<std::uint8_t const*>(
+            km->p)) + offset;
+}
+
+template <class Hasher, class Codec, class File>
+detail::bucket
+store<Hasher, Codec, File>::read_bucket (
+    std::size_t n, detail::buffer& buf)
+{
+    using namespace detail;
+    if (auto const p = mapped_bucket(n))
+    {
+        bucket b (s_->kh.block_size, p);
+        if (b.size() > s_->kh.capacity)
+            throw store_corrupt_error(
+                "bad bucket size");
+        return b;
+    }
+    buf.reserve(s_->kh.block_size);
+    //  Constructs with garbage here
+    bucket b (s_->kh.block_size,
+        buf.get());
+    b.read (s_->kf,
+        (n + 1) * s_->kh.block_size);
+    return b;
+}
+
 template <class Hasher, class Codec, class File>
 template <class Handler>
 bool
@@ -730,6 +1007,28 @@ store<Hasher, Codec, File>::load (
     return c1.insert (n, tmp)->second;
 }
 
+template <class Hasher, class Codec, class File>
+void
+store<Hasher, Codec, File>::flush()
+{
+    unique_lock_type m (m_);
+    // The pool holding the latest insert
+    auto const gen = s_->p1.empty() ?
+        p1_gen_ - 1 : p1_gen_;
+    if (done_gen_ < gen)
+    {
+        flush_gen_ = std::max(flush_gen_, gen);
+        cond_.notify_all();
+        cond_flush_.wait (m,
+            [&]()
+            {
+                return done_gen_ >= gen || epb_.load();
+            });
+    }
+    m.unlock();
+    rethrow();
+}
+
 //  Commit the memory pool to disk, then sync.
 //
 //  Preconditions:
@@ -749,16 +1048,23 @@ store<Hasher, Codec, File>::commit()
     cache c1;
     {
         unique_lock_type m (m_);
-        if (s_->p1.empty())
-            return;
-        if (s_->p1.data_size() >= commit_limit_)
-            cond_limit_.notify_all();
+        // p0 may already hold a pool staged
+        // by the tail of the previous commit.
+        if (s_->p0.empty())
+        {
+            if (s_->p1.empty())
+                return;
+            if (s_->p1.data_size() >= commit_limit_)
+                cond_limit_.notify_all();
+            swap (s_->p0, s_->p1);
+            p0_gen_ = p1_gen_++;
+        }
         swap (s_->c1, c1);
-        swap (s_->p0, s_->p1);
         s_->pool_thresh = std::max(
             s_->pool_thresh, s_->p0.data_size());
         m.unlock();
     }
+    auto const gen = p0_gen_;
     // Prepare rollback information
     // Log File Header
     log_file_header lh;
@@ -842,6 +1148,16 @@ store<Hasher, Codec, File>::commit()
         buckets_ = buckets;
         modulus_ = modulus;
         g_.start();
+        // Stage a full pool for the next commit now,
+        // so inserts keep filling a fresh pool while
+        // this commit writes its log and syncs.
+        if (s_->p1.data_size() >= s_->pool_thresh)
+        {
+            if (s_->p1.data_size() >= commit_limit_)
+                cond_limit_.notify_all();
+            swap (s_->p0, s_->p1);
+            p0_gen_ = p1_gen_++;
+        }
     }
     // Write clean buckets to log file
     //  Should the bulk_writer buffer size be tunable?
@@ -879,7 +1195,9 @@ store<Hasher, Codec, File>::commit()
     {
         unique_lock_type m (m_);
         s_->c1.clear();
+        done_gen_ = gen;
     }
+    cond_flush_.notify_all();
 }
 
 template <class Hasher, class Codec, class File>
@@ -891,10 +1209,12 @@ store<Hasher, Codec, File>::run()
         {
             return
                 ! open_ ||
+                ! s_->p0.empty() ||
                 s_->p1.data_size() >=
                     s_->pool_thresh ||
                 s_->p1.data_size() >=
-                    commit_limit_;
+                    commit_limit_ ||
+                flush_gen_ > done_gen_;
         };
     try
     {
@@ -927,12 +1247,16 @@ store<Hasher, Codec, File>::run()
                 }
             }
         }
+        // A staged pool and the one
+        // behind it may both remain.
+        commit();
         commit();
     }
     catch(...)
     {
         ep_ = std::current_exception(); // must come first
         epb_.store(true);
+        cond_flush_.notify_all();
     }
 }
 
@@ -155,6 +155,19 @@ public:
     void
     trunc (std::size_t length);
 
+    void const*
+    map (std::size_t size) const
+    {
+        return f_.map(size);
+    }
+
+    static
+    void
+    unmap (void const* p, std::size_t size)
+    {
+        File::unmap(p, size);
+    }
+
 private:
     bool
     fail();
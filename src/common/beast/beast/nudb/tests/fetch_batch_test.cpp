@@ -0,0 +1,150 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of Beast: https://github.com/vinniefalco/Beast
+    Copyright 2014, Vinnie Falco <vinnie.falco@gmail.com>
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <beast/nudb/tests/common.h>
+#include <beast/module/core/diagnostic/UnitTestUtilities.h>
+#include <beast/module/core/files/File.h>
+#include <beast/unit_test/suite.h>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace beast {
+namespace nudb {
+namespace test {
+
+// Checks that fetch_batch finds the same values as fetch, with
+// keys in the pool, in the key file read through pread and
+// through a memory map. Blocks are small so that runs of
+// adjacent buckets are merged into single reads.
+//
+class fetch_batch_test : public unit_test::suite
+{
+public:
+    // Fetches the first n inserted keys interleaved with as
+    // many missing ones, and a repeat of the first key.
+    void
+    check (test_api::store& db, std::size_t n,
+        std::string const& what)
+    {
+        Sequence seq;
+        std::vector<key_type> keys;
+        keys.reserve (2 * n + 1);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            keys.push_back (seq.key(i));
+            keys.push_back (seq.key(2 * n + i));
+        }
+        keys.push_back (seq.key(0));
+        std::vector<void const*> pointers;
+        pointers.reserve (keys.size());
+        for (auto const& key : keys)
+            pointers.push_back (&key);
+        std::vector<std::string> results (keys.size());
+        std::vector<int> calls (keys.size(), 0);
+        db.fetch_batch (pointers.size(), pointers.data(),
+            [&](std::size_t i, void const* data, std::size_t size)
+            {
+                ++calls[i];
+                results[i].assign (
+                    reinterpret_cast<char const*>(data), size);
+            });
+        bool ok = true;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto const v = seq[i];
+            auto const& r = results[2 * i];
+            ok = ok && calls[2 * i] == 1 &&
+                r.size() == v.size &&
+                    std::memcmp(r.data(), v.data, v.size) == 0;
+            ok = ok && calls[2 * i + 1] == 0;
+        }
+        expect (ok, what + ": wrong values");
+        expect (calls.back() == 1 &&
+            results.back() == results.front(),
+                what + ": repeated key");
+    }
+
+    void
+    do_test (std::size_t N, std::size_t block_size)
+    {
+        testcase (abort_on_fail);
+        std::string const path =
+            beast::UnitTestUtilities::TempDirectory(
+                "test_db").getFullPathName().toStdString();
+        auto const dp = path + ".dat";
+        auto const kp = path + ".key";
+        auto const lp = path + ".log";
+        try
+        {
+            expect (test_api::create (dp, kp, lp, appnum,
+                salt, sizeof(key_type), block_size,
+                    0.50f), "create");
+            {
+                test_api::store db;
+                expect (db.open(dp, kp, lp,
+                    arena_alloc_size), "open");
+                Sequence seq;
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                    auto const v = seq[i];
+                    expect (db.insert(
+                        &v.key, v.data, v.size), "insert");
+                }
+                check (db, N, "pool");
+                db.close();
+            }
+            {
+                test_api::store db;
+                expect (db.open(dp, kp, lp,
+                    arena_alloc_size), "reopen");
+                check (db, N, "pread");
+                expect (db.map_key_file(), "map");
+                check (db, N, "mmap");
+                db.close();
+            }
+        }
+        catch (std::exception const& e)
+        {
+            fail (e.what());
+        }
+        expect (test_api::file_type::erase(dp));
+        expect (test_api::file_type::erase(kp));
+        expect (! test_api::file_type::erase(lp));
+    }
+
+    void
+    run() override
+    {
+        enum
+        {
+            N =             5000
+            ,block_size =   256
+        };
+
+        do_test (N, block_size);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(fetch_batch,nudb,beast);
+
+} // test
+} // nudb
+} // beast
@@ -0,0 +1,246 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of Beast: https://github.com/vinniefalco/Beast
+    Copyright 2014, Vinnie Falco <vinnie.falco@gmail.com>
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <beast/nudb/tests/common.h>
+#include <beast/module/core/diagnostic/UnitTestUtilities.h>
+#include <beast/module/core/files/File.h>
+#include <beast/random/xor_shift_engine.h>
+#include <beast/unit_test/suite.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace beast {
+namespace nudb {
+namespace test {
+
+// Compares fetch latency with the key file read through
+// pread and through a memory map, on a warm page cache.
+class fetch_test : public unit_test::suite
+{
+public:
+    // Returns the mean fetch time in microseconds
+    double
+    do_fetches (std::size_t count, bool mapped,
+        path_type const& dp, path_type const& kp,
+            path_type const& lp)
+    {
+        test_api::store db;
+        if (! expect (db.open(dp, kp, lp,
+                arena_alloc_size), "open"))
+            return 0;
+        if (mapped)
+            expect (db.map_key_file(), "map");
+        Sequence seq;
+        Storage s;
+        beast::xor_shift_engine gen;
+        std::uniform_int_distribution<std::size_t> d (0, count - 1);
+        auto const start =
+            std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            // Fetch an inserted key, then a missing one
+            auto const v = seq[d(gen)];
+            expect (db.fetch (&v.key, s), "fetch");
+            auto const k = seq.key(count + i);
+            expect (! db.fetch (&k, s), "fetch missing");
+        }
+        auto const elapsed = std::chrono::duration_cast<
+            std::chrono::duration<double, std::micro>>(
+                std::chrono::steady_clock::now() - start);
+        db.close();
+        return elapsed.count() / (2 * count);
+    }
+
+    void
+    do_test (std::size_t count,
+        path_type const& path)
+    {
+        auto const dp = path + ".dat";
+        auto const kp = path + ".key";
+        auto const lp = path + ".log";
+        test_api::create (dp, kp, lp,
+            appnum,
+            salt,
+            sizeof(nudb::test::key_type),
+            nudb::block_size(path),
+            0.50);
+        {
+            test_api::store db;
+            if (! expect (db.open(dp, kp, lp,
+                    arena_alloc_size), "open"))
+                return;
+            Sequence seq;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                auto const v = seq[i];
+                expect (db.insert(&v.key, v.data, v.size),
+                    "insert");
+            }
+            db.close();
+        }
+        // Once to warm the page cache, then measured
+        do_fetches (count, false, dp, kp, lp);
+        auto const pread = do_fetches (count, false, dp, kp, lp);
+        auto const mapped = do_fetches (count, true, dp, kp, lp);
+        log << std::fixed << std::setprecision(2) <<
+            "pread: " << pread << "us, mmap: " << mapped << "us";
+        nudb::native_file::erase (dp);
+        nudb::native_file::erase (kp);
+        nudb::native_file::erase (lp);
+    }
+
+    void
+    run() override
+    {
+        enum
+        {
+            N = 200000
+        };
+
+        testcase (abort_on_fail);
+        path_type const path =
+            beast::UnitTestUtilities::TempDirectory(
+                "nudb").getFullPathName().toStdString();
+        do_test (N, path);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(fetch,nudb,beast);
+
+//------------------------------------------------------------------------------
+
+// Maps a nearly empty key file, then grows it well past the
+// map with inserts and repeated commits while reader threads
+// fetch keys already inserted. Every fetch must find the
+// right value while the map is replaced underneath it.
+class fetch_grow_test : public unit_test::suite
+{
+public:
+    void
+    read (test_api::store& db,
+        std::atomic<std::size_t> const& inserted,
+            std::atomic<bool> const& done,
+                std::size_t seed, std::size_t& bad)
+    {
+        Sequence seq;
+        Storage s;
+        beast::xor_shift_engine gen (seed);
+        while (! done.load())
+        {
+            auto const n = inserted.load();
+            if (n == 0)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            std::uniform_int_distribution<
+                std::size_t> d (0, n - 1);
+            auto const v = seq[d(gen)];
+            if (! db.fetch (&v.key, s) ||
+                s.size() != v.size || std::memcmp(
+                    s.get(), v.data, v.size) != 0)
+                ++bad;
+        }
+    }
+
+    void
+    do_test (std::size_t count, std::size_t readers,
+        path_type const& path)
+    {
+        auto const dp = path + ".dat";
+        auto const kp = path + ".key";
+        auto const lp = path + ".log";
+        test_api::create (dp, kp, lp,
+            appnum,
+            salt,
+            sizeof(nudb::test::key_type),
+            256,
+            0.50);
+        test_api::store db;
+        if (! expect (db.open(dp, kp, lp,
+                arena_alloc_size), "open"))
+            return;
+        expect (db.map_key_file(), "map");
+        std::atomic<std::size_t> inserted (0);
+        std::atomic<bool> done (false);
+        std::vector<std::size_t> bad (readers, 0);
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i < readers; ++i)
+            threads.emplace_back ([&, i]()
+            {
+                read (db, inserted, done, i + 1, bad[i]);
+            });
+        Sequence seq;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto const v = seq[i];
+            expect (db.insert(&v.key, v.data, v.size),
+                "insert");
+            inserted.store(i + 1);
+            // Commit often so buckets move from the
+            // cache to the key file while being read
+            if ((i + 1) % 1000 == 0)
+                db.flush();
+        }
+        db.flush();
+        done.store(true);
+        for (auto& t : threads)
+            t.join();
+        std::size_t total = 0;
+        for (auto n : bad)
+            total += n;
+        expect (total == 0, "bad fetches");
+        db.close();
+        auto const stats = verify<test_api::hash_type>(
+            dp, kp, 1 * 1024 * 1024);
+        expect (stats.key_count == count, "key count");
+        // The first map covered twice the header block
+        expect (stats.key_file_size > 16 * 256, "key file grew");
+        nudb::native_file::erase (dp);
+        nudb::native_file::erase (kp);
+        nudb::native_file::erase (lp);
+    }
+
+    void
+    run() override
+    {
+        enum
+        {
+            N = 20000,
+            readers = 4
+        };
+
+        testcase (abort_on_fail);
+        path_type const path =
+            beast::UnitTestUtilities::TempDirectory(
+                "nudb").getFullPathName().toStdString();
+        do_test (N, readers, path);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(fetch_grow,nudb,beast);
+
+} // test
+} // nudb
+} // beast
@@ -0,0 +1,132 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of Beast: https://github.com/vinniefalco/Beast
+    Copyright 2014, Vinnie Falco <vinnie.falco@gmail.com>
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <beast/nudb/tests/common.h>
+#include <beast/module/core/diagnostic/UnitTestUtilities.h>
+#include <beast/module/core/files/File.h>
+#include <beast/unit_test/suite.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+namespace beast {
+namespace nudb {
+namespace test {
+
+// Measures insert throughput with several threads inserting
+// distinct keys at once, then checks every key can be fetched.
+class insert_test : public unit_test::suite
+{
+public:
+    // Returns inserts per second
+    double
+    do_test (std::size_t count, std::size_t threads,
+        path_type const& path)
+    {
+        auto const dp = path + ".dat";
+        auto const kp = path + ".key";
+        auto const lp = path + ".log";
+        test_api::create (dp, kp, lp,
+            appnum,
+            salt,
+            sizeof(nudb::test::key_type),
+            nudb::block_size(path),
+            0.50);
+        test_api::store db;
+        if (! expect (db.open(dp, kp, lp,
+                arena_alloc_size), "open"))
+            return 0;
+        std::atomic<std::size_t> failed (0);
+        auto const start =
+            std::chrono::steady_clock::now();
+        {
+            std::vector<std::thread> workers;
+            for (std::size_t t = 0; t < threads; ++t)
+                workers.emplace_back(
+                    [&, t]()
+                    {
+                        Sequence seq;
+                        for (std::size_t i = t;
+                                i < count; i += threads)
+                        {
+                            auto const v = seq[i];
+                            if (! db.insert(
+                                    &v.key, v.data, v.size))
+                                ++failed;
+                        }
+                    });
+            for (auto& e : workers)
+                e.join();
+        }
+        db.close();
+        auto const elapsed = std::chrono::duration_cast<
+            std::chrono::duration<double>>(
+                std::chrono::steady_clock::now() - start);
+        expect (failed == 0, "insert");
+        if (expect (db.open(dp, kp, lp,
+                arena_alloc_size), "reopen"))
+        {
+            Sequence seq;
+            Storage s;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                auto const v = seq[i];
+                if (! expect (db.fetch (&v.key, s), "fetch"))
+                    break;
+                expect (s.size() == v.size &&
+                    std::memcmp(s.get(), v.data, v.size) == 0,
+                        "data");
+            }
+            db.close();
+        }
+        nudb::native_file::erase (dp);
+        nudb::native_file::erase (kp);
+        nudb::native_file::erase (lp);
+        return count / elapsed.count();
+    }
+
+    void
+    run() override
+    {
+        enum
+        {
+            N = 200000
+        };
+
+        testcase (abort_on_fail);
+        path_type const path =
+            beast::UnitTestUtilities::TempDirectory(
+                "nudb").getFullPathName().toStdString();
+        for (std::size_t threads : { 1, 2, 4, 8 })
+        {
+            auto const rate = do_test (N, threads, path);
+            log << std::setw(2) << threads << " threads: " <<
+                num(static_cast<std::size_t>(rate)) << " inserts/s";
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(insert,nudb,beast);
+
+} // test
+} // nudb
+} // beast
@@ -69,6 +69,15 @@ public:
                 expect (db.insert(
                     &v.key, v.data, v.size), "insert 1");
             }
+            // flush
+            {
+                db.flush();
+                // Everything inserted is now in the files
+                auto const stats = verify<test_api::hash_type>(
+                    dp, kp, 1 * 1024 * 1024);
+                expect (stats.key_count == N, "flush keys");
+                expect (stats.value_count == N, "flush values");
+            }
             // fetch
             for (std::size_t i = 0; i < N; ++i)
             {
@@ -196,6 +196,19 @@ public:
     void
     trunc (std::size_t length);
 
+    // Memory mapping is not supported, reads use ReadFile
+    void const*
+    map (std::size_t) const
+    {
+        return nullptr;
+    }
+
+    static
+    void
+    unmap (void const*, std::size_t)
+    {
+    }
+
 private:
     static
     std::pair<DWORD, DWORD>
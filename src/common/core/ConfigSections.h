@@ -30,6 +30,7 @@ struct ConfigSection
     static std::string nodeDatabase ()       { return "node_db"; }
     static std::string tempNodeDatabase ()   { return "temp_db"; }
     static std::string importNodeDatabase () { return "import_db"; }
+    static std::string benchmarkNodeDatabase () { return "benchmark_db"; }
 };
 
 //  TODO Rename and replace these macros with variables.
@@ -68,6 +69,7 @@ struct ConfigSection
 #define SECTION_VALIDATORS_FILE         "validators_file"
 #define SECTION_VALIDATION_QUORUM       "validation_quorum"
 #define SECTION_VALIDATION_SEED         "validation_seed"
+#define SECTION_VALIDATION_ARCHIVE      "validation_archive"
 #define SECTION_WEBSOCKET_PING_FREQ     "websocket_ping_frequency"
 #define SECTION_VALIDATORS              "validators"
 #define SECTION_VALIDATORS_SITE         "validators_site"
@@ -38,6 +38,7 @@ enum JobType
     // insert a job at a specific priority, simply add it at the right location.
 
     jtPACK,          // Make a fetch pack for a peer
+    jtWALK,          // Help walk a map in parallel
     jtPUBOLDLEDGER,  // An old ledger has been accepted
     jtVALIDATION_ut, // A validation from an untrusted source
     jtTRANSACTION_l, // A local transaction
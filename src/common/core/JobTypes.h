@@ -42,6 +42,10 @@ public:
         add (jtPACK,          "makeFetchPack",
             1,        true,   false, 0,     0);
 
+        // Help walk a map in parallel
+        add (jtWALK,          "walkMap",
+            maxLimit, true,   false, 0,     0);
+
         // An old ledger has been accepted
         add (jtPUBOLDLEDGER,  "publishAcqLedger",
             2,        true,   false, 10000, 15000);
@@ -0,0 +1,46 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef SKYWELL_CORE_PARALLELFOR_H_INCLUDED
+#define SKYWELL_CORE_PARALLELFOR_H_INCLUDED
+
+#include <common/core/JobQueue.h>
+#include <functional>
+#include <string>
+
+namespace skywell {
+
+/** Call f (0) ... f (count - 1) using the job queue.
+
+    Up to maxJobs - 1 jobs of the given type are added to help, and the
+    calling thread works through indexes alongside them. The call returns
+    once every index has been processed. A helper which starts late finds
+    nothing left to do, so this never waits for a job to be dispatched and
+    is safe to call from a job. The first exception thrown by f is
+    rethrown to the caller once all indexes are done.
+*/
+void
+parallelFor (JobQueue& jobQueue, JobType type, std::string const& name,
+    std::size_t count, std::size_t maxJobs,
+        std::function <void (std::size_t)> const& f);
+
+} // skywell
+
+#endif
@@ -0,0 +1,106 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <common/core/ParallelFor.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+namespace skywell {
+
+namespace {
+
+// Shared with the helper jobs, which may outlive the call
+struct ParallelState
+{
+    ParallelState (std::size_t count_,
+            std::function <void (std::size_t)> const& f_)
+        : f (f_)
+        , count (count_)
+        , next (0)
+        , done (0)
+    {
+    }
+
+    // Only called for claimed indexes, which the caller waits for
+    std::function <void (std::size_t)> const& f;
+    std::size_t const count;
+    std::atomic <std::size_t> next;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::size_t done;
+    std::exception_ptr error;
+
+    void work ()
+    {
+        std::size_t i;
+        while ((i = next++) < count)
+        {
+            std::exception_ptr e;
+            try
+            {
+                f (i);
+            }
+            catch (...)
+            {
+                e = std::current_exception ();
+            }
+
+            std::lock_guard <std::mutex> lock (mutex);
+            if (e && !error)
+                error = e;
+            if (++done == count)
+                cond.notify_all ();
+        }
+    }
+};
+
+} // namespace
+
+void
+parallelFor (JobQueue& jobQueue, JobType type, std::string const& name,
+    std::size_t count, std::size_t maxJobs,
+        std::function <void (std::size_t)> const& f)
+{
+    if (count == 0)
+        return;
+
+    auto const state = std::make_shared <ParallelState> (count, f);
+
+    std::size_t const helpers =
+        std::min (count, std::max <std::size_t> (maxJobs, 1)) - 1;
+    for (std::size_t i = 0; i < helpers; ++i)
+        jobQueue.addJob (type, name, [state](Job&) { state->work (); });
+
+    state->work ();
+
+    std::unique_lock <std::mutex> lock (state->mutex);
+    state->cond.wait (lock, [&]{ return state->done == state->count; });
+
+    if (state->error)
+        std::rethrow_exception (state->error);
+}
+
+} // skywell
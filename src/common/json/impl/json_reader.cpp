@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <BeastConfig.h>
+#include <algorithm>
 #include <string>
 #include <cctype>
 #include <common/json/json_reader.h>
@@ -79,6 +80,7 @@ bool
 Reader::parse ( std::string const& document,
                 Value& root)
 {
+    // Keep a copy so that error locations outlive a temporary document
     document_ = document;
     const char* begin = document_.c_str ();
     const char* end = begin + document_.length ();
@@ -95,11 +97,12 @@ Reader::parse ( std::istream& sin,
     // Those would allow streamed input from a file, if parse() were a
     // template function.
 
-    // Since std::string is reference-counted, this at least does not
-    // create an extra copy.
-    std::string doc;
-    std::getline (sin, doc, (char)EOF);
-    return parse ( doc, root );
+    // Read straight into the kept copy rather than copying it again
+    document_.clear ();
+    std::getline (sin, document_, (char)EOF);
+    const char* begin = document_.c_str ();
+    const char* end = begin + document_.length ();
+    return parse ( begin, end, root );
 }
 
 bool
@@ -448,7 +451,7 @@ Reader::readObject ( Token& tokenStart )
         if ( tokenName.type_ != tokenString )
             break;
 
-        name = "";
+        name.clear ();
 
         if ( !decodeString ( tokenName, name ) )
             return recoverFromError ( tokenObjectEnd );
@@ -462,11 +465,14 @@ Reader::readObject ( Token& tokenStart )
                                         tokenObjectEnd );
         }
 
-        // Reject duplicate names
-        if (currentValue ().isMember (name))
+        // Insert with a single lookup, rejecting duplicate names
+        Value& object = currentValue ();
+        Value::UInt const size = object.size ();
+        Value& value = object[ name ];
+
+        if (object.size () == size)
             return addError ( "Key '" + name + "' appears twice.", tokenName );
 
-        Value& value = currentValue ()[ name ];
         nodes_.push ( &value );
         bool ok = readValue ();
         nodes_.pop ();
@@ -671,6 +677,13 @@ Reader::decodeDouble( Token &token )
 bool
 Reader::decodeString ( Token& token )
 {
+    // Most strings have no escapes and can be copied in one step
+    if ( std::find ( token.start_ + 1, token.end_ - 1, '\\' ) == token.end_ - 1 )
+    {
+        currentValue () = Value ( token.start_ + 1, token.end_ - 1 );
+        return true;
+    }
+
     std::string decoded;
 
     if ( !decodeString ( token, decoded ) )
@@ -690,6 +703,14 @@ Reader::decodeString ( Token& token, std::string& decoded )
 
     while ( current != end )
     {
+        // Copy the run up to the next escape in one step
+        Location run = std::find ( current, end, '\\' );
+        decoded.append ( current, run );
+        current = run;
+
+        if ( current == end )
+            break;
+
         Char c = *current++;
 
         if ( c == '"' )
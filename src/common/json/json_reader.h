@@ -45,6 +45,8 @@ public:
 
     /** \brief Read a Value from a <a HREF="http://www.json.org">JSON</a> document.
      * \param document UTF-8 encoded string containing the document to read.
+     *                 The reader keeps its own copy, so the string may be a
+     *                 temporary.
      * \param root [out] Contains the root value of the document if it was
      *             successfully parsed.
      * \return \c true if the document was successfully parsed, \c false if an error occurred.
@@ -52,7 +54,10 @@ public:
     bool parse ( std::string const& document, Value& root);
 
     /** \brief Read a Value from a <a HREF="http://www.json.org">JSON</a> document.
-     * \param document UTF-8 encoded string containing the document to read.
+     * \param beginDoc Start of the UTF-8 encoded document to read.
+     * \param endDoc One past the end of the document. The document is not
+     *               copied, and must outlive any call to
+     *               getFormatedErrorMessages() for this parse.
      * \param root [out] Contains the root value of the document if it was
      *             successfully parsed.
      * \return \c true if the document was successfully parsed, \c false if an error occurred.
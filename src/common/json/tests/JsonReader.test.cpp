@@ -0,0 +1,88 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <common/json/json_reader.h>
+#include <common/json/json_value.h>
+#include <beast/unit_test/suite.h>
+#include <string>
+
+namespace skywell {
+
+class JsonReader_test : public beast::unit_test::suite
+{
+public:
+    void testTemporaryDocument ()
+    {
+        testcase ("temporary document");
+
+        Json::Reader reader;
+        Json::Value root;
+
+        // The document is destroyed before the errors are formatted
+        expect (! reader.parse (std::string ("{\"a\" : 1,, }"), root));
+        std::string const errors = reader.getFormatedErrorMessages ();
+        expect (errors.find ("Line 1, Column 10") != std::string::npos,
+            errors);
+    }
+
+    void testStrings ()
+    {
+        testcase ("strings");
+
+        Json::Reader reader;
+        Json::Value root;
+
+        expect (reader.parse (std::string (
+            "{\"plain\" : \"abc\", \"escaped\" : \"a\\\"b\\\\c\\nd\\u0041\"}"),
+                root));
+        expect (root["plain"].asString () == "abc");
+        expect (root["escaped"].asString () == "a\"b\\c\ndA");
+    }
+
+    void testDuplicateKeys ()
+    {
+        testcase ("duplicate keys");
+
+        Json::Reader reader;
+        Json::Value root;
+
+        expect (! reader.parse (std::string (
+            "{\"a\" : 1, \"b\" : 2, \"a\" : 3}"), root));
+        expect (reader.getFormatedErrorMessages ().find (
+            "Key 'a' appears twice.") != std::string::npos);
+
+        expect (reader.parse (std::string (
+            "{\"a\" : {\"a\" : 1}, \"b\" : [{\"a\" : 2}]}"), root));
+        expect (root["a"]["a"].asInt () == 1);
+        expect (root["b"][0u]["a"].asInt () == 2);
+    }
+
+    void run ()
+    {
+        testTemporaryDocument ();
+        testStrings ();
+        testDuplicateKeys ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(JsonReader,json,skywell);
+
+} // skywell
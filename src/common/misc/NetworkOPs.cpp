@@ -22,8 +22,10 @@
 #include <beast/module/core/system/SystemStats.h>
 #include <boost/optional.hpp>
 #include <tuple>
+#include <consensus/ConsensusTimings.h>
 #include <consensus/LedgerConsensus.h>
 #include <data/database/DatabaseCon.h>
+#include <data/nodestore/Database.h>
 #include <main/Application.h>
 #include <ledger/AcceptedLedger.h>
 #include <ledger/InboundLedger.h>
@@ -38,7 +40,9 @@
 #include <common/misc/IHashRouter.h>
 #include <common/misc/NetworkOPs.h>
 #include <common/misc/Validations.h>
+#include <common/misc/impl/AccountSubscriptions.h>
 #include <common/misc/impl/AccountTxPaging.h>
+#include <common/misc/impl/BinaryStream.h>
 #include <common/misc/FeeVote.h>
 #include <common/base/Log.h>
 #include <common/base/Time.h>
@@ -66,6 +70,53 @@
 
 namespace skywell {
 
+/** A stream message which is rendered in each format on first use.
+    Nothing is built for a format that no subscriber asked for.
+*/
+class Publication
+{
+public:
+    Publication (std::function <Json::Value ()> makeJson,
+            std::function <std::string ()> makeBinary)
+        : makeJson_ (std::move (makeJson))
+        , makeBinary_ (std::move (makeBinary))
+    {
+    }
+
+    Publication (Publication const&) = delete;
+    Publication& operator= (Publication const&) = delete;
+
+    Json::Value const& json ()
+    {
+        if (! json_)
+            json_.emplace (makeJson_ ());
+        return *json_;
+    }
+
+    void send (InfoSub::ref sub)
+    {
+        if (sub->isBinary ())
+        {
+            if (! binary_)
+                binary_.emplace (makeBinary_ ());
+            sub->sendBinary (*binary_);
+        }
+        else
+        {
+            if (! text_)
+                text_.emplace (to_string (json ()));
+            sub->send (*json_, *text_, true);
+        }
+    }
+
+private:
+    std::function <Json::Value ()> makeJson_;
+    std::function <std::string ()> makeBinary_;
+    boost::optional <Json::Value> json_;
+    boost::optional <std::string> text_;
+    boost::optional <std::string> binary_;
+};
+
 class NetworkOPsImp
     : public NetworkOPs
     , public beast::DeadlineTimer::Listener
@@ -525,8 +576,8 @@ private:
     void pubValidatedTransaction (
         Ledger::ref alAccepted, const AcceptedLedgerTx& alTransaction);
     void pubAccountTransaction (
-        Ledger::ref lpCurrent, const AcceptedLedgerTx& alTransaction,
-        bool isAccepted);
+        const AcceptedLedgerTx& alTransaction, bool isAccepted,
+        Publication& publication);
 
     void pubServer ();
 
@@ -535,7 +586,6 @@ private:
 private:
     clock_type& m_clock;
 
-    typedef hash_map <Account, SubMapType> SubInfoMapType;
     typedef hash_map<std::string, InfoSub::pointer> subRpcMapType;
 
     // XXX Split into more locks.
@@ -585,8 +635,9 @@ private:
     // Recent positions taken
     std::map<uint256, std::pair<int, std::shared_ptr<SHAMap>>> mRecentPositions;
 
-    SubInfoMapType mSubAccount;
-    SubInfoMapType mSubRTAccount;
+    // Not guarded by mSubLock
+    AccountSubscriptions mSubAccount;
+    AccountSubscriptions mSubRTAccount;
 
     subRpcMapType mRpcSubMap;
 
@@ -2138,8 +2189,31 @@ Json::Value NetworkOPsImp::getServerInfo (bool human, bool admin)
     //      info[jss::consensus] = mConsensus->getJson();
 
     if (admin)
+    {
         info[jss::load] = m_job_queue.getJson ();
 
+        NodeStore::TierCounts const tiers =
+            getApp().getNodeStore ().getTierCounts ();
+
+        if (tiers.enabled)
+        {
+            std::uint32_t const fetches = tiers.currentHits +
+                tiers.previousHits + tiers.coldHits + tiers.misses;
+
+            Json::Value t (Json::objectValue);
+            t["current_hits"] = Json::UInt (tiers.currentHits);
+            t["previous_hits"] = Json::UInt (tiers.previousHits);
+            t["cold_hits"] = Json::UInt (tiers.coldHits);
+            t["misses"] = Json::UInt (tiers.misses);
+            t["rotations"] = Json::UInt (tiers.rotations);
+            t["drops"] = Json::UInt (tiers.drops);
+            if (fetches != 0)
+                t["fast_hit_rate"] = static_cast<double> (
+                    tiers.currentHits + tiers.previousHits) / fetches;
+            info["node_store_tiers"] = t;
+        }
+    }
+
     if (!human)
     {
         info[jss::load_base] = getApp().getFeeTrack ().getLoadBase ();
@@ -2284,7 +2358,16 @@ Json::Value NetworkOPsImp::pubBootstrapAccountInfo (
 void NetworkOPsImp::pubProposedTransaction (
     Ledger::ref lpCurrent, STTx::ref stTxn, TER terResult)
 {
-    Json::Value jvObj   = transJson (*stTxn, terResult, false, lpCurrent);
+    Publication pub (
+        [&]
+        {
+            return transJson (*stTxn, terResult, false, lpCurrent);
+        },
+        [&]
+        {
+            return BinaryStream::makeTransaction (
+                *stTxn, terResult, false, lpCurrent, nullptr);
+        });
 
     {
         ScopedLockType sl (mSubLock);
@@ -2296,7 +2379,7 @@ void NetworkOPsImp::pubProposedTransaction (
 
             if (p)
             {
-                p->send (jvObj, true);
+                pub.send (p);
                 ++it;
             }
             else
@@ -2306,8 +2389,9 @@ void NetworkOPsImp::pubProposedTransaction (
         }
     }
     AcceptedLedgerTx alt (lpCurrent, stTxn, terResult);
-    m_journal.trace << "pubProposed: " << alt.getJson ();
-    pubAccountTransaction (lpCurrent, alt, false);
+    if (m_journal.trace)
+        m_journal.trace << "pubProposed: " << alt.getJson ();
+    pubAccountTransaction (alt, false, pub);
 }
 
 void NetworkOPsImp::pubLedger (Ledger::ref accepted)
@@ -2315,6 +2399,8 @@ void NetworkOPsImp::pubLedger (Ledger::ref accepted)
     // Ledgers are published only when they acquire sufficient validations
     // Holes are filled across connection loss or other catastrophe
 
+    auto const start = std::chrono::steady_clock::now ();
+
     auto alpAccepted = AcceptedLedger::makeAcceptedLedger (accepted);
     Ledger::ref lpAccepted = alpAccepted->getLedger ();
 
@@ -2323,27 +2409,41 @@ void NetworkOPsImp::pubLedger (Ledger::ref accepted)
 
         if (!mSubLedger.empty ())
         {
-            Json::Value jvObj (Json::objectValue);
+            Publication pub (
+                [&]
+                {
+                    Json::Value jvObj (Json::objectValue);
 
-            jvObj[jss::type] = "ledgerClosed";
-            jvObj[jss::ledger_index] = lpAccepted->getLedgerSeq ();
-            jvObj[jss::ledger_hash] = to_string (lpAccepted->getHash ());
-            jvObj[jss::ledger_time]
-                    = Json::Value::UInt (lpAccepted->getCloseTimeNC ());
+                    jvObj[jss::type] = "ledgerClosed";
+                    jvObj[jss::ledger_index] = lpAccepted->getLedgerSeq ();
+                    jvObj[jss::ledger_hash] = to_string (lpAccepted->getHash ());
+                    jvObj[jss::ledger_time]
+                            = Json::Value::UInt (lpAccepted->getCloseTimeNC ());
 
-            jvObj[jss::fee_ref]
-                    = Json::UInt (lpAccepted->getReferenceFeeUnits ());
-            jvObj[jss::fee_base] = Json::UInt (lpAccepted->getBaseFee ());
-            jvObj[jss::reserve_base] = Json::UInt (lpAccepted->getReserve (0));
-            jvObj[jss::reserve_inc] = Json::UInt (lpAccepted->getReserveInc ());
+                    jvObj[jss::fee_ref]
+                            = Json::UInt (lpAccepted->getReferenceFeeUnits ());
+                    jvObj[jss::fee_base] = Json::UInt (lpAccepted->getBaseFee ());
+                    jvObj[jss::reserve_base] = Json::UInt (lpAccepted->getReserve (0));
+                    jvObj[jss::reserve_inc] = Json::UInt (lpAccepted->getReserveInc ());
 
-            jvObj[jss::txn_count] = Json::UInt (alpAccepted->getTxnCount ());
+                    jvObj[jss::txn_count] = Json::UInt (alpAccepted->getTxnCount ());
 
-            if (mMode >= omSYNCING)
-            {
-                jvObj[jss::validated_ledgers]
-                        = getApp().getLedgerMaster ().getCompleteLedgers ();
-            }
+                    if (mMode >= omSYNCING)
+                    {
+                        jvObj[jss::validated_ledgers]
+                                = getApp().getLedgerMaster ().getCompleteLedgers ();
+                    }
+
+                    return jvObj;
+                },
+                [&]
+                {
+                    return BinaryStream::makeLedgerClosed (
+                        lpAccepted, alpAccepted->getTxnCount (),
+                        mMode >= omSYNCING
+                            ? getApp().getLedgerMaster ().getCompleteLedgers ()
+                            : std::string ());
+                });
 
             auto it = mSubLedger.begin ();
             while (it != mSubLedger.end ())
@@ -2351,7 +2451,7 @@ void NetworkOPsImp::pubLedger (Ledger::ref accepted)
                 InfoSub::pointer p = it->second.lock ();
                 if (p)
                 {
-                    p->send (jvObj, true);
+                    pub.send (p);
                     ++it;
                 }
                 else
@@ -2363,9 +2463,14 @@ void NetworkOPsImp::pubLedger (Ledger::ref accepted)
     // Don't lock since pubAcceptedTransaction is locking.
     for (auto const& vt : alpAccepted->getMap ())
     {
-        m_journal.trace << "pubAccepted: " << vt.second->getJson ();
+        if (m_journal.trace)
+            m_journal.trace << "pubAccepted: " << vt.second->getJson ();
         pubValidatedTransaction (lpAccepted, *vt.second);
     }
+
+    getApp().getConsensusTimings ().onPublished (lpAccepted->getLedgerSeq (),
+        std::chrono::duration_cast <std::chrono::microseconds> (
+            std::chrono::steady_clock::now () - start));
 }
 
 void NetworkOPsImp::reportFeeChange ()
@@ -2436,11 +2541,20 @@ Json::Value NetworkOPsImp::transJson(
 void NetworkOPsImp::pubValidatedTransaction (
     Ledger::ref alAccepted, const AcceptedLedgerTx& alTx)
 {
-    Json::Value jvObj = transJson (
-        *alTx.getTxn (), alTx.getResult (), true, alAccepted);
-    jvObj[jss::meta] = alTx.getMeta ()->getJson (0);
-
-    std::string sObj = to_string (jvObj);
+    Publication pub (
+        [&]
+        {
+            Json::Value jvObj = transJson (
+                *alTx.getTxn (), alTx.getResult (), true, alAccepted);
+            jvObj[jss::meta] = alTx.getMeta ()->getJson (0);
+            return jvObj;
+        },
+        [&]
+        {
+            return BinaryStream::makeTransaction (
+                *alTx.getTxn (), alTx.getResult (), true, alAccepted,
+                    alTx.getRawMeta ().empty () ? nullptr : &alTx.getRawMeta ());
+        });
 
     {
         ScopedLockType sl (mSubLock);
@@ -2452,7 +2566,7 @@ void NetworkOPsImp::pubValidatedTransaction (
 
             if (p)
             {
-                p->send (jvObj, sObj, true);
+                pub.send (p);
                 ++it;
             }
             else
@@ -2467,98 +2581,47 @@ void NetworkOPsImp::pubValidatedTransaction (
 
             if (p)
             {
-                p->send (jvObj, sObj, true);
+                pub.send (p);
                 ++it;
             }
             else
                 it = mSubRTTransactions.erase (it);
         }
     }
-    getApp().getOrderBookDB ().processTxn (alAccepted, alTx, jvObj);
-    pubAccountTransaction (alAccepted, alTx, true);
+    getApp().getOrderBookDB ().processTxn (alAccepted, alTx,
+        [&pub] () -> Json::Value const& { return pub.json (); });
+    pubAccountTransaction (alTx, true, pub);
 }
 
 void NetworkOPsImp::pubAccountTransaction (
-    Ledger::ref lpCurrent, const AcceptedLedgerTx& alTx, bool bAccepted)
+    const AcceptedLedgerTx& alTx, bool bAccepted, Publication& publication)
 {
     hash_set<InfoSub::pointer>  notify;
     int                             iProposed   = 0;
     int                             iAccepted   = 0;
 
-    {
-        ScopedLockType sl (mSubLock);
-
-        if (!bAccepted && mSubRTAccount.empty ()) return;
+    if (!bAccepted && mSubRTAccount.empty ()) return;
 
-        if (!mSubAccount.empty () || (!mSubRTAccount.empty ()) )
+    if (!mSubAccount.empty () || (!mSubRTAccount.empty ()) )
+    {
+        for (auto const& affectedAccount: alTx.getAffected ())
         {
-            for (auto const& affectedAccount: alTx.getAffected ())
-            {
-                auto simiIt
-                        = mSubRTAccount.find (affectedAccount.getAccountID ());
-                if (simiIt != mSubRTAccount.end ())
-                {
-                    auto it = simiIt->second.begin ();
-
-                    while (it != simiIt->second.end ())
-                    {
-                        InfoSub::pointer p = it->second.lock ();
-
-                        if (p)
-                        {
-                            notify.insert (p);
-                            ++it;
-                            ++iProposed;
-                        }
-                        else
-                            it = simiIt->second.erase (it);
-                    }
-                }
-
-                if (bAccepted)
-                {
-                    simiIt  = mSubAccount.find (affectedAccount.getAccountID ());
+            iProposed += mSubRTAccount.collect (
+                affectedAccount.getAccountID (), notify);
 
-                    if (simiIt != mSubAccount.end ())
-                    {
-                        auto it = simiIt->second.begin ();
-                        while (it != simiIt->second.end ())
-                        {
-                            InfoSub::pointer p = it->second.lock ();
-
-                            if (p)
-                            {
-                                notify.insert (p);
-                                ++it;
-                                ++iAccepted;
-                            }
-                            else
-                                it = simiIt->second.erase (it);
-                        }
-                    }
-                }
-            }
+            if (bAccepted)
+                iAccepted += mSubAccount.collect (
+                    affectedAccount.getAccountID (), notify);
         }
     }
     m_journal.trace << "pubAccountTransaction:" <<
         " iProposed=" << iProposed <<
         " iAccepted=" << iAccepted;
 
-    if (!notify.empty ())
-    {
-        Json::Value jvObj = transJson (
-            *alTx.getTxn (), alTx.getResult (), bAccepted, lpCurrent);
-
-        if (alTx.isApplied ())
-            jvObj[jss::meta] = alTx.getMeta ()->getJson (0);
-
-        std::string sObj = to_string (jvObj);
-
-        for (InfoSub::ref isrListener : notify)
-        {
-            isrListener->send (jvObj, sObj, true);
-        }
-    }
+    // The account streams carry the same message as the transaction
+    // streams, so whatever was rendered for those is reused here.
+    for (InfoSub::ref isrListener : notify)
+        publication.send (isrListener);
 }
 
 //
@@ -2569,7 +2632,7 @@ void NetworkOPsImp::subAccount (
     InfoSub::ref isrListener,
     const hash_set<SkywellAddress>& vnaAccountIDs, bool rt)
 {
-    SubInfoMapType& subMap = rt ? mSubRTAccount : mSubAccount;
+    auto& subMap = rt ? mSubRTAccount : mSubAccount;
 
     for (auto const& naAccountID : vnaAccountIDs)
     {
@@ -2579,25 +2642,8 @@ void NetworkOPsImp::subAccount (
         isrListener->insertSubAccountInfo (naAccountID, rt);
     }
 
-    ScopedLockType sl (mSubLock);
-
     for (auto const& naAccountID : vnaAccountIDs)
-    {
-        auto simIterator = subMap.find (naAccountID.getAccountID ());
-        if (simIterator == subMap.end ())
-        {
-            // Not found, note that account has a new single listner.
-            SubMapType  usisElement;
-            usisElement[isrListener->getSeq ()] = isrListener;
-            subMap.insert (simIterator, make_pair (naAccountID.getAccountID (),
-                                                   usisElement));
-        }
-        else
-        {
-            // Found, note that the account has another listener.
-            simIterator->second[isrListener->getSeq ()] = isrListener;
-        }
-    }
+        subMap.insert (naAccountID.getAccountID (), isrListener);
 }
 
 void NetworkOPsImp::unsubAccount (
@@ -2620,26 +2666,10 @@ void NetworkOPsImp::unsubAccountInternal (
     hash_set<SkywellAddress> const& vnaAccountIDs,
     bool rt)
 {
-    ScopedLockType sl (mSubLock);
-
-    SubInfoMapType& subMap = rt ? mSubRTAccount : mSubAccount;
+    auto& subMap = rt ? mSubRTAccount : mSubAccount;
 
     for (auto const& naAccountID : vnaAccountIDs)
-    {
-        auto simIterator = subMap.find (naAccountID.getAccountID ());
-
-        if (simIterator != subMap.end ())
-        {
-            // Found
-            simIterator->second.erase (uSeq);
-
-            if (simIterator->second.empty ())
-            {
-                // Don't need hash entry.
-                subMap.erase (simIterator);
-            }
-        }
-    }
+        subMap.erase (naAccountID.getAccountID (), uSeq);
 }
 
 bool NetworkOPsImp::subBook (InfoSub::ref isrListener, Book const& book)
@@ -244,7 +244,7 @@ SHAMapStoreImp::onLedgerClosed (Ledger::pointer validatedLedger)
 }
 
 bool
-SHAMapStoreImp::copyNode (std::uint64_t& nodeCount,
+SHAMapStoreImp::copyNode (std::atomic <std::uint64_t>& nodeCount,
         SHAMapTreeNode const& node)
 {
     // Copy a single record from node to database_
@@ -268,6 +268,7 @@ SHAMapStoreImp::run()
     treeNodeCache_ = &getApp().family().treecache();
     transactionDb_ = &getApp().getTxnDB();
     ledgerDb_ = &getApp().getLedgerDB();
+    validationDb_ = &getApp().getValidationDB();
 
     if (setup_.advisoryDelete)
         canDelete_ = state_db_.getCanDelete ();
@@ -330,13 +331,13 @@ SHAMapStoreImp::run()
                     ;
             }
 
-            std::uint64_t nodeCount = 0;
+            std::atomic <std::uint64_t> nodeCount (0);
             validatedLedger_->peekAccountStateMap()->snapShot (
-                    false)->visitNodes (
+                    false)->visitNodesParallel (
                     std::bind (&SHAMapStoreImp::copyNode, this,
                     std::ref(nodeCount), std::placeholders::_1));
             journal_.debug << "copied ledger " << validatedSeq
-                    << " nodecount " << nodeCount;
+                    << " nodecount " << nodeCount.load ();
             switch (health())
             {
                 case Health::stopping:
@@ -491,23 +492,28 @@ SHAMapStoreImp::makeDatabaseRotating (std::string const& name,
         std::shared_ptr <NodeStore::Backend> writableBackend,
         std::shared_ptr <NodeStore::Backend> archiveBackend) const
 {
-    std::unique_ptr <NodeStore::Backend> fastBackend (
-        (setup_.ephemeralNodeDatabase.size() > 0)
-            ? NodeStore::Manager::instance().make_Backend (setup_.ephemeralNodeDatabase,
-            scheduler_, journal_) : nullptr);
+    bool groupCommit = false;
+    get_if_exists (setup_.nodeDatabase, "group_commit", groupCommit);
+
+    std::string tracePath;
+    get_if_exists (setup_.nodeDatabase, "trace", tracePath);
 
     return NodeStore::Manager::instance().make_DatabaseRotating ("NodeStore.main", scheduler_,
             readThreads, writableBackend, archiveBackend,
-            std::move (fastBackend), nodeStoreJournal_);
+            setup_.ephemeralNodeDatabase, groupCommit, tracePath,
+            nodeStoreJournal_);
 }
 
 void
 SHAMapStoreImp::clearSql (DatabaseCon& database,
         LedgerIndex lastRotated,
         std::string const& minQuery,
-        std::string const& deleteQuery)
+        std::string const& deleteQuery,
+        std::uint32_t step)
 {
     LedgerIndex min = std::numeric_limits <LedgerIndex>::max();
+    if (step == 0)
+        step = setup_.deleteBatch;
 
     {
         auto db = database.checkoutDb ();
@@ -527,8 +533,7 @@ SHAMapStoreImp::clearSql (DatabaseCon& database,
         "start: " << deleteQuery << " from " << min << " to " << lastRotated;
     while (min < lastRotated)
     {
-        min = (min + setup_.deleteBatch >= lastRotated) ? lastRotated :
-            min + setup_.deleteBatch;
+        min = (min + step >= lastRotated) ? lastRotated : min + step;
         {
             auto db =  database.checkoutDb ();
             *db << boost::str (formattedDeleteQuery % min);
@@ -567,21 +572,7 @@ SHAMapStoreImp::clearPrior (LedgerIndex lastRotated)
     if (health())
         return;
 
-    // TODO This won't remove validations for ledgers that do not get
-    // validated. That will likely require inserting LedgerSeq into
-    // the validations table.
-    //
-    // This query has poor performance with large data sets.
-    // The schema needs to be redesigned to avoid the JOIN, or an
-    // RDBMS that supports concurrency should be used.
-    /*
-    clearSql (*ledgerDb_, lastRotated,
-        "SELECT MIN(LedgerSeq) FROM Ledgers;",
-        "DELETE FROM Validations WHERE LedgerHash IN "
-        "(SELECT Ledgers.LedgerHash FROM Validations JOIN Ledgers ON "
-        "Validations.LedgerHash=Ledgers.LedgerHash WHERE Ledgers.LedgerSeq < %u);");
-     */
-
+    clearValidations (lastRotated);
     if (health())
         return;
 
@@ -604,6 +595,31 @@ SHAMapStoreImp::clearPrior (LedgerIndex lastRotated)
         return;
 }
 
+void
+SHAMapStoreImp::clearValidations (LedgerIndex lastRotated)
+{
+    // Validations may be kept in their own database, where they cannot be
+    // joined to the Ledgers table. They are removed by signing time
+    // instead, up to the close of the oldest ledger kept. This also
+    // removes validations for ledgers that never became validated.
+    boost::optional<std::uint64_t> closeTime;
+    {
+        auto db = ledgerDb_->checkoutDb ();
+        *db << boost::str (boost::format (
+            "SELECT ClosingTime FROM Ledgers WHERE LedgerSeq = %u;") %
+                lastRotated), soci::into (closeTime);
+    }
+    if (!closeTime)
+        return;
+
+    // Ledgers close a few seconds apart, so step through about as many
+    // ledgers' worth of validations per delete as the other tables do
+    clearSql (*validationDb_, static_cast<std::uint32_t> (*closeTime),
+        "SELECT MIN(SignTime) FROM Validations;",
+        "DELETE FROM Validations WHERE SignTime < %u;",
+        setup_.deleteBatch * 10);
+}
+
 SHAMapStoreImp::Health
 SHAMapStoreImp::health()
 {
@@ -20,6 +20,7 @@
 #ifndef SKYWELL_APP_MISC_SHAMAPSTOREIMP_H_INCLUDED
 #define SKYWELL_APP_MISC_SHAMAPSTOREIMP_H_INCLUDED
 
+#include <atomic>
 #include <iostream>
 #include <condition_variable>
 #include <thread>
@@ -88,7 +89,7 @@ private:
     SavedStateDB state_db_;
     std::thread thread_;
     bool stop_ = false;
-    bool healthy_ = true;
+    std::atomic <bool> healthy_ {true};
     mutable std::condition_variable cond_;
     mutable std::mutex mutex_;
     Ledger::pointer newLedger_;
@@ -103,6 +104,7 @@ private:
     TreeNodeCache* treeNodeCache_ = nullptr;
     DatabaseCon* transactionDb_ = nullptr;
     DatabaseCon* ledgerDb_ = nullptr;
+    DatabaseCon* validationDb_ = nullptr;
 
 public:
     SHAMapStoreImp (Setup const& setup,
@@ -159,7 +161,8 @@ public:
 
 private:
     // callback for visitNodes
-    bool copyNode (std::uint64_t& nodeCount, SHAMapTreeNode const &node);
+    bool copyNode (std::atomic <std::uint64_t>& nodeCount,
+        SHAMapTreeNode const &node);
     void run();
     void dbPaths();
     std::shared_ptr <NodeStore::Backend> makeBackendRotating (
@@ -200,9 +203,13 @@ private:
     /** delete from sqlite table in batches to not lock the db excessively
      *  pause briefly to extend access time to other users
      *  call with mutex object unlocked
+     *  step is the batch size in units of the queried column,
+     *  or 0 for delete_batch ledgers
      */
     void clearSql (DatabaseCon& database, LedgerIndex lastRotated,
-                   std::string const& minQuery, std::string const& deleteQuery);
+                   std::string const& minQuery, std::string const& deleteQuery,
+                   std::uint32_t step = 0);
+    void clearValidations (LedgerIndex lastRotated);
     void clearCaches (LedgerIndex validatedSeq);
     void freshenCaches();
     void clearPrior (LedgerIndex lastRotated);
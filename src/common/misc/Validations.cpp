@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <BeastConfig.h>
+#include <algorithm>
 #include <mutex>
 #include <thread>
 #include <common/misc/Utility.h>
@@ -43,6 +44,8 @@ private:
     typedef beast::GenericScopedUnlock <LockType> ScopedUnlockType;
     std::mutex mutable mLock;
 
+    Setup const mSetup;
+
     TaggedCache<uint256, ValidationSet> mValidations;
     ValidationSet mCurrentValidations;
     ValidationVector mStaleValidations;
@@ -69,8 +72,9 @@ private:
     }
 
 public:
-    ValidationsImp ()
-        : mValidations ("Validations", 128, 600, get_seconds_clock (),
+    explicit ValidationsImp (Setup const& setup)
+        : mSetup (setup)
+        , mValidations ("Validations", 128, 600, get_seconds_clock (),
             deprecatedLogs().journal("TaggedCache"))
         , mWriting (false)
     {
@@ -440,8 +444,6 @@ private:
     void doWrite (Job&)
     {
         LoadEvent::autoptr event (getApp().getJobQueue ().getLoadEventAP (jtDISK, "ValidationWrite"));
-        boost::format insVal ("INSERT INTO Validations "
-                              "(LedgerHash,NodePubKey,SignTime,RawData) VALUES ('%s','%s','%u',%s);");
 
         ScopedLockType sl (mLock);
         assert (mWriting);
@@ -454,29 +456,71 @@ private:
 
             {
                 ScopedUnlockType sul (mLock);
-                {
-                    auto db = getApp().getLedgerDB ().checkoutDb ();
-
-                    Serializer s (1024);
-                    soci::transaction tr(*db);
-                    for (auto it: vector)
-                    {
-                        s.erase ();
-                        it->add (s);
-                        *db << boost::str (
-                            insVal % to_string (it->getLedgerHash ()) %
-                            it->getSignerPublic ().humanNodePublic () %
-                            it->getSignTime () % sqlEscape (s.peekData ()));
-                    }
 
-                    tr.commit ();
+                for (std::size_t i = 0; i < vector.size (); i += mSetup.batchSize)
+                {
+                    writeBatch (vector.begin () + i, vector.begin () +
+                        std::min (vector.size (), i + mSetup.batchSize));
                 }
+
+                if (mSetup.retainSeconds != 0)
+                    prune ();
             }
         }
 
         mWriting = false;
     }
 
+    // Writes validations with a single multi-row INSERT, so a batch
+    // costs one round trip and one commit instead of one per row.
+    void writeBatch (ValidationVector::const_iterator first,
+        ValidationVector::const_iterator last)
+    {
+        std::string sql ("INSERT INTO Validations "
+            "(LedgerHash,NodePubKey,SignTime,RawData) VALUES ");
+        sql.reserve (sql.size () + (last - first) * 512);
+
+        Serializer s (1024);
+        for (auto it = first; it != last; ++it)
+        {
+            s.erase ();
+            (*it)->add (s);
+
+            if (it != first)
+                sql += ',';
+            sql += "('";
+            sql += to_string ((*it)->getLedgerHash ());
+            sql += "','";
+            sql += (*it)->getSignerPublic ().humanNodePublic ();
+            sql += "','";
+            sql += std::to_string ((*it)->getSignTime ());
+            sql += "',";
+            sql += sqlEscape (s.peekData ());
+            sql += ')';
+        }
+        sql += ';';
+
+        auto db = getApp().getValidationDB ().checkoutDb ();
+        soci::transaction tr (*db);
+        *db << sql;
+        tr.commit ();
+    }
+
+    // Removes validations signed before the retention window. Each pass
+    // deletes a bounded number of rows so a large backlog is worked off
+    // over several writes without holding the database for long.
+    void prune ()
+    {
+        std::uint32_t const now = getApp().getOPs().getCloseTimeNC();
+        if (now <= mSetup.retainSeconds)
+            return;
+
+        auto db = getApp().getValidationDB ().checkoutDb ();
+        *db << boost::str (boost::format (
+            "DELETE FROM Validations WHERE SignTime < %u LIMIT %u;") %
+                (now - mSetup.retainSeconds) % (4 * mSetup.batchSize));
+    }
+
     void sweep ()
     {
         ScopedLockType sl (mLock);
@@ -484,9 +528,19 @@ private:
     }
 };
 
-std::unique_ptr <Validations> make_Validations ()
+Validations::Setup
+setup_Validations (Section const& section)
+{
+    Validations::Setup setup;
+    set (setup.batchSize, "batch_size", section);
+    set (setup.retainSeconds, "retain_seconds", section);
+    setup.batchSize = std::max<std::size_t> (setup.batchSize, 1);
+    return setup;
+}
+
+std::unique_ptr <Validations> make_Validations (Validations::Setup const& setup)
 {
-    return std::make_unique <ValidationsImp> ();
+    return std::make_unique <ValidationsImp> (setup);
 }
 
 } // skywell
@@ -23,6 +23,7 @@
 #include <vector>
 #include <protocol/STValidation.h>
 #include <common/misc/Utility.h>
+#include <common/base/BasicConfig.h>
 
 namespace skywell {
 
@@ -38,6 +39,17 @@ typedef std::vector<STValidation::pointer> ValidationVector;
 class Validations
 {
 public:
+    /** How stale validations are archived to the database. */
+    struct Setup
+    {
+        /** Validations written by one INSERT, in one transaction. */
+        std::size_t batchSize = 256;
+
+        /** Seconds of validations to keep, by signing time.
+            Zero keeps every validation.
+        */
+        std::uint32_t retainSeconds = 0;
+    };
 
     virtual ~Validations () { }
 
@@ -79,7 +91,11 @@ public:
     virtual void sweep () = 0;
 };
 
-std::unique_ptr <Validations> make_Validations ();
+/** Build Validations::Setup from a config section. */
+Validations::Setup
+setup_Validations (Section const& section);
+
+std::unique_ptr <Validations> make_Validations (Validations::Setup const& setup);
 
 } // skywell
 
@@ -0,0 +1,148 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <common/misc/impl/AccountSubscriptions.h>
+#include <initializer_list>
+
+namespace skywell {
+
+namespace {
+
+// Account IDs are hashes, so their bytes can index directly
+std::size_t
+bytesAt (Account const& account, std::size_t offset)
+{
+    return (static_cast <std::size_t> (account.begin ()[offset]) << 8) |
+        account.begin ()[offset + 1];
+}
+
+}
+
+AccountSubscriptions::AccountSubscriptions ()
+    : accounts_ (0)
+{
+    for (auto& slot : filter_)
+        slot.store (0, std::memory_order_relaxed);
+}
+
+AccountSubscriptions::Shard&
+AccountSubscriptions::shard (Account const& account)
+{
+    return shards_[account.begin ()[4] & (shardCount - 1)];
+}
+
+bool
+AccountSubscriptions::mayContain (Account const& account) const
+{
+    return
+        filter_[bytesAt (account, 0) & (filterSize - 1)].load (
+            std::memory_order_acquire) != 0 &&
+        filter_[bytesAt (account, 2) & (filterSize - 1)].load (
+            std::memory_order_acquire) != 0;
+}
+
+void
+AccountSubscriptions::adjust (Account const& account, bool add)
+{
+    for (auto const offset : { 0, 2 })
+    {
+        auto& slot = filter_[bytesAt (account, offset) & (filterSize - 1)];
+        if (add)
+            slot.fetch_add (1, std::memory_order_release);
+        else
+            slot.fetch_sub (1, std::memory_order_release);
+    }
+
+    if (add)
+        accounts_.fetch_add (1, std::memory_order_relaxed);
+    else
+        accounts_.fetch_sub (1, std::memory_order_relaxed);
+}
+
+void
+AccountSubscriptions::insert (Account const& account, InfoSub::ref subscriber)
+{
+    auto& s = shard (account);
+    std::lock_guard <std::mutex> lock (s.mutex);
+
+    auto& subs = s.map[account];
+    if (subs.empty ())
+        adjust (account, true);
+    subs[subscriber->getSeq ()] = subscriber;
+}
+
+void
+AccountSubscriptions::erase (Account const& account, std::uint64_t seq)
+{
+    auto& s = shard (account);
+    std::lock_guard <std::mutex> lock (s.mutex);
+
+    auto const iter = s.map.find (account);
+    if (iter == s.map.end ())
+        return;
+
+    iter->second.erase (seq);
+    if (iter->second.empty ())
+    {
+        s.map.erase (iter);
+        adjust (account, false);
+    }
+}
+
+int
+AccountSubscriptions::collect (Account const& account,
+    hash_set <InfoSub::pointer>& to)
+{
+    if (! mayContain (account))
+        return 0;
+
+    auto& s = shard (account);
+    std::lock_guard <std::mutex> lock (s.mutex);
+
+    auto const iter = s.map.find (account);
+    if (iter == s.map.end ())
+        return 0;
+
+    int found = 0;
+    auto& subs = iter->second;
+    for (auto it = subs.begin (); it != subs.end ();)
+    {
+        if (auto p = it->second.lock ())
+        {
+            to.insert (std::move (p));
+            ++found;
+            ++it;
+        }
+        else
+        {
+            it = subs.erase (it);
+        }
+    }
+
+    if (subs.empty ())
+    {
+        s.map.erase (iter);
+        adjust (account, false);
+    }
+
+    return found;
+}
+
+}
@@ -0,0 +1,107 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef SKYWELL_APP_MISC_IMPL_ACCOUNTSUBSCRIPTIONS_H_INCLUDED
+#define SKYWELL_APP_MISC_IMPL_ACCOUNTSUBSCRIPTIONS_H_INCLUDED
+
+#include <services/net/InfoSub.h>
+#include <protocol/UintTypes.h>
+#include <common/base/UnorderedContainers.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+namespace skywell {
+
+/** The subscribers to transactions affecting particular accounts.
+
+    Accounts are spread over shards which each have their own lock, so
+    a subscription only waits for a publish touching the same shard. A
+    counting filter over the subscribed accounts lets a publish skip
+    accounts which nobody watches without taking any lock.
+
+    @note This can be called concurrently.
+*/
+class AccountSubscriptions
+{
+public:
+    typedef hash_map <std::uint64_t, InfoSub::wptr> SubMapType;
+
+    AccountSubscriptions ();
+
+    AccountSubscriptions (AccountSubscriptions const&) = delete;
+    AccountSubscriptions& operator= (AccountSubscriptions const&) = delete;
+
+    /** Returns `true` if no account has a subscriber. */
+    bool
+    empty () const
+    {
+        return accounts_.load (std::memory_order_relaxed) == 0;
+    }
+
+    /** Add a subscriber to an account. */
+    void
+    insert (Account const& account, InfoSub::ref subscriber);
+
+    /** Remove the subscriber with the given sequence from an account. */
+    void
+    erase (Account const& account, std::uint64_t seq);
+
+    /** Add the live subscribers of an account to a set.
+
+        Subscribers which no longer exist are removed on the way.
+
+        @return The number of subscribers found.
+    */
+    int
+    collect (Account const& account, hash_set <InfoSub::pointer>& to);
+
+private:
+    // Both must be powers of two
+    static std::size_t const shardCount = 16;
+    static std::size_t const filterSize = 4096;
+
+    struct Shard
+    {
+        std::mutex mutex;
+        hash_map <Account, SubMapType> map;
+    };
+
+    Shard&
+    shard (Account const& account);
+
+    bool
+    mayContain (Account const& account) const;
+
+    void
+    adjust (Account const& account, bool add);
+
+    std::array <Shard, shardCount> shards_;
+
+    // Counts the subscribed accounts hashing to each slot. An account
+    // occupies two slots and is certainly absent if either is zero.
+    std::array <std::atomic <std::uint32_t>, filterSize> filter_;
+
+    std::atomic <std::size_t> accounts_;
+};
+
+}
+
+#endif
@@ -0,0 +1,85 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <common/misc/impl/BinaryStream.h>
+#include <protocol/Serializer.h>
+
+namespace skywell {
+namespace BinaryStream {
+
+char const* const subprotocol = "skywell-binary";
+
+namespace {
+
+void
+addBlob (Serializer& s, Serializer const& blob)
+{
+    s.add32 (blob.size ());
+    s.addRaw (blob);
+}
+
+}
+
+std::string
+makeLedgerClosed (Ledger::ref ledger, std::uint32_t txnCount,
+    std::string const& validatedLedgers)
+{
+    Serializer header (128);
+    ledger->addRaw (header);
+
+    Serializer s (header.size () + validatedLedgers.size () + 80);
+    s.add8 (ledgerClosed);
+    s.add32 (ledger->getLedgerSeq ());
+    s.add256 (ledger->getHash ());
+    s.add32 (txnCount);
+    addBlob (s, header);
+    s.add32 (ledger->getReferenceFeeUnits ());
+    s.add64 (ledger->getBaseFee ());
+    s.add64 (ledger->getReserve (0));
+    s.add64 (ledger->getReserveInc ());
+    s.add32 (validatedLedgers.size ());
+    s.addRaw (validatedLedgers.data (), validatedLedgers.size ());
+    return s.getString ();
+}
+
+std::string
+makeTransaction (STTx const& txn, TER result, bool validated,
+    Ledger::ref ledger, Blob const* meta)
+{
+    Serializer tx (512);
+    txn.add (tx);
+
+    std::size_t const metaSize = meta ? meta->size () : 0;
+
+    Serializer s (tx.size () + metaSize + 56);
+    s.add8 (transaction);
+    s.add8 (validated ? BinaryStream::validated : 0);
+    s.add32 (ledger->getLedgerSeq ());
+    s.add256 (validated ? ledger->getHash () : uint256 ());
+    s.add32 (static_cast <std::uint32_t> (result));
+    addBlob (s, tx);
+    s.add32 (metaSize);
+    if (metaSize != 0)
+        s.addRaw (*meta);
+    return s.getString ();
+}
+
+}
+}
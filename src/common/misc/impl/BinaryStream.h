@@ -0,0 +1,83 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef SKYWELL_APP_MISC_IMPL_BINARYSTREAM_H_INCLUDED
+#define SKYWELL_APP_MISC_IMPL_BINARYSTREAM_H_INCLUDED
+
+#include <ledger/Ledger.h>
+#include <protocol/STTx.h>
+#include <protocol/TER.h>
+#include <cstdint>
+#include <string>
+
+namespace skywell {
+
+/** Subscription messages in the binary stream format.
+
+    Websocket clients which negotiate the subprotocol named below receive
+    ledger and transaction stream messages as binary frames in this
+    format instead of JSON. Integers are big endian, and each blob is
+    the canonical serialization preceded by its length as four bytes.
+
+    Ledger closed, type 1:
+        u8 type, u32 ledger index, 32 byte ledger hash, u32 transaction
+        count, blob ledger header, u32 reference fee units, u64 base fee,
+        u64 base reserve, u64 reserve increment, blob validated ledgers.
+        The fees and reserves are in drops. The validated ledgers are the
+        text of the JSON field, and empty when the JSON omits it.
+
+    Transaction, type 2:
+        u8 type, u8 flags (1 if validated), u32 ledger index, 32 byte
+        ledger hash (zero unless validated), i32 engine result, blob
+        transaction, blob metadata (empty unless validated).
+
+    Responses to requests and the other streams stay JSON, sent in
+    text frames.
+*/
+namespace BinaryStream {
+
+/** The websocket subprotocol which selects this format. */
+extern char const* const subprotocol;
+
+enum Type
+{
+    ledgerClosed = 1,
+    transaction = 2
+};
+
+enum Flags
+{
+    validated = 1
+};
+
+/** @param validatedLedgers The complete ledger ranges, or empty. */
+std::string
+makeLedgerClosed (Ledger::ref ledger, std::uint32_t txnCount,
+    std::string const& validatedLedgers);
+
+/** @param meta The serialized metadata, or `nullptr` if there is none. */
+std::string
+makeTransaction (STTx const& txn, TER result, bool validated,
+    Ledger::ref ledger, Blob const* meta);
+
+}
+
+}
+
+#endif
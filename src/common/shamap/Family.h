@@ -26,6 +26,9 @@
 #include <data/nodestore/Database.h>
 
 namespace skywell {
+
+class JobQueue;
+
 namespace shamap {
 
 class Family
@@ -60,6 +63,11 @@ public:
     virtual
     void
     missing_node (std::uint32_t refNum) = 0;
+
+    /** The queue which parallel walks add their helper jobs to. */
+    virtual
+    JobQueue&
+    jobQueue() = 0;
 };
 
 } // shamap
@@ -20,6 +20,7 @@
 #ifndef SKYWELL_SHAMAP_SHAMAP_H_INCLUDED
 #define SKYWELL_SHAMAP_SHAMAP_H_INCLUDED
 
+#include <atomic>
 #include <stack>
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/shared_lock_guard.hpp>
@@ -93,6 +94,14 @@ public:
                                 std::shared_ptr<SHAMapItem>>;
     using Delta     = std::map<uint256, DeltaItem>;
 
+    /** Receives an item of this map and the item with the same key in
+        the other map, either of which is null when the key is only in
+        one map. Returns `false` to stop.
+    */
+    using DeltaVisitor = std::function<bool (
+        std::shared_ptr<SHAMapItem> const& ours,
+            std::shared_ptr<SHAMapItem> const& theirs)>;
+
     ~SHAMap ();
     SHAMap(SHAMap const&) = delete;
     SHAMap& operator=(SHAMap const&) = delete;
@@ -145,6 +154,15 @@ public:
     std::shared_ptr<SHAMapItem> peekItem (uint256 const& id, uint256 & hash) const;
     std::shared_ptr<SHAMapItem> peekItem (uint256 const& id, SHAMapTreeNode::TNType & type) const;
 
+    /** Bring the nodes on the path to an item into memory without blocking.
+        A read is scheduled for the first node which is not in memory,
+        instead of waiting for it. Once this returns `true`, looking up
+        the item causes no NodeStore reads.
+        @param missing Set to the hash of the node being read.
+        @return `false` if the walk must wait for a read.
+    */
+    bool fetchPathAsync (uint256 const& id, uint256& missing) const;
+
     // traverse functions
     std::shared_ptr<SHAMapItem> peekFirstItem () const;
     std::shared_ptr<SHAMapItem> peekFirstItem (SHAMapTreeNode::TNType & type) const;
@@ -156,6 +174,21 @@ public:
     void visitNodes (std::function<bool (SHAMapTreeNode&)> const&) const;
     void visitLeaves(std::function<void (std::shared_ptr<SHAMapItem> const&)> const&) const;
 
+    /** Visit every node from several threads.
+        The subtrees below the root's children are walked concurrently by
+        the caller and jobs on the family's job queue, prefetching the
+        children of each inner node with async reads. The function is
+        called concurrently and in no particular order; returning `true`
+        stops the walk. A missing node is rethrown on the calling thread
+        once every subtree has stopped.
+        @param threads Most jobs, including the caller. Zero for one per core.
+    */
+    void visitNodesParallel (std::function<bool (SHAMapTreeNode&)> const&,
+        int threads = 0) const;
+    void visitLeavesParallel (
+        std::function<void (std::shared_ptr<SHAMapItem> const&)> const&,
+            int threads = 0) const;
+
     // comparison/sync functions
     void getMissingNodes (std::vector<SHAMapNodeID>& nodeIDs, std::vector<uint256>& hashes, int max,
                           SHAMapSyncFilter * filter);
@@ -186,7 +219,35 @@ public:
     bool compare (std::shared_ptr<SHAMap> const& otherMap,
                   Delta& differences, int maxCount) const;
 
+    /** Stream the items which differ between this map and another.
+
+        Subtrees with the same hash in both maps are skipped without
+        being loaded, and leaves are compared by hash, so item payloads
+        are never read. Only the frontier of the walk is held in memory
+        and nodes are not hooked into either tree, so memory use does
+        not grow with the size of the delta.
+
+        With one thread the visitor sees keys in ascending order. With
+        more, the branches below the roots are diffed concurrently and
+        the visitor is called concurrently, in no particular order.
+
+        Throws SHAMapMissingNode if a node needed is not available.
+        CAUTION: both maps must be immutable.
+
+        @param threads Most jobs on the family's job queue, including the
+                       caller. Zero for one per core.
+        @return `false` if the visitor stopped the walk.
+    */
+    bool visitDeltas (SHAMap const& other, DeltaVisitor const& visitor,
+        int threads = 1) const;
+
     int flushDirty (NodeObjectType t, std::uint32_t seq);
+
+    /** Flush modified nodes, collecting them rather than storing them.
+        The caller hands the batch to NodeStore::Database::storeBatch.
+    */
+    int flushDirty (NodeObjectType t, std::uint32_t seq,
+        NodeStore::Batch& batch);
     void walkMap (std::vector<SHAMapMissingNode>& missingNodes, int maxMissing) const;
     bool deepCompare (SHAMap & other) const;
 
@@ -243,7 +304,7 @@ private:
 
     /** write and canonicalize modified node */
     void writeNode (NodeObjectType t, std::uint32_t seq,
-        std::shared_ptr<SHAMapTreeNode>& node) const;
+        std::shared_ptr<SHAMapTreeNode>& node, NodeStore::Batch* batch) const;
 
     SHAMapTreeNode* firstBelow (SHAMapTreeNode*) const;
     SHAMapTreeNode* lastBelow (SHAMapTreeNode*) const;
@@ -267,16 +328,50 @@ private:
     // Does not hook the returned node to its parent
     std::shared_ptr<SHAMapTreeNode> descendNoStore (std::shared_ptr<SHAMapTreeNode> const&, int branch) const;
 
+    struct ChildReads;
+
+    /** Queue async reads for the children of an inner node
+        @return The reads still in flight, or null if there are none.
+    */
+    std::shared_ptr<ChildReads> prefetchChildren (SHAMapTreeNode& node) const;
+
+    /** Visit the nodes below one, returning `true` if the function did */
+    bool visitBelow (std::shared_ptr<SHAMapTreeNode> node,
+        std::function<bool (SHAMapTreeNode&)> const& function,
+            std::atomic<bool> const& stop) const;
+
     /** If there is only one leaf below this node, get its contents */
     std::shared_ptr<SHAMapItem> onlyBelow (SHAMapTreeNode*) const;
 
     bool hasInnerNode (SHAMapNodeID const& nodeID, uint256 const& hash) const;
     bool hasLeafNode (uint256 const& tag, uint256 const& hash) const;
 
-    bool walkBranch (SHAMapTreeNode* node,
-                     std::shared_ptr<SHAMapItem> const& otherMapItem, bool isFirstMap,
-                     Delta & differences, int & maxCount) const;
-    int walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq);
+    // A pair of nodes at the same position in this map and another,
+    // either of which may be null. A leaf stands for every position on
+    // the path to its key.
+    struct DeltaEntry
+    {
+        std::shared_ptr<SHAMapTreeNode> ours;
+        std::shared_ptr<SHAMapTreeNode> theirs;
+        int depth;
+    };
+    using DeltaStack = std::vector<DeltaEntry>;
+
+    /** Get a child without hooking it up, throwing if it is missing */
+    std::shared_ptr<SHAMapTreeNode> descendDelta (
+        std::shared_ptr<SHAMapTreeNode> const& parent, int branch) const;
+
+    /** Push the differing children of a pair, last branch first.
+        Returns `false` if neither node is inner.
+    */
+    bool splitDelta (SHAMap const& other, DeltaEntry const& entry,
+        DeltaStack& stack) const;
+
+    /** Diff the pairs on the stack, returning `false` if the visitor did */
+    bool visitDeltasBelow (SHAMap const& other, DeltaStack& stack,
+        DeltaVisitor const& visitor, std::atomic<bool> const& stop) const;
+    int walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq,
+        NodeStore::Batch* batch);
 };
 
 inline
@@ -671,6 +671,40 @@ bool SHAMap::hasItem (uint256 const& id) const
     return (leaf != nullptr);
 }
 
+bool SHAMap::fetchPathAsync (uint256 const& id, uint256& missing) const
+{
+    SHAMapTreeNode* inNode = root_.get ();
+    SHAMapNodeID nodeID;
+
+    while (inNode->isInner ())
+    {
+        int branch = nodeID.selectBranch (id);
+
+        if (inNode->isEmptyBranch (branch))
+            return true;
+
+        SHAMapNodeID childID = nodeID.getChildNodeID (branch);
+        bool pending = false;
+        SHAMapTreeNode* child = descendAsync (inNode, branch, childID,
+            nullptr, pending);
+
+        if (pending)
+        {
+            missing = inNode->getChildHash (branch);
+            return false;
+        }
+
+        // A node missing from the store is reported by the lookup itself
+        if (!child)
+            return true;
+
+        inNode = child;
+        nodeID = childID;
+    }
+
+    return true;
+}
+
 bool SHAMap::delItem (uint256 const& id)
 {
     // delete the item with this ID
@@ -927,8 +961,12 @@ bool SHAMap::fetchRoot (uint256 const& hash, SHAMapSyncFilter* filter)
 //
 // 2) An unshareable node is shared. This happens when you make
 // a mutable snapshot of a mutable SHAMap.
+//
+// With a batch the serialized node is collected for a group commit
+// instead of being stored immediately.
 void SHAMap::writeNode (
-    NodeObjectType t, std::uint32_t seq, std::shared_ptr<SHAMapTreeNode>& node) const
+    NodeObjectType t, std::uint32_t seq, std::shared_ptr<SHAMapTreeNode>& node,
+    NodeStore::Batch* batch) const
 {
     // Node is ours, so we can just make it shareable
     assert (node->getSeq() == seq_);
@@ -939,8 +977,12 @@ void SHAMap::writeNode (
 
     Serializer s;
     node->addRaw (s, snfPREFIX);
-    f_.db().store (t,
-        std::move (s.modData ()), node->getNodeHash ());
+    if (batch)
+        batch->push_back (NodeObject::createObject (t,
+            std::move (s.modData ()), node->getNodeHash ()));
+    else
+        f_.db().store (t,
+            std::move (s.modData ()), node->getNodeHash ());
 }
 
 // We can't modify an inner node someone else might have a
@@ -962,18 +1004,25 @@ void SHAMap::preFlushNode (std::shared_ptr<SHAMapTreeNode>& node) const
 
 int SHAMap::unshare ()
 {
-    return walkSubTree (false, hotUNKNOWN, 0);
+    return walkSubTree (false, hotUNKNOWN, 0, nullptr);
 }
 
 /** Convert all modified nodes to shared nodes */
 // If requested, write them to the node store
 int SHAMap::flushDirty (NodeObjectType t, std::uint32_t seq)
 {
-    return walkSubTree (true, t, seq);
+    return walkSubTree (true, t, seq, nullptr);
+}
+
+int SHAMap::flushDirty (NodeObjectType t, std::uint32_t seq,
+    NodeStore::Batch& batch)
+{
+    return walkSubTree (true, t, seq, &batch);
 }
 
 int
-SHAMap::walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq)
+SHAMap::walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq,
+    NodeStore::Batch* batch)
 {
     int flushed = 0;
     Serializer s;
@@ -985,7 +1034,7 @@ SHAMap::walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq)
     { // special case -- root_ is leaf
         preFlushNode (root_);
         if (doWrite && backed_)
-            writeNode (t, seq, root_);
+            writeNode (t, seq, root_, batch);
         return 1;
     }
 
@@ -1040,7 +1089,7 @@ SHAMap::walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq)
                         child->updateHash();
 
                         if (doWrite && backed_)
-                            writeNode (t, seq, child);
+                            writeNode (t, seq, child, batch);
 
                         node->shareChild (branch, child);
                     }
@@ -1053,7 +1102,7 @@ SHAMap::walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq)
 
         // This inner node can now be shared
         if (doWrite && backed_)
-            writeNode (t, seq, node);
+            writeNode (t, seq, node, batch);
 
         ++flushed;
 
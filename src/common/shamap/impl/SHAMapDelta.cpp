@@ -19,6 +19,9 @@
 
 #include <BeastConfig.h>
 #include <common/shamap/SHAMap.h>
+#include <common/core/ParallelFor.h>
+#include <algorithm>
+#include <thread>
     
 namespace skywell {
 
@@ -30,193 +33,206 @@ namespace skywell {
 // makes no sense at all. (And our sync algorithm will avoid
 // synchronizing matching branches too.)
 
-bool SHAMap::walkBranch (SHAMapTreeNode* node,
-                         std::shared_ptr<SHAMapItem> const& otherMapItem, bool isFirstMap,
-                         Delta& differences, int& maxCount) const
+bool
+SHAMap::compare (std::shared_ptr<SHAMap> const& otherMap,
+                 Delta& differences, int maxCount) const
 {
-    // Walk a branch of a SHAMap that's matched by an empty branch or single item in the other map
-    std::stack <SHAMapTreeNode*, std::vector<SHAMapTreeNode*>> nodeStack;
-    nodeStack.push ({node});
-
-    bool emptyBranch = !otherMapItem;
+    // compare two hash trees, add up to maxCount differences to the difference table
+    // return value: true=complete table of differences given, false=too many differences
+    // throws on corrupt tables or missing nodes
+    // CAUTION: otherMap is not locked and must be immutable
 
-    while (!nodeStack.empty ())
-    {
-        node = nodeStack.top ();
-        nodeStack.pop ();
+    assert (isValid () && otherMap && otherMap->isValid ());
 
-        if (node->isInner ())
+    return visitDeltas (*otherMap,
+        [&differences, &maxCount] (std::shared_ptr<SHAMapItem> const& ours,
+            std::shared_ptr<SHAMapItem> const& theirs)
         {
-            // This is an inner node, add all non-empty branches
-            for (int i = 0; i < 16; ++i)
-                if (!node->isEmptyBranch (i))
-                    nodeStack.push ({descendThrow (node, i)});
-        }
-        else
-        {
-            // This is a leaf node, process its item
-            std::shared_ptr<SHAMapItem> item = node->peekItem ();
+            uint256 const& tag = ours ? ours->getTag () : theirs->getTag ();
+            differences.insert (std::make_pair (tag, DeltaRef (ours, theirs)));
+            return --maxCount > 0;
+        });
+}
 
-            if (emptyBranch || (item->getTag () != otherMapItem->getTag ()))
-            {
-                // unmatched
-                if (isFirstMap)
-                    differences.insert (std::make_pair (item->getTag (),
-                                      DeltaRef (item, std::shared_ptr<SHAMapItem> ())));
-                else
-                    differences.insert (std::make_pair (item->getTag (),
-                                      DeltaRef (std::shared_ptr<SHAMapItem> (), item)));
+//------------------------------------------------------------------------------
 
-                if (--maxCount <= 0)
-                    return false;
-            }
-            else if (item->peekData () != otherMapItem->peekData ())
-            {
-                // non-matching items with same tag
-                if (isFirstMap)
-                    differences.insert (std::make_pair (item->getTag (),
-                                                DeltaRef (item, otherMapItem)));
-                else
-                    differences.insert (std::make_pair (item->getTag (),
-                                                DeltaRef (otherMapItem, item)));
+static uint256 const zeroHash;
 
-                if (--maxCount <= 0)
-                    return false;
+// The branch of a node at the given depth which leads to a key
+static int selectBranch (uint256 const& key, int depth)
+{
+    int branch = * (key.begin () + (depth / 2));
 
-                emptyBranch = true;
-            }
-            else
-            {
-                // exact match
-                emptyBranch = true;
-            }
-        }
-    }
+    if (depth & 1)
+        branch &= 0xf;
+    else
+        branch >>= 4;
+
+    return branch;
+}
+
+// The hash found below one branch of a node standing at the given depth
+static uint256 const& branchHash (SHAMapTreeNode const* node,
+    int branch, int depth)
+{
+    if (!node)
+        return zeroHash;
+
+    if (node->isInner ())
+        return node->getChildHash (branch);
+
+    if (selectBranch (node->peekItem ()->getTag (), depth) == branch)
+        return node->getNodeHash ();
+
+    return zeroHash;
+}
 
-    if (!emptyBranch)
+std::shared_ptr<SHAMapTreeNode>
+SHAMap::descendDelta (std::shared_ptr<SHAMapTreeNode> const& parent,
+    int branch) const
+{
+    std::shared_ptr<SHAMapTreeNode> child = descendNoStore (parent, branch);
+
+    if (!child)
+        throw SHAMapMissingNode (type_, parent->getChildHash (branch));
+
+    return child;
+}
+
+bool SHAMap::splitDelta (SHAMap const& other, DeltaEntry const& entry,
+    DeltaStack& stack) const
+{
+    std::shared_ptr<SHAMapTreeNode> const& ours = entry.ours;
+    std::shared_ptr<SHAMapTreeNode> const& theirs = entry.theirs;
+
+    if (! (ours && ours->isInner ()) && ! (theirs && theirs->isInner ()))
+        return false;
+
+    for (int branch = 15; branch >= 0; --branch)
     {
-        // otherMapItem was unmatched, must add
-        if (isFirstMap) // this is first map, so other item is from second
-            differences.insert (std::make_pair (otherMapItem->getTag (),
-                                                DeltaRef (std::shared_ptr<SHAMapItem>(),
-                                                          otherMapItem)));
-        else
-            differences.insert (std::make_pair (otherMapItem->getTag (),
-                                                DeltaRef (otherMapItem,
-                                                      std::shared_ptr<SHAMapItem> ())));
-
-        if (--maxCount <= 0)
-            return false;
+        uint256 const& ourHash = branchHash (ours.get (), branch, entry.depth);
+        uint256 const& theirHash = branchHash (theirs.get (), branch, entry.depth);
+
+        // Shared subtrees and branches empty in both are skipped unread
+        if (ourHash == theirHash)
+            continue;
+
+        DeltaEntry child;
+        child.depth = entry.depth + 1;
+
+        if (ourHash.isNonZero ())
+            child.ours = ours->isInner () ? descendDelta (ours, branch) : ours;
+
+        if (theirHash.isNonZero ())
+            child.theirs = theirs->isInner () ?
+                other.descendDelta (theirs, branch) : theirs;
+
+        stack.push_back (std::move (child));
     }
 
     return true;
 }
 
-bool
-SHAMap::compare (std::shared_ptr<SHAMap> const& otherMap,
-                 Delta& differences, int maxCount) const
+bool SHAMap::visitDeltasBelow (SHAMap const& other, DeltaStack& stack,
+    DeltaVisitor const& visitor, std::atomic<bool> const& stop) const
 {
-    // compare two hash trees, add up to maxCount differences to the difference table
-    // return value: true=complete table of differences given, false=too many differences
-    // throws on corrupt tables or missing nodes
-    // CAUTION: otherMap is not locked and must be immutable
+    static std::shared_ptr<SHAMapItem> const none;
 
-    assert (isValid () && otherMap && otherMap->isValid ());
+    while (!stack.empty ())
+    {
+        if (stop)
+            return true;
 
-    using StackEntry = std::pair <SHAMapTreeNode*, SHAMapTreeNode*>;
-    std::stack <StackEntry, std::vector<StackEntry>> nodeStack; // track nodes we've pushed
+        DeltaEntry const entry = std::move (stack.back ());
+        stack.pop_back ();
 
-    if (getHash () == otherMap->getHash ())
-        return true;
+        if (splitDelta (other, entry, stack))
+            continue;
 
-    nodeStack.push ({root_.get(), otherMap->root_.get()});
-    while (!nodeStack.empty ())
-    {
-        SHAMapTreeNode* ourNode = nodeStack.top().first;
-        SHAMapTreeNode* otherNode = nodeStack.top().second;
-        nodeStack.pop ();
-
-        if (!ourNode || !otherNode)
+        // At most a leaf on either side, and they differ
+        if (entry.ours && entry.theirs)
         {
-            assert (false);
-            throw SHAMapMissingNode (type_, uint256 ());
-        }
+            std::shared_ptr<SHAMapItem> const& ours = entry.ours->peekItem ();
+            std::shared_ptr<SHAMapItem> const& theirs = entry.theirs->peekItem ();
 
-        if (ourNode->isLeaf () && otherNode->isLeaf ())
-        {
-            // two leaves
-            if (ourNode->peekItem()->getTag () == otherNode->peekItem()->getTag ())
+            if (ours->getTag () == theirs->getTag ())
             {
-                if (ourNode->peekItem()->peekData () != otherNode->peekItem()->peekData ())
-                {
-                    differences.insert (std::make_pair (ourNode->peekItem()->getTag (),
-                                                 DeltaRef (ourNode->peekItem (),
-                                                 otherNode->peekItem ())));
-                    if (--maxCount <= 0)
-                        return false;
-                }
+                if (!visitor (ours, theirs))
+                    return false;
             }
-            else
+            else if (ours->getTag () < theirs->getTag ())
             {
-                differences.insert (std::make_pair(ourNode->peekItem()->getTag (),
-                                                   DeltaRef(ourNode->peekItem(),
-                                                   std::shared_ptr<SHAMapItem> ())));
-                if (--maxCount <= 0)
+                if (!visitor (ours, none) || !visitor (none, theirs))
                     return false;
-
-                differences.insert(std::make_pair(otherNode->peekItem()->getTag (),
-                                                  DeltaRef(std::shared_ptr<SHAMapItem>(),
-                                                  otherNode->peekItem ())));
-                if (--maxCount <= 0)
+            }
+            else
+            {
+                if (!visitor (none, theirs) || !visitor (ours, none))
                     return false;
             }
         }
-        else if (ourNode->isInner () && otherNode->isLeaf ())
+        else if (entry.ours)
         {
-            if (!walkBranch (ourNode, otherNode->peekItem (),
-                    true, differences, maxCount))
+            if (!visitor (entry.ours->peekItem (), none))
                 return false;
         }
-        else if (ourNode->isLeaf () && otherNode->isInner ())
+        else if (!visitor (none, entry.theirs->peekItem ()))
         {
-            if (!otherMap->walkBranch (otherNode, ourNode->peekItem (),
-                                       false, differences, maxCount))
-                return false;
+            return false;
         }
-        else if (ourNode->isInner () && otherNode->isInner ())
+    }
+
+    return true;
+}
+
+bool SHAMap::visitDeltas (SHAMap const& other, DeltaVisitor const& visitor,
+    int threads) const
+{
+    // Brings the hashes of a modified map up to date
+    if (getHash () == other.getHash ())
+        return true;
+
+    DeltaStack branches;
+    DeltaEntry const root {root_, other.root_, 0};
+    std::atomic <bool> stop (false);
+
+    if (threads <= 0)
+        threads = std::max (1u, std::thread::hardware_concurrency ());
+
+    if (threads == 1 || !splitDelta (other, root, branches))
+    {
+        DeltaStack stack (1, root);
+        return visitDeltasBelow (other, stack, visitor, stop);
+    }
+
+    // Hand out the differing branches below the roots
+    std::atomic <bool> stopped (false);
+
+    parallelFor (f_.jobQueue (), jtWALK, "visitDeltas", branches.size (),
+        threads, [&](std::size_t i)
         {
-            for (int i = 0; i < 16; ++i)
-                if (ourNode->getChildHash (i) != otherNode->getChildHash (i))
+            if (stop)
+                return;
+
+            try
+            {
+                DeltaStack stack (1, branches[i]);
+                if (!visitDeltasBelow (other, stack, visitor, stop))
                 {
-                    if (otherNode->isEmptyBranch (i))
-                    {
-                        // We have a branch, the other tree does not
-                        SHAMapTreeNode* iNode = descendThrow (ourNode, i);
-                        if (!walkBranch (iNode,
-                                         std::shared_ptr<SHAMapItem> (), true,
-                                         differences, maxCount))
-                            return false;
-                    }
-                    else if (ourNode->isEmptyBranch (i))
-                    {
-                        // The other tree has a branch, we do not
-                        SHAMapTreeNode* iNode =
-                            otherMap->descendThrow(otherNode, i);
-                        if (!otherMap->walkBranch (iNode,
-                                                   std::shared_ptr<SHAMapItem>(),
-                                                   false, differences, maxCount))
-                            return false;
-                    }
-                    else // The two trees have different non-empty branches
-                        nodeStack.push ({descendThrow (ourNode, i),
-                                        otherMap->descendThrow (otherNode, i)});
+                    stopped = true;
+                    stop = true;
                 }
-        }
-        else
-            assert (false);
-    }
+            }
+            catch (...)
+            {
+                // Let the other branches finish early, parallelFor
+                // rethrows the first exception to the caller
+                stop = true;
+                throw;
+            }
+        });
 
-    return true;
+    return !stopped;
 }
 
 void SHAMap::walkMap (std::vector<SHAMapMissingNode>& missingNodes, int maxMissing) const
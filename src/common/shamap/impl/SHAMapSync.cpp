@@ -19,7 +19,12 @@
 
 #include <BeastConfig.h>
 #include <common/shamap/SHAMap.h>
+#include <common/core/ParallelFor.h>
 #include <data/nodestore/Database.h>
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace skywell {
 
@@ -107,6 +112,195 @@ void SHAMap::visitNodes(std::function<bool (SHAMapTreeNode&)> const& function) c
     }
 }
 
+void SHAMap::visitLeavesParallel (
+    std::function<void (std::shared_ptr<SHAMapItem> const& item)> const& leafFunction,
+        int threads) const
+{
+    visitNodesParallel (std::bind (visitLeavesHelper,
+            std::cref (leafFunction), std::placeholders::_1), threads);
+}
+
+// The reads queued for the missing children of one inner node
+struct SHAMap::ChildReads
+{
+    std::mutex mutex;
+    std::condition_variable cond;
+
+    // A bit for each branch whose read is still in flight
+    std::uint32_t pending = 0;
+
+    void done (std::uint32_t bit)
+    {
+        std::lock_guard <std::mutex> lock (mutex);
+        pending &= ~bit;
+        cond.notify_all ();
+    }
+
+    // Wait for a branch's read so that it isn't read a second time
+    void wait (int branch)
+    {
+        std::uint32_t const bit = 1u << branch;
+        std::unique_lock <std::mutex> lock (mutex);
+        cond.wait (lock, [&]{ return (pending & bit) == 0; });
+    }
+};
+
+std::shared_ptr<SHAMap::ChildReads>
+SHAMap::prefetchChildren (SHAMapTreeNode& node) const
+{
+    std::shared_ptr<ChildReads> reads;
+
+    if (!backed_)
+        return reads;
+
+    for (int branch = 0; branch < 16; ++branch)
+    {
+        if (node.isEmptyBranch (branch) || node.getChildPointer (branch))
+            continue;
+
+        uint256 const& hash = node.getChildHash (branch);
+        if (getCache (hash))
+            continue;
+
+        if (!reads)
+            reads = std::make_shared<ChildReads> ();
+
+        std::uint32_t const bit = 1u << branch;
+        {
+            std::lock_guard <std::mutex> lock (reads->mutex);
+            reads->pending |= bit;
+        }
+
+        // The read lands in the node store cache, where descendNoStore
+        // finds it once the callback has cleared the branch's bit
+        NodeObject::pointer obj;
+        auto const r = reads;
+        if (f_.db().asyncFetch (hash, obj, [r, bit] { r->done (bit); }))
+            reads->done (bit);
+    }
+
+    return reads;
+}
+
+bool SHAMap::visitBelow (std::shared_ptr<SHAMapTreeNode> node,
+    std::function<bool (SHAMapTreeNode&)> const& function,
+        std::atomic<bool> const& stop) const
+{
+    struct StackEntry
+    {
+        int pos;
+        std::shared_ptr<SHAMapTreeNode> node;
+        std::shared_ptr<ChildReads> reads;
+    };
+    std::stack <StackEntry, std::vector <StackEntry>> stack;
+
+    int pos = 0;
+    std::shared_ptr<ChildReads> reads = prefetchChildren (*node);
+
+    while (1)
+    {
+        while (pos < 16)
+        {
+            if (node->isEmptyBranch (pos))
+            {
+                ++pos;
+                continue;
+            }
+
+            if (stop)
+                return false;
+
+            if (reads)
+                reads->wait (pos);
+
+            std::shared_ptr<SHAMapTreeNode> child = descendNoStore (node, pos);
+            if (function (*child))
+                return true;
+
+            if (child->isLeaf ())
+            {
+                ++pos;
+                continue;
+            }
+
+            // If there are no more children, don't push this node
+            while ((pos != 15) && (node->isEmptyBranch (pos + 1)))
+                ++pos;
+
+            if (pos != 15)
+                stack.push ({pos + 1, std::move (node), std::move (reads)});
+
+            node = std::move (child);
+            pos = 0;
+            reads = prefetchChildren (*node);
+        }
+
+        if (stack.empty ())
+            return false;
+
+        pos = stack.top ().pos;
+        node = std::move (stack.top ().node);
+        reads = std::move (stack.top ().reads);
+        stack.pop ();
+    }
+}
+
+void SHAMap::visitNodesParallel (
+    std::function<bool (SHAMapTreeNode&)> const& function, int threads) const
+{
+    assert (root_->isValid ());
+
+    if (!root_ || root_->isEmpty ())
+        return;
+
+    if (function (*root_) || !root_->isInner ())
+        return;
+
+    // Visit the root's children here and hand out the inner ones
+    std::vector <std::shared_ptr<SHAMapTreeNode>> subtrees;
+    std::shared_ptr<ChildReads> const reads = prefetchChildren (*root_);
+    for (int branch = 0; branch < 16; ++branch)
+    {
+        if (root_->isEmptyBranch (branch))
+            continue;
+
+        if (reads)
+            reads->wait (branch);
+
+        std::shared_ptr<SHAMapTreeNode> child = descendNoStore (root_, branch);
+        if (function (*child))
+            return;
+
+        if (child->isInner ())
+            subtrees.push_back (std::move (child));
+    }
+
+    if (threads <= 0)
+        threads = std::max (1u, std::thread::hardware_concurrency ());
+
+    std::atomic <bool> stop (false);
+
+    parallelFor (f_.jobQueue (), jtWALK, "visitNodes", subtrees.size (),
+        threads, [&](std::size_t i)
+        {
+            if (stop)
+                return;
+
+            try
+            {
+                if (visitBelow (subtrees[i], function, stop))
+                    stop = true;
+            }
+            catch (...)
+            {
+                // Let the other subtrees finish early, parallelFor
+                // rethrows the first exception to the caller
+                stop = true;
+                throw;
+            }
+        });
+}
+
 /** Get a list of node IDs and hashes for nodes that are part of this SHAMap
     but not available locally.  The filter can hold alternate sources of
     nodes that are not permanently stored locally
@@ -0,0 +1,182 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <consensus/ConsensusTimings.h>
+#include <protocol/JsonFields.h>
+#include <cassert>
+
+namespace skywell {
+
+namespace {
+
+template <class Duration>
+beast::insight::Event::value_type
+toEventValue (Duration d)
+{
+    return std::chrono::duration_cast <
+        beast::insight::Event::value_type> (d);
+}
+
+Json::UInt
+toMicroseconds (ConsensusRound::duration d)
+{
+    return static_cast <Json::UInt> (d.count ());
+}
+
+} // namespace
+
+ConsensusRound::ConsensusRound ()
+    : ledgerSeq (0)
+    , publish (duration::zero ())
+    , transactions (0)
+    , accountNodes (0)
+    , transactionNodes (0)
+    , bytesWritten (0)
+{
+    phases.fill (duration::zero ());
+}
+
+//------------------------------------------------------------------------------
+
+ConsensusTrace::ConsensusTrace ()
+    : last_ (clock_type::now ())
+{
+}
+
+void
+ConsensusTrace::mark (ConsensusPhase phase)
+{
+    auto const now = clock_type::now ();
+    round_.phases[phase] += std::chrono::duration_cast <
+        ConsensusRound::duration> (now - last_);
+    last_ = now;
+}
+
+//------------------------------------------------------------------------------
+
+ConsensusTimings::ConsensusTimings (
+        beast::insight::Collector::ptr const& collector)
+    : collector_ (collector)
+    , roundEvent_ (collector->make_event ("round"))
+    , publishEvent_ (collector->make_event ("publish"))
+{
+    for (int i = 0; i < cpPHASE_COUNT; ++i)
+        phaseEvents_[i] = collector->make_event (
+            getName (static_cast <ConsensusPhase> (i)));
+}
+
+void
+ConsensusTimings::record (ConsensusRound const& round)
+{
+    ConsensusRound::duration total (ConsensusRound::duration::zero ());
+
+    for (int i = 0; i < cpPHASE_COUNT; ++i)
+    {
+        phaseEvents_[i].notify (toEventValue (round.phases[i]));
+        total += round.phases[i];
+    }
+
+    roundEvent_.notify (toEventValue (total));
+
+    std::lock_guard <std::mutex> lock (mutex_);
+
+    if (rounds_.size () >= ringSize)
+        rounds_.pop_front ();
+
+    rounds_.push_back (round);
+}
+
+void
+ConsensusTimings::onPublished (std::uint32_t ledgerSeq,
+    ConsensusRound::duration elapsed)
+{
+    publishEvent_.notify (toEventValue (elapsed));
+
+    std::lock_guard <std::mutex> lock (mutex_);
+
+    // Published ledgers are usually among the newest rounds
+    for (auto it = rounds_.rbegin (); it != rounds_.rend (); ++it)
+    {
+        if (it->ledgerSeq == ledgerSeq)
+        {
+            it->publish = elapsed;
+            break;
+        }
+    }
+}
+
+Json::Value
+ConsensusTimings::getJson (std::size_t limit) const
+{
+    Json::Value ret (Json::arrayValue);
+
+    std::lock_guard <std::mutex> lock (mutex_);
+
+    for (auto it = rounds_.rbegin ();
+        (it != rounds_.rend ()) && (ret.size () < limit); ++it)
+    {
+        Json::Value& entry = ret.append (Json::objectValue);
+
+        entry[jss::ledger_index] = it->ledgerSeq;
+        entry[jss::ledger_hash] = to_string (it->ledgerHash);
+
+        ConsensusRound::duration total (ConsensusRound::duration::zero ());
+        Json::Value& phases = (entry[jss::phases] = Json::objectValue);
+        for (int i = 0; i < cpPHASE_COUNT; ++i)
+        {
+            phases[getName (static_cast <ConsensusPhase> (i))] =
+                toMicroseconds (it->phases[i]);
+            total += it->phases[i];
+        }
+
+        entry[jss::total] = toMicroseconds (total);
+        entry[jss::publish] = toMicroseconds (it->publish);
+        entry[jss::transactions] = it->transactions;
+        entry[jss::account_nodes] = it->accountNodes;
+        entry[jss::transaction_nodes] = it->transactionNodes;
+        entry[jss::bytes_written] = static_cast <Json::UInt> (it->bytesWritten);
+    }
+
+    return ret;
+}
+
+char const*
+ConsensusTimings::getName (ConsensusPhase phase)
+{
+    switch (phase)
+    {
+    case cpOPEN:            return "open";
+    case cpESTABLISH:       return "establish";
+    case cpACCEPT_WAIT:     return "accept_wait";
+    case cpAPPLY:           return "apply";
+    case cpFLUSH:           return "flush";
+    case cpSTORE:           return "store";
+    case cpVALIDATE:        return "validate";
+    case cpBUILT:           return "built";
+    case cpOPEN_LEDGER:     return "open_ledger";
+    default:
+        break;
+    }
+
+    assert (false);
+    return "unknown";
+}
+
+} // skywell
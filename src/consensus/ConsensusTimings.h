@@ -0,0 +1,136 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef SKYWELL_APP_CONSENSUS_CONSENSUSTIMINGS_H_INCLUDED
+#define SKYWELL_APP_CONSENSUS_CONSENSUSTIMINGS_H_INCLUDED
+
+#include <beast/Insight.h>
+#include <common/base/base_uint.h>
+#include <common/json/json_value.h>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+namespace skywell {
+
+/** The steps of a consensus round, in the order they happen. */
+enum ConsensusPhase
+{
+    cpOPEN,             // From the previous close until we close
+    cpESTABLISH,        // From our close until we have consensus
+    cpACCEPT_WAIT,      // The accept job waits in the job queue
+    cpAPPLY,            // The consensus set is applied to the new ledger
+    cpFLUSH,            // Dirty nodes are written to the node store
+    cpSTORE,            // The ledger is stashed in the ledger master
+    cpVALIDATE,         // Our validation is built and sent
+    cpBUILT,            // The ledger master checks for a validated ledger
+    cpOPEN_LEDGER,      // The next open ledger is built
+
+    cpPHASE_COUNT
+};
+
+/** Timings and work counts for one consensus round. */
+struct ConsensusRound
+{
+    typedef std::chrono::microseconds duration;
+
+    ConsensusRound ();
+
+    std::uint32_t ledgerSeq;
+    uint256 ledgerHash;
+
+    std::array <duration, cpPHASE_COUNT> phases;
+
+    // Zero until the ledger is published
+    duration publish;
+
+    int transactions;
+    int accountNodes;
+    int transactionNodes;
+    std::size_t bytesWritten;
+};
+
+/** Records the phases of a consensus round as it runs.
+
+    Each call to mark closes the named phase at the current time. Marking
+    costs one clock read, so the tracer stays enabled in production.
+*/
+class ConsensusTrace
+{
+public:
+    typedef std::chrono::steady_clock clock_type;
+
+    ConsensusTrace ();
+
+    /** Attribute the time since the previous mark to a phase. */
+    void mark (ConsensusPhase phase);
+
+    ConsensusRound& round ()
+    {
+        return round_;
+    }
+
+private:
+    clock_type::time_point last_;
+    ConsensusRound round_;
+};
+
+/** Keeps the timings of the most recent consensus rounds.
+
+    Each phase also feeds an insight event in the "consensus" group.
+*/
+class ConsensusTimings
+{
+public:
+    // How many rounds are retained
+    static std::size_t const ringSize = 256;
+
+    explicit
+    ConsensusTimings (beast::insight::Collector::ptr const& collector);
+
+    /** Add a finished round, evicting the oldest if full. */
+    void record (ConsensusRound const& round);
+
+    /** Note how long a ledger took to publish to subscribers. */
+    void onPublished (std::uint32_t ledgerSeq,
+        ConsensusRound::duration elapsed);
+
+    /** Return the most recent rounds, newest first.
+        @param limit The largest number of rounds to return.
+    */
+    Json::Value getJson (std::size_t limit) const;
+
+    /** Return the name used for a phase in JSON and insight. */
+    static char const* getName (ConsensusPhase phase);
+
+private:
+    beast::insight::Collector::ptr collector_;
+    std::array <beast::insight::Event, cpPHASE_COUNT> phaseEvents_;
+    beast::insight::Event roundEvent_;
+    beast::insight::Event publishEvent_;
+
+    std::mutex mutable mutex_;
+    std::deque <ConsensusRound> rounds_;
+};
+
+} // skywell
+
+#endif
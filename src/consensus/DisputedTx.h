@@ -95,6 +95,10 @@ private:
 // make if the previous retry pass made changes
 #define LEDGER_RETRY_PASSES 1
 
+// How many transactions that reached the old open ledger during its
+// rebuild we catch up one by one before replaying the whole ledger
+#define LEDGER_MAX_CATCH_UP 1024
+
 } // skywell
 
 #endif
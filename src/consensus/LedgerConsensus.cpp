@@ -21,7 +21,9 @@
 #include <type_traits>
 #include <boost/lexical_cast.hpp>
 #include <consensus/DisputedTx.h>
+#include <consensus/ConsensusTimings.h>
 #include <consensus/LedgerConsensus.h>
+#include <consensus/PrepareTxSet.h>
 #include <ledger/InboundLedgers.h>
 #include <ledger/LedgerMaster.h>
 #include <ledger/LedgerTiming.h>
@@ -905,6 +907,7 @@ private:
     */
     void accept (std::shared_ptr<SHAMap> set)
     {
+        mTrace.mark (cpACCEPT_WAIT);
 
         {
             std::lock_guard<Application::MutexType> lock(getApp().getMasterMutex());
@@ -954,15 +957,26 @@ private:
         WriteLog (lsDEBUG, LedgerConsensus)
             << "Applying consensus set transactions to the"
             << " last closed ledger";
-        applyTransactions (set, newLCL, newLCL, retriableTransactions, false);
+        mTrace.round ().transactions = applyTransactions (
+            set, newLCL, newLCL, retriableTransactions, false);
         newLCL->updateSkipList ();
         newLCL->setClosed ();
+        mTrace.mark (cpAPPLY);
 
-        int asf = newLCL->peekAccountStateMap ()->flushDirty (hotACCOUNT_NODE, newLCL->getLedgerSeq());
-        int tmf = newLCL->peekTransactionMap ()->flushDirty (hotTRANSACTION_NODE, newLCL->getLedgerSeq());
+        // Both maps are written to the node store as a single group
+        NodeStore::Batch dirty;
+        int asf = newLCL->peekAccountStateMap ()->flushDirty (hotACCOUNT_NODE, newLCL->getLedgerSeq(), dirty);
+        int tmf = newLCL->peekTransactionMap ()->flushDirty (hotTRANSACTION_NODE, newLCL->getLedgerSeq(), dirty);
+        getApp().getNodeStore ().storeBatch (dirty);
 
         WriteLog (lsDEBUG, LedgerConsensus) << "Flushed " << asf << " account and " << tmf << "transaction nodes";
 
+        mTrace.round ().accountNodes = asf;
+        mTrace.round ().transactionNodes = tmf;
+        for (auto const& object : dirty)
+            mTrace.round ().bytesWritten += object->getData ().size ();
+        mTrace.mark (cpFLUSH);
+
         // Accept ledger
         newLCL->setAccepted (closeTime, mCloseResolution, closeTimeCorrect);
 
@@ -981,6 +995,7 @@ private:
         uint256 newLCLHash = newLCL->getHash ();
         // Tell directly connected peers that we have a new LCL
         statusChange (protocol::neACCEPTED_LEDGER, *newLCL);
+        mTrace.mark (cpSTORE);
 
         if (mValidating && !mConsensusFail)
         {
@@ -1020,8 +1035,11 @@ private:
             WriteLog (lsINFO, LedgerConsensus) << "CNF newLCL " << newLCLHash;
         }
 
+        mTrace.mark (cpVALIDATE);
+
         // See if we can accept a ledger as fully-validated
         getApp().getLedgerMaster().consensusBuilt (newLCL);
+        mTrace.mark (cpBUILT);
 
         // Build new open ledger
         Ledger::pointer newOL = std::make_shared<Ledger>(true, *newLCL);
@@ -1060,6 +1078,31 @@ private:
                 newOL, newLCL, retriableTransactions, true);
         }
 
+        // Rebuild the open ledger from a snapshot of the old one without
+        // holding the master lock, so submissions are not blocked while
+        // its transactions are replayed. Anything that arrives meanwhile
+        // still goes into the old open ledger and is caught up below.
+        std::shared_ptr<SHAMap> replayed;
+        {
+            std::lock_guard<Application::MutexType> lock(getApp().getMasterMutex());
+
+            replayed = getApp().getLedgerMaster().getCurrentLedger()
+                ->peekTransactionMap()->snapShot (false);
+        }
+
+        if (replayed->getHash().isNonZero ())
+        {
+            WriteLog (lsDEBUG, LedgerConsensus) << "Applying transactions from current open ledger";
+
+            applyTransactions (replayed, newOL, newLCL, retriableTransactions, true);
+        }
+
+        {
+            // Apply local transactions
+            TransactionEngine engine (newOL);
+            m_localTX.apply (engine);
+        }
+
         {
             auto lock = std::unique_lock<std::recursive_mutex>(getApp().getMasterMutex(), std::defer_lock);
             
@@ -1067,24 +1110,58 @@ private:
                 (getApp().getLedgerMaster ().peekMutex (), std::defer_lock);
             std::lock(lock, sl);
 
-            // Apply transactions from the old open ledger
+            // Catch up with transactions that reached the old open
+            // ledger while we were replaying the snapshot
             Ledger::pointer oldOL = getApp().getLedgerMaster().getCurrentLedger();
-            if (oldOL->peekTransactionMap()->getHash().isNonZero ())
+            std::shared_ptr<SHAMap> const& current = oldOL->peekTransactionMap ();
+            SHAMap::Delta arrivals;
+
+            if (current->compare (replayed, arrivals, LEDGER_MAX_CATCH_UP))
             {
-                WriteLog (lsDEBUG, LedgerConsensus) << "Applying transactions from current open ledger";
+                for (auto const& arrival : arrivals)
+                {
+                    if (!arrival.second.first)
+                        continue;
 
-                applyTransactions (oldOL->peekTransactionMap (),
-                                   newOL, newLCL, retriableTransactions, true);
+                    try
+                    {
+                        SerialIter sit (arrival.second.first->peekSerializer ());
+                        retriableTransactions.push_back (
+                            std::make_shared<STTx> (sit));
+                    }
+                    catch (...)
+                    {
+                        WriteLog (lsWARNING, LedgerConsensus) << "  Throws";
+                    }
+                }
+
+                if (!retriableTransactions.empty ())
+                {
+                    WriteLog (lsDEBUG, LedgerConsensus) << "Catching up "
+                        << arrivals.size () << " open ledger transactions";
+
+                    applyTransactions (std::shared_ptr<SHAMap>(),
+                        newOL, newLCL, retriableTransactions, true);
+                }
             }
+            else
+            {
+                // Too much changed; replay the whole map. Transactions
+                // already in the new open ledger are rejected as duplicates.
+                WriteLog (lsDEBUG, LedgerConsensus) << "Replaying current open ledger";
 
-            // Apply local transactions
-            TransactionEngine engine (newOL);
-            m_localTX.apply (engine);
+                applyTransactions (current, newOL, newLCL, retriableTransactions, true);
+            }
 
             // We have a new Last Closed Ledger and new Open Ledger
             getApp().getLedgerMaster ().pushLedger (newLCL, newOL);
         }
 
+        mTrace.mark (cpOPEN_LEDGER);
+        mTrace.round ().ledgerSeq = newLCL->getLedgerSeq ();
+        mTrace.round ().ledgerHash = newLCL->getHash ();
+        getApp().getConsensusTimings ().record (mTrace.round ());
+
         mNewLedgerHash = newLCL->getHash ();
         mState = lcsACCEPTED;
 
@@ -1669,6 +1746,8 @@ private:
     */
     void closeLedger ()
     {
+        mTrace.mark (cpOPEN);
+
         checkOurValidation ();
 
         mState              = lcsESTABLISH;
@@ -1754,6 +1833,8 @@ private:
 
         getApp().getOPs ().newLCL (mPeerPositions.size (), mCurrentMSeconds, mNewLedgerHash);
 
+        mTrace.mark (cpESTABLISH);
+
         if (synchronous)
         {
             accept (consensusSet);
@@ -1811,6 +1892,9 @@ private:
 
     std::chrono::steady_clock::time_point  mConsensusStartTime;
 
+    // Per-phase timings of this round
+    ConsensusTrace mTrace;
+
     int mPreviousProposers;
     int mPreviousMSeconds;
 
@@ -1928,43 +2012,45 @@ int applyTransaction (TransactionEngine& engine,
                                messages (typically new last closed ledger).
   @param retriableTransactions collect failed transactions in this set
   @param openLgr               true if applyLedger is open, else false.
+  @return The number of transactions applied.
 */
-void applyTransactions (std::shared_ptr<SHAMap> const& set,
-                        Ledger::ref applyLedger, 
-                        Ledger::ref checkLedger,
-                        CanonicalTXSet& retriableTransactions,
-                        bool openLgr)
+int applyTransactions (std::shared_ptr<SHAMap> const& set,
+                       Ledger::ref applyLedger, 
+                       Ledger::ref checkLedger,
+                       CanonicalTXSet& retriableTransactions,
+                       bool openLgr)
 {
     TransactionEngine engine (applyLedger);
+    int applied = 0;
 
     if (set)
     {
-        for (std::shared_ptr<SHAMapItem> item = set->peekFirstItem (); 
-            !!item;
-            item = set->peekNextItem (item->getTag ()))
+        for (auto const& txn : prepareTxSet (set, applyLedger, checkLedger))
         {
-            // If the checkLedger doesn't have the transaction
-            if (!checkLedger->hasTransaction (item->getTag ()))
-            {
-                // Then try to apply the transaction to applyLedger
-                WriteLog (lsDEBUG, LedgerConsensus) << "Processing candidate transaction: " << item->getTag ();
+            // Then try to apply the transaction to applyLedger
+            WriteLog (lsDEBUG, LedgerConsensus) << "Processing candidate transaction: " << txn->getTransactionID ();
 
-                try
-                {
-                    SerialIter    sit (item->peekSerializer ());
-                    STTx::pointer txn = std::make_shared<STTx>(sit);
-                    if (applyTransaction (engine, txn, openLgr, true) == LedgerConsensusImp::resultRetry)
-                    {
-                        // On failure, stash the failed transaction for
-                        // later retry.
-                        retriableTransactions.push_back (txn);
-                    }
-                }
-                catch (...)
+            try
+            {
+                switch (applyTransaction (engine, txn, openLgr, true))
                 {
-                    WriteLog (lsWARNING, LedgerConsensus) << "  Throws";
+                case LedgerConsensusImp::resultSuccess:
+                    ++applied;
+                    break;
+
+                case LedgerConsensusImp::resultFail:
+                    break;
+
+                case LedgerConsensusImp::resultRetry:
+                    // On failure, stash the failed transaction for
+                    // later retry.
+                    retriableTransactions.push_back (txn);
                 }
             }
+            catch (...)
+            {
+                WriteLog (lsWARNING, LedgerConsensus) << "  Throws";
+            }
         }
     }
 
@@ -1989,6 +2075,7 @@ void applyTransactions (std::shared_ptr<SHAMap> const& set,
                 case LedgerConsensusImp::resultSuccess:
                     it = retriableTransactions.erase (it);
                     ++changes;
+                    ++applied;
                     break;
 
                 case LedgerConsensusImp::resultFail:
@@ -2015,7 +2102,7 @@ void applyTransactions (std::shared_ptr<SHAMap> const& set,
 
         // A non-retry pass made no changes
         if (!changes && !certainRetry)
-            return;
+            return applied;
 
         // Stop retriable passes
         if ((!changes) || (pass >= LEDGER_RETRY_PASSES))
@@ -2025,6 +2112,8 @@ void applyTransactions (std::shared_ptr<SHAMap> const& set,
     // If there are any transactions left, we must have
     // tried them in at least one final pass
     assert (retriableTransactions.empty() || !certainRetry);
+
+    return applied;
 }
 
 } // skywell
@@ -81,7 +81,7 @@ make_LedgerConsensus (LocalTxs& localtx,
                       std::uint32_t closeTime, 
                       FeeVote& feeVote);
 
-void
+int
 applyTransactions(std::shared_ptr<SHAMap> const& set, 
                   Ledger::ref applyLedger,
                   Ledger::ref checkLedger,
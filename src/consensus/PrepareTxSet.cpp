@@ -0,0 +1,164 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <consensus/PrepareTxSet.h>
+#include <main/Application.h>
+#include <common/misc/IHashRouter.h>
+#include <common/base/Log.h>
+#include <common/core/JobQueue.h>
+#include <common/core/ParallelFor.h>
+#include <protocol/Indexes.h>
+#include <algorithm>
+
+namespace skywell {
+
+namespace {
+
+// Below this many transactions the jobs cost more than they save
+std::size_t const parallelThreshold = 32;
+
+// The most jobs used for one set
+std::size_t const maxJobs = 8;
+
+// The ledger entries a transaction is expected to read and write.
+// The fee account is left out: every transaction touches it.
+std::vector <uint256>
+getFootprint (STTx const& txn)
+{
+    std::vector <uint256> keys;
+
+    Account const source = txn.getSourceAccount ().getAccountID ();
+    keys.push_back (getAccountRootIndex (source));
+
+    if (txn.getTxnType () != ttPAYMENT)
+        return keys;
+
+    Account const destination = txn.getFieldAccount160 (sfDestination);
+    keys.push_back (getAccountRootIndex (destination));
+
+    auto const addLine = [&keys](Account const& holder, STAmount const& amount)
+    {
+        if (amount.isNative ())
+            return;
+
+        keys.push_back (getAccountRootIndex (amount.getIssuer ()));
+
+        if (holder != amount.getIssuer ())
+            keys.push_back (getSkywellStateIndex (holder, amount.issue ()));
+    };
+
+    addLine (destination, txn.getFieldAmount (sfAmount));
+    addLine (source, txn.isFieldPresent (sfSendMax)
+        ? txn.getFieldAmount (sfSendMax) : txn.getFieldAmount (sfAmount));
+
+    return keys;
+}
+
+} // namespace
+
+PreparedTxSet
+prepareTxSet (std::shared_ptr<SHAMap> const& set,
+    Ledger::ref applyLedger, Ledger::ref checkLedger)
+{
+    std::vector <std::shared_ptr<SHAMapItem>> items;
+
+    for (std::shared_ptr<SHAMapItem> item = set->peekFirstItem ();
+        !!item;
+        item = set->peekNextItem (item->getTag ()))
+    {
+        if (!checkLedger->hasTransaction (item->getTag ()))
+            items.push_back (item);
+    }
+
+    PreparedTxSet txns (items.size ());
+
+    auto const deserialize = [&](std::size_t i)
+    {
+        try
+        {
+            SerialIter sit (items[i]->peekSerializer ());
+            txns[i] = std::make_shared<STTx> (sit);
+        }
+        catch (...)
+        {
+            WriteLog (lsWARNING, LedgerConsensus) << "  Throws";
+        }
+    };
+
+    if (items.size () < parallelThreshold)
+    {
+        for (std::size_t i = 0; i < items.size (); ++i)
+            deserialize (i);
+    }
+    else
+    {
+        JobQueue& jobQueue = getApp().getJobQueue ();
+        parallelFor (jobQueue, jtACCEPT, "prepareTxSet",
+            items.size (), maxJobs, deserialize);
+
+        // Reads only. Unsharing a fresh ledger's map is cheap.
+        auto const snapshot = std::make_shared<Ledger> (*applyLedger, false);
+        IHashRouter& router = getApp().getHashRouter ();
+
+        parallelFor (jobQueue, jtACCEPT, "prepareTxSet",
+            txns.size (), maxJobs, [&](std::size_t i)
+        {
+            if (!txns[i])
+                return;
+
+            STTx const& txn = *txns[i];
+            uint256 const txID = txn.getTransactionID ();
+
+            try
+            {
+                if (!txn.isKnownGood () && !txn.isKnownBad () &&
+                    ((router.getFlags (txID) & SF_SIGGOOD) != SF_SIGGOOD))
+                {
+                    if (txn.checkSign ())
+                    {
+                        txn.setGood ();
+                        router.setFlag (txID, SF_SIGGOOD);
+                    }
+                    else
+                    {
+                        txn.setBad ();
+                        router.setFlag (txID, SF_BAD);
+                    }
+                }
+
+                for (auto const& key : getFootprint (txn))
+                    snapshot->getSLEi (key);
+            }
+            catch (...)
+            {
+                // Left for the engine to report
+            }
+        });
+
+        WriteLog (lsDEBUG, LedgerConsensus) << "Prepared "
+            << txns.size () << " transactions";
+    }
+
+    txns.erase (std::remove (txns.begin (), txns.end (), nullptr), txns.end ());
+
+    return txns;
+}
+
+} // skywell
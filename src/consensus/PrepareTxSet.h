@@ -0,0 +1,56 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef SKYWELL_APP_CONSENSUS_PREPARETXSET_H_INCLUDED
+#define SKYWELL_APP_CONSENSUS_PREPARETXSET_H_INCLUDED
+
+#include <ledger/Ledger.h>
+#include <protocol/STTx.h>
+#include <common/shamap/SHAMap.h>
+#include <vector>
+
+namespace skywell {
+
+/** Transactions from a set that still have to be applied, in set order. */
+typedef std::vector <STTx::pointer> PreparedTxSet;
+
+/** Prepare the transactions of a set for serial application to a ledger.
+
+    Transactions already in checkLedger are skipped and the rest are
+    deserialized. Jobs then check signatures not already known to be good
+    and load the account roots and trust lines each transaction will read
+    from an immutable snapshot of applyLedger, so the apply finds them
+    cached.
+
+    Only order-independent work is done here. Every transaction also pays
+    its fee into the shared fee account, so the apply itself remains serial
+    and the resulting ledger is the same as without this step.
+
+    @param set The transaction set.
+    @param applyLedger The ledger the transactions will be applied to.
+    @param checkLedger Transactions already in this ledger are skipped.
+    @return The transactions, without those which failed to deserialize.
+*/
+PreparedTxSet
+prepareTxSet (std::shared_ptr<SHAMap> const& set,
+    Ledger::ref applyLedger, Ledger::ref checkLedger);
+
+} // skywell
+
+#endif
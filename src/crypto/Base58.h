@@ -33,6 +33,7 @@
 #define SKYWELL_CRYPTO_BASE58_H_INCLUDED
 
 #include <common/base/Blob.h>
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <iterator>
@@ -77,7 +78,7 @@ public:
             { return to_char (digit); }
 
         int from_char (char c) const
-            { return m_inverse [c]; }
+            { return m_inverse [static_cast <unsigned char> (c)]; }
 
     private:
         std::string const m_chars;
@@ -87,41 +88,22 @@ public:
     static Alphabet const& getBitcoinAlphabet ();
     static Alphabet const& getSkywellAlphabet ();
 
+    /** Encode little endian bytes which end in a zero pad byte. */
     static std::string raw_encode (unsigned char const* begin,
         unsigned char const* end, Alphabet const& alphabet);
 
     static void fourbyte_hash256 (void* out, void const* in, std::size_t bytes);
 
+    /** Encode big endian bytes, optionally followed by a four byte check. */
+    static std::string encode (unsigned char const* begin,
+        unsigned char const* end, Alphabet const& alphabet, bool withCheck);
+
     template <class InputIt>
     static std::string encode (InputIt first, InputIt last,
         Alphabet const& alphabet, bool withCheck)
     {
-        typedef typename std::iterator_traits<InputIt>::value_type value_type;
-        std::vector <typename std::remove_const <value_type>::type> v;
-        std::size_t const size (std::distance (first, last));
-        if (withCheck)
-        {
-            v.reserve (size + 1 + 4);
-            v.insert (v.begin(), first, last);
-            unsigned char hash [4];
-            fourbyte_hash256 (hash, &v.front(), v.size());
-            v.resize (0);
-            // Place the hash reversed in the front
-            std::copy (std::reverse_iterator <unsigned char const*> (hash+4),
-                       std::reverse_iterator <unsigned char const*> (hash),
-                       std::back_inserter (v));
-        }
-        else
-        {
-            v.reserve (size + 1);
-        }
-        // Append input little endian
-        std::copy (std::reverse_iterator <InputIt> (last),
-                   std::reverse_iterator <InputIt> (first),
-                   std::back_inserter (v));
-        // Pad zero to make the BIGNUM positive
-        v.push_back (0);
-        return raw_encode (&v.front(), &v.back()+1, alphabet);
+        return encodeRange (first, last, alphabet, withCheck,
+            std::is_pointer <InputIt> ());
     }
 
     template <class Container>
@@ -154,6 +136,36 @@ public:
     static bool decode (std::string const& str, Blob& vchRet);
     static bool decodeWithCheck (const char* psz, Blob& vchRet, Alphabet const& alphabet = getSkywellAlphabet());
     static bool decodeWithCheck (std::string const& str, Blob& vchRet, Alphabet const& alphabet = getSkywellAlphabet());
+
+private:
+    // Bytes already in memory are encoded where they are
+    template <class Pointer>
+    static std::string encodeRange (Pointer first, Pointer last,
+        Alphabet const& alphabet, bool withCheck, std::true_type)
+    {
+        static_assert (sizeof (*first) == 1, "Base58 encodes bytes");
+        auto const begin = reinterpret_cast <unsigned char const*> (first);
+        return encode (begin, begin + (last - first), alphabet, withCheck);
+    }
+
+    // Other ranges are gathered on the stack when they are key sized
+    template <class InputIt>
+    static std::string encodeRange (InputIt first, InputIt last,
+        Alphabet const& alphabet, bool withCheck, std::false_type)
+    {
+        std::size_t const size (std::distance (first, last));
+
+        unsigned char small[64];
+        if (size <= sizeof (small))
+        {
+            std::copy (first, last, small);
+            unsigned char const* const begin = small;
+            return encode (begin, begin + size, alphabet, withCheck);
+        }
+
+        Blob const v (first, last);
+        return encode (v.data (), v.data () + v.size (), alphabet, withCheck);
+    }
 };
 
 }
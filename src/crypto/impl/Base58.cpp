@@ -19,10 +19,11 @@
 
 #include <BeastConfig.h>
 #include <crypto/Base58.h>
-#include <crypto/CAutoBN_CTX.h>
-#include <crypto/CBigNum.h>
+#include <common/base/base_uint.h>
 #include <openssl/sha.h>
-#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <string>
 
 // Copyright (c) 2009-2010 Satoshi Nakamoto
@@ -66,93 +67,221 @@ Base58::Alphabet const& Base58::getSkywellAlphabet ()
     return alphabet;
 }
 
-std::string Base58::raw_encode (unsigned char const* begin,
-    unsigned char const* end, Alphabet const& alphabet)
+namespace {
+
+// Five base 58 digits fit in a 32 bit limb
+std::uint32_t const limbBase = 58 * 58 * 58 * 58 * 58;
+int const limbDigits = 5;
+
+/** A number as little endian 32 bit limbs.
+    Small numbers, which is all of keys and addresses, stay on the stack.
+*/
+class Limbs
 {
-    CAutoBN_CTX pctx;
-    CBigNum bn58 = 58;
-    CBigNum bn0 = 0;
+public:
+    explicit Limbs (std::size_t count)
+        : data_ (stack_)
+    {
+        if (count > sizeof (stack_) / sizeof (stack_[0]))
+        {
+            heap_.resize (count);
+            data_ = heap_.data ();
+        }
+    }
 
-    // Convert little endian data to bignum
-    CBigNum bn (begin, end);
-    std::size_t const size (std::distance (begin, end));
+    std::uint32_t& operator[] (std::size_t i)
+    {
+        return data_[i];
+    }
 
-    // Convert bignum to std::string
-    std::string str;
-    // Expected size increase from base58 conversion is approximately 137%
-    // use 138% to be safe
-    str.reserve (size * 138 / 100 + 1);
-    CBigNum dv;
-    CBigNum rem;
+private:
+    std::uint32_t stack_[32];
+    std::vector <std::uint32_t> heap_;
+    std::uint32_t* data_;
+};
+
+// Encode big endian bytes, each leading zero byte becoming a zero digit
+template <class Iterator>
+std::string encodeBigEndian (Iterator first, Iterator last,
+    Base58::Alphabet const& alphabet)
+{
+    std::size_t zeros = 0;
+    for (; first != last && *first == 0; ++first)
+        ++zeros;
 
-    while (bn > bn0)
+    // Each limb holds more than three bytes
+    Limbs limbs (std::distance (first, last) / 3 + 2);
+    std::size_t used = 0;
+
+    while (first != last)
     {
-        if (!BN_div (&dv, &rem, &bn, &bn58, pctx))
-            throw std::runtime_error ("EncodeBase58 : BN_div failed");
+        // Shift in up to four bytes at a time
+        std::uint64_t carry = 0;
+        int bits = 0;
+        for (; bits < 32 && first != last; bits += 8, ++first)
+            carry = (carry << 8) | *first;
 
-        bn = dv;
-        unsigned int c = rem.getuint ();
-        str += alphabet [c];
+        for (std::size_t i = 0; i < used; ++i)
+        {
+            std::uint64_t const x =
+                (static_cast <std::uint64_t> (limbs[i]) << bits) + carry;
+            limbs[i] = static_cast <std::uint32_t> (x % limbBase);
+            carry = x / limbBase;
+        }
+
+        while (carry != 0)
+        {
+            limbs[used++] = static_cast <std::uint32_t> (carry % limbBase);
+            carry /= limbBase;
+        }
     }
 
-    for (const unsigned char* p = end-2; p >= begin && *p == 0; p--)
-        str += alphabet [0];
+    std::string str;
+    str.reserve (zeros + used * limbDigits);
+    str.assign (zeros, alphabet[0]);
+
+    for (std::size_t i = used; i-- != 0;)
+    {
+        char digits[limbDigits];
+        std::uint32_t limb = limbs[i];
+        for (int j = limbDigits; j-- != 0;)
+        {
+            digits[j] = alphabet[limb % 58];
+            limb /= 58;
+        }
+
+        // The top limb has no leading zero digits
+        int skip = 0;
+        if (i + 1 == used)
+        {
+            while (digits[skip] == alphabet[0])
+                ++skip;
+        }
+
+        str.append (digits + skip, digits + limbDigits);
+    }
 
-    // Convert little endian std::string to big endian
-    reverse (str.begin (), str.end ());
     return str;
 }
 
-//------------------------------------------------------------------------------
-
-bool Base58::raw_decode (char const* first, char const* last, void* dest,
-    std::size_t size, bool checked, Alphabet const& alphabet)
+/** Decode base 58 digits into limbs of 32 bits.
+    @return `false` if a character is not in the alphabet.
+*/
+bool decodeLimbs (char const* first, char const* last,
+    Base58::Alphabet const& alphabet, Limbs& limbs, std::size_t& used)
 {
-    CAutoBN_CTX pctx;
-    CBigNum bn58 = 58;
-    CBigNum bn = 0;
-    CBigNum bnChar;
+    used = 0;
 
-    // Convert big endian string to bignum
-    for (char const* p = first; p != last; ++p)
+    while (first != last)
     {
-        int i (alphabet.from_char (*p));
-        if (i == -1)
-            return false;
-        bnChar.setuint ((unsigned int) i);
+        // Shift in up to five digits at a time
+        std::uint64_t carry = 0;
+        std::uint64_t scale = 1;
+        for (int n = 0; n < limbDigits && first != last; ++n, ++first)
+        {
+            int const digit = alphabet.from_char (*first);
+            if (digit == -1)
+                return false;
+            carry = carry * 58 + digit;
+            scale *= 58;
+        }
 
-        int const success (BN_mul (&bn, &bn, &bn58, pctx));
+        for (std::size_t i = 0; i < used; ++i)
+        {
+            std::uint64_t const x = limbs[i] * scale + carry;
+            limbs[i] = static_cast <std::uint32_t> (x);
+            carry = x >> 32;
+        }
+
+        if (carry != 0)
+            limbs[used++] = static_cast <std::uint32_t> (carry);
+    }
 
-        assert (success);
-        (void) success;
+    return true;
+}
 
-        bn += bnChar;
+// Bytes needed for the value held in the limbs
+std::size_t byteCount (Limbs& limbs, std::size_t used)
+{
+    if (used == 0)
+        return 0;
+
+    std::size_t bytes = 4 * used;
+    for (std::uint32_t top = limbs[used - 1]; (top >> 24) == 0; top <<= 8)
+        --bytes;
+    return bytes;
+}
+
+// Write the low `bytes` bytes of the value big endian
+void storeBigEndian (Limbs& limbs, std::size_t bytes, unsigned char* out)
+{
+    for (std::size_t i = 0; i < bytes; ++i)
+        out[bytes - 1 - i] = static_cast <unsigned char> (
+            limbs[i / 4] >> (8 * (i % 4)));
+}
+
+std::size_t leadingZeros (char const* first, char const* last,
+    Base58::Alphabet const& alphabet)
+{
+    return std::find_if (first, last,
+        [&alphabet](char c) { return c != alphabet[0]; }) - first;
+}
+
+}
+
+std::string Base58::raw_encode (unsigned char const* begin,
+    unsigned char const* end, Alphabet const& alphabet)
+{
+    assert (begin != end && end[-1] == 0);
+
+    // Skip the pad byte and read the rest most significant first
+    using reverse = std::reverse_iterator <unsigned char const*>;
+    return encodeBigEndian (reverse (end - 1), reverse (begin), alphabet);
+}
+
+std::string Base58::encode (unsigned char const* begin,
+    unsigned char const* end, Alphabet const& alphabet, bool withCheck)
+{
+    if (!withCheck)
+        return encodeBigEndian (begin, end, alphabet);
+
+    std::size_t const size (std::distance (begin, end));
+
+    unsigned char small[64];
+    Blob large;
+    unsigned char* v = small;
+    if (size + 4 > sizeof (small))
+    {
+        large.resize (size + 4);
+        v = large.data ();
     }
 
-    // Get bignum as little endian data
-    Blob vchTmp = bn.getvch ();
+    std::copy (begin, end, v);
+    fourbyte_hash256 (v + size, v, size);
+    return encodeBigEndian (v, v + size + 4, alphabet);
+}
 
-    // Trim off sign byte if present
-    if (vchTmp.size () >= 2 && vchTmp.end ()[-1] == 0 && vchTmp.end ()[-2] >= 0x80)
-        vchTmp.erase (vchTmp.end () - 1);
+//------------------------------------------------------------------------------
 
-    char* const out (static_cast <char*> (dest));
+bool Base58::raw_decode (char const* first, char const* last, void* dest,
+    std::size_t size, bool checked, Alphabet const& alphabet)
+{
+    Limbs limbs (std::distance (first, last) / limbDigits + 2);
+    std::size_t used;
+    if (!decodeLimbs (first, last, alphabet, limbs, used))
+        return false;
 
-    // Count leading zeros
-    int nLeadingZeros = 0;
-    for (char const* p = first; p!=last && *p==alphabet[0]; p++)
-        nLeadingZeros++;
+    unsigned char* const out (static_cast <unsigned char*> (dest));
+
+    std::size_t const zeros = leadingZeros (first, last, alphabet);
+    std::size_t const bytes = byteCount (limbs, used);
 
     // Verify that the size is correct
-    if (vchTmp.size() + nLeadingZeros != size)
+    if (zeros + bytes != size)
         return false;
 
-    // Fill the leading zeros
-    memset (out, 0, nLeadingZeros);
-
-    // Copy little endian data to big endian
-    std::reverse_copy (vchTmp.begin (), vchTmp.end (),
-        out + nLeadingZeros);
+    memset (out, 0, zeros);
+    storeBigEndian (limbs, bytes, out + zeros);
 
     if (checked)
     {
@@ -167,59 +296,32 @@ bool Base58::raw_decode (char const* first, char const* last, void* dest,
 
 bool Base58::decode (const char* psz, Blob& vchRet, Alphabet const& alphabet)
 {
-    CAutoBN_CTX pctx;
     vchRet.clear ();
-    CBigNum bn58 = 58;
-    CBigNum bn = 0;
-    CBigNum bnChar;
 
     while (isspace (*psz))
         psz++;
 
-    // Convert big endian string to bignum
-    for (const char* p = psz; *p; p++)
-    {
-        //  TODO Make this use the inverse table!
-        //             Or better yet ditch this and call raw_decode
-        //
-        const char* p1 = strchr (alphabet.chars(), *p);
-
-        if (p1 == nullptr)
-        {
-            while (isspace (*p))
-                p++;
-
-            if (*p != '\0')
-                return false;
-
-            break;
-        }
-
-        bnChar.setuint (p1 - alphabet.chars());
-
-        if (!BN_mul (&bn, &bn, &bn58, pctx))
-            throw std::runtime_error ("DecodeBase58 : BN_mul failed");
+    // The digits end at the first character not in the alphabet,
+    // which may only be followed by whitespace
+    char const* last = psz;
+    while (*last != '\0' && alphabet.from_char (*last) != -1)
+        last++;
 
-        bn += bnChar;
+    for (char const* p = last; *p != '\0'; p++)
+    {
+        if (!isspace (*p))
+            return false;
     }
 
-    // Get bignum as little endian data
-    Blob vchTmp = bn.getvch ();
-
-    // Trim off sign byte if present
-    if (vchTmp.size () >= 2 && vchTmp.end ()[-1] == 0 && vchTmp.end ()[-2] >= 0x80)
-        vchTmp.erase (vchTmp.end () - 1);
-
-    // Restore leading zeros
-    int nLeadingZeros = 0;
-
-    for (const char* p = psz; *p == alphabet.chars()[0]; p++)
-        nLeadingZeros++;
+    Limbs limbs (std::distance (psz, last) / limbDigits + 2);
+    std::size_t used;
+    decodeLimbs (psz, last, alphabet, limbs, used);
 
-    vchRet.assign (nLeadingZeros + vchTmp.size (), 0);
+    std::size_t const zeros = leadingZeros (psz, last, alphabet);
+    std::size_t const bytes = byteCount (limbs, used);
 
-    // Convert little endian data to big endian
-    std::reverse_copy (vchTmp.begin (), vchTmp.end (), vchRet.end () - vchTmp.size ());
+    vchRet.assign (zeros + bytes, 0);
+    storeBigEndian (limbs, bytes, vchRet.data () + zeros);
     return true;
 }
 
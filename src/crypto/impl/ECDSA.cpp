@@ -30,7 +30,12 @@
 #include <openssl/ec.h>
 #include <openssl/ecdsa.h>
 #include <openssl/hmac.h>
+#include <common/base/UnorderedContainers.h>
+#include <algorithm>
+#include <array>
 #include <cstdint>
+#include <memory>
+#include <mutex>
 
 namespace skywell  {
 
@@ -69,9 +74,103 @@ static bool ECDSAVerify (uint256 const& hash, std::uint8_t const* sig, size_t si
     return ECDSA_verify (0, hash.begin(), hash.size(), sig, sigLen, key) > 0;
 }
 
-static bool ECDSAVerify (uint256 const& hash, Blob const& sig, const openssl::ec_key& key)
+namespace {
+
+// Decoded keys held by each generation of the cache
+std::size_t const keyCacheSize = 512;
+
+/** Public keys decoded and ready to verify with.
+
+    Decoding a compressed key means recovering the point, which costs a
+    good fraction of a verification. Validators sign every proposal and
+    validation with the same key, so the decoded form is kept, in two
+    generations like the account ID cache. Only compressed keys are
+    cached, so a lookup can copy the key into a fixed size array instead
+    of allocating.
+
+    A decoded key is never modified once it is shared, since OpenSSL
+    only reads it while verifying.
+*/
+class PublicKeyCache
 {
-    return ECDSAVerify (hash, sig.data(), sig.size(), (EC_KEY*) key.get());
+public:
+    using Key = std::shared_ptr <EC_KEY>;
+
+    Key
+    get (std::uint8_t const* data, std::size_t size)
+    {
+        if (size != std::tuple_size <KeyID>::value)
+            return decode (data, size);
+
+        KeyID id;
+        std::copy (data, data + size, id.begin ());
+
+        {
+            std::lock_guard <std::mutex> lock (mutex_);
+
+            Key const* const found = find (id);
+            if (found != nullptr)
+                return *found;
+        }
+
+        Key key = decode (data, size);
+        if (!key)
+            return key;
+
+        std::lock_guard <std::mutex> lock (mutex_);
+        insert (id, key);
+        return key;
+    }
+
+private:
+    using KeyID = std::array <std::uint8_t, 33>;
+
+    // Returns the key in the fresh generation, moving it there if needed
+    Key const*
+    find (KeyID const& id)
+    {
+        auto it = fresh_.find (id);
+        if (it != fresh_.end ())
+            return &it->second;
+
+        auto const old = stale_.find (id);
+        if (old == stale_.end ())
+            return nullptr;
+
+        Key const key = std::move (old->second);
+        stale_.erase (old);
+        return &insert (id, key);
+    }
+
+    Key const&
+    insert (KeyID const& id, Key const& key)
+    {
+        if (fresh_.size () >= keyCacheSize)
+        {
+            stale_ = std::move (fresh_);
+            fresh_.clear ();
+        }
+        return fresh_[id] = key;
+    }
+
+    static
+    Key
+    decode (std::uint8_t const* data, std::size_t size)
+    {
+        ec_key decoded = ECDSAPublicKey (data, size);
+        if (!decoded.valid ())
+            return nullptr;
+
+        return Key ((EC_KEY*) decoded.release (), EC_KEY_free);
+    }
+
+    std::mutex mutex_;
+    hash_map <KeyID, Key> fresh_;
+    hash_map <KeyID, Key> stale_;
+};
+
+PublicKeyCache publicKeyCache;
+
 }
 
 bool ECDSAVerify (uint256 const& hash,
@@ -79,7 +178,11 @@ bool ECDSAVerify (uint256 const& hash,
                   std::uint8_t const* key_data,
                   std::size_t key_size)
 {
-    return ECDSAVerify (hash, sig, ECDSAPublicKey (key_data, key_size));
+    auto const key = publicKeyCache.get (key_data, key_size);
+    if (!key)
+        return false;
+
+    return ECDSAVerify (hash, sig.data(), sig.size(), key.get());
 }
 
 } // skywell
@@ -63,6 +63,7 @@ ec_key ECDSAPrivateKey (uint256 const& serialized)
     if (! ok)
     {
         EC_KEY_free (key);
+        key = nullptr;
     }
 
     return ec_key::acquire ((ec_key::pointer_t) key);
@@ -79,6 +80,7 @@ ec_key ECDSAPublicKey (std::uint8_t const* data, std::size_t size)
     else
     {
         EC_KEY_free (key);
+        key = nullptr;
     }
 
     return ec_key::acquire ((ec_key::pointer_t) key);
@@ -0,0 +1,374 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <crypto/Base58.h>
+#include <crypto/CAutoBN_CTX.h>
+#include <crypto/CBigNum.h>
+#include <beast/chrono/chrono_io.h>
+#include <beast/unit_test/suite.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace skywell {
+
+namespace Base58Test {
+
+// The BIGNUM codec Base58 used before it switched to 32 bit limbs
+
+std::string
+oldEncode (unsigned char const* first, unsigned char const* last,
+    Base58::Alphabet const& alphabet, bool withCheck)
+{
+    // Little endian, check bytes first, then a zero pad byte
+    Blob v;
+    if (withCheck)
+    {
+        unsigned char hash [4];
+        Base58::fourbyte_hash256 (hash, first, last - first);
+        v.assign (std::reverse_iterator <unsigned char*> (hash + 4),
+            std::reverse_iterator <unsigned char*> (hash));
+    }
+    v.insert (v.end (), std::reverse_iterator <unsigned char const*> (last),
+        std::reverse_iterator <unsigned char const*> (first));
+    v.push_back (0);
+
+    CAutoBN_CTX pctx;
+    CBigNum bn58 = 58;
+    CBigNum bn0 = 0;
+    CBigNum bn (v.data (), v.data () + v.size ());
+
+    std::string str;
+    CBigNum dv;
+    CBigNum rem;
+
+    while (bn > bn0)
+    {
+        if (!BN_div (&dv, &rem, &bn, &bn58, pctx))
+            throw std::runtime_error ("EncodeBase58 : BN_div failed");
+
+        bn = dv;
+        str += alphabet [rem.getuint ()];
+    }
+
+    for (auto p = v.data () + v.size () - 2; p >= v.data () && *p == 0; p--)
+        str += alphabet [0];
+
+    std::reverse (str.begin (), str.end ());
+    return str;
+}
+
+bool
+oldDecode (char const* psz, Blob& vchRet, Base58::Alphabet const& alphabet)
+{
+    CAutoBN_CTX pctx;
+    vchRet.clear ();
+    CBigNum bn58 = 58;
+    CBigNum bn = 0;
+    CBigNum bnChar;
+
+    while (isspace (*psz))
+        psz++;
+
+    for (char const* p = psz; *p; p++)
+    {
+        char const* p1 = strchr (alphabet.chars (), *p);
+
+        if (p1 == nullptr)
+        {
+            while (isspace (*p))
+                p++;
+
+            if (*p != '\0')
+                return false;
+
+            break;
+        }
+
+        bnChar.setuint (p1 - alphabet.chars ());
+
+        if (!BN_mul (&bn, &bn, &bn58, pctx))
+            throw std::runtime_error ("DecodeBase58 : BN_mul failed");
+
+        bn += bnChar;
+    }
+
+    Blob vchTmp = bn.getvch ();
+
+    if (vchTmp.size () >= 2 && vchTmp.end ()[-1] == 0 &&
+            vchTmp.end ()[-2] >= 0x80)
+        vchTmp.erase (vchTmp.end () - 1);
+
+    int nLeadingZeros = 0;
+    for (char const* p = psz; *p == alphabet.chars ()[0]; p++)
+        nLeadingZeros++;
+
+    vchRet.assign (nLeadingZeros + vchTmp.size (), 0);
+    std::reverse_copy (vchTmp.begin (), vchTmp.end (),
+        vchRet.end () - vchTmp.size ());
+    return true;
+}
+
+// Random bytes, often with leading zeros
+Blob
+randomBytes (std::mt19937& gen, std::size_t size)
+{
+    std::uniform_int_distribution <int> byte (0, 255);
+    std::uniform_int_distribution <std::size_t> zeros (0, 3);
+
+    Blob v (size);
+    std::size_t const z = std::min (size, zeros (gen));
+    for (std::size_t i = z; i < size; ++i)
+        v[i] = static_cast <unsigned char> (byte (gen));
+    return v;
+}
+
+} // Base58Test
+
+class Base58_test : public beast::unit_test::suite
+{
+public:
+    void testRoundTrip ()
+    {
+        testcase ("round trip");
+
+        using namespace Base58Test;
+        std::mt19937 gen;
+        std::uniform_int_distribution <std::size_t> length (0, 100);
+
+        for (int i = 0; i < 20000; ++i)
+        {
+            Blob const v = randomBytes (gen, length (gen));
+            auto const first = v.data ();
+            auto const last = first + v.size ();
+
+            for (auto alphabet : { &Base58::getSkywellAlphabet (),
+                &Base58::getBitcoinAlphabet () })
+            {
+                std::string const s =
+                    Base58::encode (first, last, *alphabet, false);
+                expect (s == oldEncode (first, last, *alphabet, false),
+                    "encode");
+
+                Blob decoded;
+                expect (Base58::decode (s.c_str (), decoded, *alphabet) &&
+                    decoded == v, "decode");
+
+                std::string const c =
+                    Base58::encode (first, last, *alphabet, true);
+                expect (c == oldEncode (first, last, *alphabet, true),
+                    "encode with check");
+
+                expect (Base58::decodeWithCheck (c.c_str (), decoded,
+                    *alphabet) && decoded == v, "decode with check");
+
+                Blob raw (v.size () + 4);
+                expect (Base58::raw_decode (c.data (), c.data () + c.size (),
+                    raw.data (), raw.size (), true, *alphabet) &&
+                        std::equal (v.begin (), v.end (), raw.begin ()),
+                    "raw decode");
+            }
+        }
+    }
+
+    void testIterators ()
+    {
+        testcase ("iterators");
+
+        using namespace Base58Test;
+        std::mt19937 gen;
+        auto const& alphabet = Base58::getSkywellAlphabet ();
+
+        // Key sized ranges use the stack, longer ones the heap
+        for (std::size_t size : { 0, 1, 21, 33, 64, 65, 200 })
+        {
+            Blob const v = randomBytes (gen, size);
+            std::deque <unsigned char> const d (v.begin (), v.end ());
+            std::vector <char> const c (v.begin (), v.end ());
+
+            for (bool withCheck : { false, true })
+            {
+                std::string const s = Base58::encode (
+                    v.data (), v.data () + v.size (), alphabet, withCheck);
+                expect (Base58::encode (d.begin (), d.end (),
+                    alphabet, withCheck) == s, "deque");
+                expect (Base58::encode (c.data (), c.data () + c.size (),
+                    alphabet, withCheck) == s, "char pointer");
+            }
+        }
+    }
+
+    void testGarbage ()
+    {
+        testcase ("garbage");
+
+        using namespace Base58Test;
+        std::mt19937 gen;
+        std::uniform_int_distribution <std::size_t> length (0, 60);
+        std::uniform_int_distribution <int> pick (0, 99);
+        auto const& alphabet = Base58::getSkywellAlphabet ();
+
+        // Mostly digits, with some spaces and characters outside
+        // the alphabet, so every branch of the parser is reached
+        for (int i = 0; i < 20000; ++i)
+        {
+            std::string s (length (gen), ' ');
+            for (auto& ch : s)
+            {
+                int const p = pick (gen);
+                if (p < 5)
+                    ch = ' ';
+                else if (p < 7)
+                    ch = '0';
+                else if (p < 20)
+                    ch = alphabet[0];
+                else
+                    ch = alphabet[p % 58];
+            }
+
+            Blob got;
+            Blob want;
+            bool const ok = Base58::decode (s.c_str (), got, alphabet);
+            bool const oldOk = oldDecode (s.c_str (), want, alphabet);
+            expect (ok == oldOk && (!ok || got == want), s);
+
+            Blob checked;
+            if (Base58::decodeWithCheck (s.c_str (), checked, alphabet))
+            {
+                expect (ok && got.size () >= 4 &&
+                    std::equal (checked.begin (), checked.end (),
+                        got.begin ()), "check");
+            }
+        }
+    }
+
+    void run ()
+    {
+        testRoundTrip ();
+        testIterators ();
+        testGarbage ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(Base58,crypto,skywell);
+
+//------------------------------------------------------------------------------
+
+// Encodes and decodes account IDs and public keys with the limb codec
+// and with the BIGNUM codec it replaced.
+class Base58Speed_test : public beast::unit_test::suite
+{
+public:
+    typedef std::chrono::high_resolution_clock clock_type;
+
+    template <class Duration>
+    void report (std::string const& what, Duration elapsed, std::size_t n)
+    {
+        using namespace std::chrono;
+        auto const ns = duration_cast <nanoseconds> (elapsed).count ();
+        log << std::setw (16) << what << " " <<
+            duration <double> (elapsed) << ", " <<
+            double (ns) / n << "ns per call";
+    }
+
+    template <class Encode, class Decode>
+    void measure (std::string const& name, std::vector <Blob> const& corpus,
+        Encode const& encode, Decode const& decode)
+    {
+        std::size_t const rounds = 50;
+        std::size_t const n = rounds * corpus.size ();
+
+        std::vector <std::string> encoded;
+        encoded.reserve (corpus.size ());
+
+        auto start = clock_type::now ();
+        for (std::size_t i = 0; i < rounds; ++i)
+        {
+            encoded.clear ();
+            for (auto const& v : corpus)
+                encoded.push_back (encode (v));
+        }
+        report (name + " encode", clock_type::now () - start, n);
+
+        Blob out;
+        std::size_t bad = 0;
+        start = clock_type::now ();
+        for (std::size_t i = 0; i < rounds; ++i)
+        {
+            for (auto const& s : encoded)
+                bad += decode (s, out) ? 0 : 1;
+        }
+        report (name + " decode", clock_type::now () - start, n);
+        expect (bad == 0, "decoded");
+    }
+
+    void run ()
+    {
+        using namespace Base58Test;
+        std::mt19937 gen;
+        auto const& alphabet = Base58::getSkywellAlphabet ();
+
+        for (std::size_t size : { 21, 33 })
+        {
+            log << size << " byte payloads, with check";
+
+            std::vector <Blob> corpus;
+            for (int i = 0; i < 2000; ++i)
+                corpus.push_back (randomBytes (gen, size));
+
+            measure ("limbs", corpus,
+                [&](Blob const& v)
+                {
+                    return Base58::encode (v.data (), v.data () + v.size (),
+                        alphabet, true);
+                },
+                [&](std::string const& s, Blob& out)
+                {
+                    return Base58::decodeWithCheck (s.c_str (), out,
+                        alphabet);
+                });
+
+            measure ("bignum", corpus,
+                [&](Blob const& v)
+                {
+                    return oldEncode (v.data (), v.data () + v.size (),
+                        alphabet, true);
+                },
+                [&](std::string const& s, Blob& out)
+                {
+                    return oldDecode (s.c_str (), out, alphabet) &&
+                        out.size () >= 4;
+                });
+        }
+
+        pass ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(Base58Speed,crypto,skywell);
+
+} // skywell
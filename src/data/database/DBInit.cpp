@@ -106,14 +106,37 @@ const char* LedgerDBInit[] =
     // TODO index
     // "CREATE INDEX ValidationsByHash ON              \
     //     Validations(LedgerHash);",
-    // "CREATE INDEX  ValidationsByTime ON              \
-    //     Validations(SignTime);",
+
+    // Used to prune validations by signing time.
+    // Fails harmlessly once the index exists.
+    "CREATE INDEX ValidationsByTime ON              \
+        Validations(SignTime);",
 
     //"END ;"
 };
 
 int LedgerDBCount = std::extent<decltype(LedgerDBInit)>::value;
 
+// Validation database holds stale validations when they are kept apart
+// from the ledger database
+const char* ValidationDBInit[] =
+{
+    "BEGIN ;",
+
+    "CREATE TABLE IF NOT EXISTS Validations   (                   \
+        LedgerHash  CHARACTER(64),                  \
+        NodePubKey  CHARACTER(56),                  \
+        SignTime    BIGINT UNSIGNED,                \
+        RawData     BLOB                            \
+    );",
+
+    // Fails harmlessly once the index exists.
+    "CREATE INDEX ValidationsByTime ON              \
+        Validations(SignTime);",
+};
+
+int ValidationDBCount = std::extent<decltype(ValidationDBInit)>::value;
+
 // NodeIdentity database holds local accounts and trusted nodes
 //  NOTE but its a table not a database, so...?
 //
@@ -26,11 +26,13 @@ namespace skywell {
 extern const char* TxnDBInit[];
 extern const char* LedgerDBInit[];
 extern const char* WalletDBInit[];
+extern const char* ValidationDBInit[];
 
 //  TODO Figure out what these counts are for
 extern int TxnDBCount;
 extern int LedgerDBCount;
 extern int WalletDBCount;
+extern int ValidationDBCount;
 
 } // skywell
 
@@ -47,6 +47,8 @@ DatabaseCon::DatabaseCon (
 		dbPath = setup.mysqlStrings[1];
 	else if (strName.compare("wallet") == 0)
 		dbPath = setup.mysqlStrings[2];
+	else if (strName.compare("validation") == 0)
+		dbPath = setup.mysqlStrings[3];
 
 	open(session_, "mysql", dbPath);
 
@@ -81,7 +83,7 @@ DatabaseCon::Setup setup_DatabaseCon (Config const& c)
 			{
 				setup.mysqlStrings[idx++] = val;
 
-				if (idx >= 3) break;
+				if (idx >= 4) break;
 			}
 		}
 	}
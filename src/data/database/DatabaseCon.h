@@ -81,7 +81,7 @@ public:
         Config::StartUpType startUp = Config::NORMAL;
         bool standAlone = false;
         boost::filesystem::path dataDir;
-		std::string mysqlStrings[3];
+		std::string mysqlStrings[4];
     };
 
     DatabaseCon (Setup const& setup,
@@ -85,10 +85,24 @@ public:
 
     /** Store a group of objects.
         @note This function will not be called concurrently with
-              itself or @ref store.
+              itself or @ref store, except from the group commit
+              performed at ledger close, which backends must tolerate.
     */
     virtual void storeBatch (Batch const& batch) = 0;
 
+    /** Make previously stored objects durable.
+        This is called once per ledger after a group commit and must not
+        return before the objects would survive a crash. Only backends
+        which keep nothing on disk may do nothing.
+    */
+    virtual void sync () = 0;
+
+    /** Return `true` if sync() leaves stored objects able to survive
+        a crash. Callers which record progress, such as a resumable
+        import, must not rely on a backend which returns `false`.
+    */
+    virtual bool isDurable () const = 0;
+
     /** Visit every object in the database
         This is usually called during import.
         @note This routine will not be called concurrently with itself
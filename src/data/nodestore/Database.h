@@ -22,11 +22,27 @@
 
 #include <data/nodestore/NodeObject.h>
 #include <data/nodestore/Backend.h>
+#include <data/nodestore/Import.h>
 #include <common/base/TaggedCache.h>
+#include <functional>
 
 namespace skywell {
 namespace NodeStore {
 
+/** Where fetches that missed the caches were satisfied.
+    @see FastTier
+*/
+struct TierCounts
+{
+    bool enabled;                   // `false` without a [temp_db]
+    std::uint32_t currentHits;      // in the fast tier's current generation
+    std::uint32_t previousHits;     // in its previous generation, promoted
+    std::uint32_t coldHits;         // in the persistent backend
+    std::uint32_t misses;           // nowhere
+    std::uint32_t rotations;        // fast tier generations retired
+    std::uint32_t drops;            // fast tier writes dropped under load
+};
+
 /** Persistency layer for NodeObject
 
     A Node is a ledger object which is uniquely identified by a key, which is
@@ -77,6 +93,10 @@ public:
         to refer to the object, or `nullptr` if the object is not present.
         If I/O is required, the I/O is scheduled.
 
+        If there are no read threads the object is fetched right away, and
+        once shutdown has begun `object` is set to `nullptr`; `true` is
+        returned in both cases.
+
         @note This can be called concurrently.
         @param hash The key of the object to retrieve
         @param object The object retrieved
@@ -84,6 +104,23 @@ public:
     */
     virtual bool asyncFetch (uint256 const& hash, NodeObject::pointer& object) = 0;
 
+    /** Fetch an object without waiting, and report when it is ready.
+        This is the same as the other asyncFetch, except that when `false`
+        is returned, `ready` is called once the scheduled read completes,
+        from the thread which performed it. The object is then in the
+        cache, or known to be absent. Reads still pending when the
+        database shuts down call `ready` without completing, so `ready`
+        is always called when `false` is returned.
+
+        @note This can be called concurrently.
+        @param hash The key of the object to retrieve
+        @param object The object retrieved
+        @param ready Called when the read completes, if one was needed
+        @return Whether the operation completed
+    */
+    virtual bool asyncFetch (uint256 const& hash, NodeObject::pointer& object,
+        std::function <void ()> const& ready) = 0;
+
     /** Wait for all currently pending async reads to complete.
     */
     virtual void waitReads () = 0;
@@ -109,6 +146,19 @@ public:
                         Blob&& data,
                         uint256 const& hash) = 0;
 
+    /** Store the dirty nodes of a ledger as one group.
+
+        When the database was opened with group commit enabled, the batch
+        is sorted by key, handed to the backend in a single write and
+        followed by one sync. Otherwise each object is stored as if by
+        @ref store and written by the backend's usual batching.
+
+        The caller's batch is reordered.
+
+        @param batch The objects produced by flushing a ledger's maps.
+    */
+    virtual void storeBatch (Batch& batch) = 0;
+
     /** Visit every object in the database
         This is usually called during import.
 
@@ -118,8 +168,11 @@ public:
     */
     virtual void for_each(std::function <void(NodeObject::Ptr)> f) = 0;
 
-    /** Import objects from another database. */
-    virtual void import (Database& source) = 0;
+    /** Import objects from another database.
+        @see importObjects
+    */
+    virtual ImportReport import (Database& source,
+        ImportOptions const& options) = 0;
 
     /** Retrieve the estimated number of pending write operations.
         This is used for diagnostics.
@@ -147,6 +200,9 @@ public:
     virtual std::uint32_t getFetchHitCount () const = 0;
     virtual std::uint32_t getStoreSize () const = 0;
     virtual std::uint32_t getFetchSize () const = 0;
+
+    /** Gather hit counts for each storage tier. */
+    virtual TierCounts getTierCounts () const = 0;
 };
 
 }
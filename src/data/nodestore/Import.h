@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef SKYWELL_NODESTORE_IMPORT_H_INCLUDED
+#define SKYWELL_NODESTORE_IMPORT_H_INCLUDED
+
+#include <data/nodestore/Types.h>
+#include <beast/utility/Journal.h>
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace skywell {
+namespace NodeStore {
+
+class Backend;
+class Database;
+
+/** Controls how one node database is copied into another. */
+struct ImportOptions
+{
+    /** Use the defaults: one worker per core, no checkpoint
+        and no verification.
+    */
+    ImportOptions ();
+
+    /** Read the options from a configuration section.
+
+        The keys are "import_threads", "import_checkpoint" and
+        "import_verify". A missing key keeps its default.
+    */
+    explicit
+    ImportOptions (Section const& section);
+
+    // Workers encoding and writing batches, besides the reading thread
+    int threads;
+
+    // File recording how far the copy is durable, so that an interrupted
+    // import can resume. Empty to disable. Requires a durable backend.
+    std::string checkpoint;
+
+    // Read back one object in this many after writing it, zero to disable
+    std::size_t verifyEvery;
+};
+
+/** The outcome of an import. */
+struct ImportReport
+{
+    ImportReport ();
+
+    // Objects and payload bytes written by this run
+    std::size_t objects;
+    std::size_t bytes;
+
+    // Objects an earlier, interrupted run had already copied
+    std::size_t skipped;
+
+    // Objects read back from the backend, and those which were missing,
+    // differed from the source or did not match their hash
+    std::size_t verified;
+    std::size_t corrupt;
+
+    std::chrono::milliseconds elapsed;
+};
+
+/** Copy every object in a database into a backend.
+
+    The calling thread iterates the source, which decodes each object,
+    and hands batches to a pool of workers. The workers store the
+    batches, which re-encodes them for the destination, then fetch
+    sampled objects back to verify them. Progress and throughput are
+    logged periodically.
+
+    With a checkpoint file, the hash of the last object known to be
+    durable, and how many objects the source had yielded up to it, are
+    recorded as the import proceeds. A later run with the same file
+    skips objects until it reaches that hash, and throws if the hash
+    turns up at a different position, since the source's iteration
+    order has then changed. The file is removed when the import
+    completes. Checkpoints are refused for a backend whose isDurable()
+    returns `false`.
+
+    @note The backend's storeBatch must be safe to call concurrently.
+*/
+ImportReport
+importObjects (Database& source, Backend& dest,
+    ImportOptions const& options, beast::Journal journal);
+
+}
+}
+
+#endif
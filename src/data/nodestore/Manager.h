@@ -68,7 +68,8 @@ public:
             HyperLevelDB, LevelDBFactory, SQLite, MDB
 
         If the fastBackendParameter is omitted or empty, no ephemeral database
-        is used. If the scheduler parameter is omited or unspecified, a
+        is used. Otherwise it configures a FastTier, whose byte budget is
+        given by 'max_size_mb'. If the scheduler parameter is omited or unspecified, a
         synchronous scheduler is used which performs all tasks immediately on
         the caller's thread.
 
@@ -80,6 +81,11 @@ public:
         @param backendParameters The parameter string for the persistent backend.
         @param fastBackendParameters [optional] The parameter string for the ephemeral backend.
 
+        Setting 'group_commit' to 1 in the backend parameters makes
+        @ref Database::storeBatch write each ledger as one synced group.
+        Setting 'trace' to a file name records every fetch and store
+        there, see @ref TraceWriter.
+
         @return The opened database.
     */
     virtual
@@ -95,7 +101,9 @@ public:
         Scheduler& scheduler, std::int32_t readThreads,
             std::shared_ptr <Backend> writableBackend,
                 std::shared_ptr <Backend> archiveBackend,
-                std::unique_ptr <Backend> fastBackend,
+                Section const& fastBackendParameters,
+                    bool groupCommit,
+                    std::string const& tracePath,
                     beast::Journal journal) = 0;
 };
 
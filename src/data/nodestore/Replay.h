@@ -0,0 +1,114 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef SKYWELL_NODESTORE_REPLAY_H_INCLUDED
+#define SKYWELL_NODESTORE_REPLAY_H_INCLUDED
+
+#include <data/nodestore/Types.h>
+#include <beast/utility/Journal.h>
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace skywell {
+namespace NodeStore {
+
+class Backend;
+
+/** Controls how a trace is replayed against a backend. */
+struct ReplayOptions
+{
+    /** Use the defaults: unpaced, one thread per core, and only
+        the accesses which reached the backend.
+    */
+    ReplayOptions ();
+
+    /** Read the options from a configuration section.
+
+        The keys are "replay_speed", "replay_threads" and
+        "replay_cached". A missing key keeps its default.
+    */
+    explicit
+    ReplayOptions (Section const& section);
+
+    // Multiple of the recorded pace, 1 for the original timing.
+    // Zero issues every operation as soon as a thread is free.
+    double speed;
+
+    // Threads issuing operations to the backend
+    int threads;
+
+    // Also replay fetches which the caches answered in production
+    bool cached;
+};
+
+/** Latency distribution of one kind of operation. */
+struct ReplayLatency
+{
+    ReplayLatency ();
+
+    std::size_t count;
+    std::chrono::microseconds p50;
+    std::chrono::microseconds p90;
+    std::chrono::microseconds p99;
+    std::chrono::microseconds p999;
+    std::chrono::microseconds max;
+};
+
+/** The outcome of a replay. */
+struct ReplayReport
+{
+    ReplayReport ();
+
+    ReplayLatency fetch;
+    ReplayLatency store;
+
+    // Objects written before the replay for fetches which found an
+    // object that the trace itself never stored
+    std::size_t preloaded;
+
+    // Fetches whose outcome differed from the one recorded
+    std::size_t mismatched;
+
+    // Wall time of the replay, not counting the preload
+    std::chrono::milliseconds elapsed;
+};
+
+/** Drive a backend with the accesses recorded in a trace.
+
+    The trace is read twice. The first pass finds objects which were
+    fetched successfully without being stored earlier in the trace, and
+    writes a stand-in of the recorded size for each so that the replay
+    sees the same hits and misses. The second pass issues every fetch
+    and store from a pool of threads, paced by the recorded timestamps,
+    and measures how long each call into the backend takes.
+
+    Stored payloads are pseudo-random bytes of the recorded size and
+    type, since the trace does not hold the objects themselves.
+
+    @see TraceWriter
+*/
+ReplayReport
+replayTrace (std::string const& trace, Backend& backend,
+    ReplayOptions const& options, beast::Journal journal);
+
+}
+}
+
+#endif
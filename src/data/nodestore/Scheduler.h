@@ -22,6 +22,7 @@
 
 #include <data/nodestore/Task.h>
 #include <chrono>
+#include <cstddef>
 
 namespace skywell {
 namespace NodeStore {
@@ -30,9 +31,10 @@ namespace NodeStore {
 struct FetchReport
 {
     std::chrono::milliseconds elapsed;
+    int fetchCount;     // objects covered, more than one for a batch
     bool isAsync;
     bool wentToDisk;
-    bool wasFound;
+    bool wasFound;      // for a batch, whether any object was found
 };
 
 /** Contains information about a batch write operation. */
@@ -42,6 +44,15 @@ struct BatchWriteReport
     int writeCount;
 };
 
+/** Contains information about the group commit of a ledger. */
+struct GroupCommitReport
+{
+    std::chrono::milliseconds elapsed;      // total time the caller was held
+    std::chrono::milliseconds syncElapsed;  // portion spent in Backend::sync
+    int writeCount;
+    std::size_t writeBytes;
+};
+
 /** Scheduling for asynchronous backend activity
 
     For improved performance, a backend has the option of performing writes
@@ -71,6 +82,11 @@ public:
         Allows the scheduler to monitor the node store's performance
     */
     virtual void onBatchWrite (BatchWriteReport const& report) = 0;
+
+    /** Reports the completion of a ledger's group commit
+        Allows the scheduler to monitor the per-ledger persist time
+    */
+    virtual void onGroupCommit (GroupCommitReport const& report) = 0;
 };
 
 }
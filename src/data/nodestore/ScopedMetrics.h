@@ -25,7 +25,7 @@
 namespace skywell {
 namespace NodeStore {
 
-/** RAII observer to track NodeStore fetches made by the calling thread. */
+/** RAII observer to track NodeStore fetches and writes made by the calling thread. */
 class ScopedMetrics
 {
 private:
@@ -39,11 +39,27 @@ public:
     ScopedMetrics*
     get ();
 
+    /** Install metrics for the calling thread.
+        This lets a coroutine take its metrics with it when it stops
+        on one thread and resumes on another.
+        @return The metrics which were installed before.
+    */
+    static
+    ScopedMetrics*
+    exchange (ScopedMetrics* metrics);
+
     static
     void
     incrementThreadFetches ();
 
+    /** Record objects written, and the time spent blocked writing them. */
+    static
+    void
+    addThreadWrites (std::size_t count, std::size_t stallMilliseconds);
+
     std::size_t fetches = 0;
+    std::size_t writes = 0;
+    std::size_t writeStallMilliseconds = 0;
 };
 
 }
@@ -0,0 +1,129 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef SKYWELL_NODESTORE_TRACE_H_INCLUDED
+#define SKYWELL_NODESTORE_TRACE_H_INCLUDED
+
+#include <data/nodestore/NodeObject.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace skywell {
+namespace NodeStore {
+
+/** One node store access recorded by a TraceWriter.
+
+    On disk a trace is the eight byte magic "NSTRACE1" followed by
+    fixed size records, each holding the fields below in this order
+    with integers in little endian byte order.
+*/
+struct TraceRecord
+{
+    enum Op
+    {
+        fetch = 0,          // Database::fetch
+        asyncFetch = 1,     // Database::asyncFetch, or the read it queued
+        store = 2           // Database::store and storeBatch
+    };
+
+    enum Flags
+    {
+        found = 1,          // a fetch produced the object
+        cached = 2          // a fetch was answered without the backend
+    };
+
+    enum
+    {
+        bytes = 8 + 4 + 1 + 1 + 1 + 32
+    };
+
+    std::uint64_t time;     // microseconds since the trace started
+    std::uint32_t size;     // payload bytes, zero for a fetch that missed
+    std::uint8_t op;
+    std::uint8_t flags;
+    std::uint8_t type;      // NodeObjectType of a store
+    uint256 key;
+};
+
+/** Appends node store accesses to a trace file.
+    @note This can be called concurrently.
+*/
+class TraceWriter
+{
+public:
+    /** Create the file, replacing any existing one.
+        @note An exception is thrown if the file cannot be created.
+    */
+    explicit
+    TraceWriter (std::string const& path);
+
+    /** Flush and close the file. */
+    ~TraceWriter ();
+
+    TraceWriter (TraceWriter const&) = delete;
+    TraceWriter& operator= (TraceWriter const&) = delete;
+
+    void
+    record (TraceRecord::Op op, uint256 const& key,
+        NodeObject const* object, bool cached = false);
+
+private:
+    void flush ();
+
+    std::chrono::steady_clock::time_point const start_;
+    std::mutex mutex_;
+    std::vector <unsigned char> buffer_;
+    std::FILE* file_;
+};
+
+/** Reads a trace written by TraceWriter, one record at a time. */
+class TraceReader
+{
+public:
+    /** Open the file and check its magic.
+        @note An exception is thrown if the file is not a trace.
+    */
+    explicit
+    TraceReader (std::string const& path);
+
+    ~TraceReader ();
+
+    TraceReader (TraceReader const&) = delete;
+    TraceReader& operator= (TraceReader const&) = delete;
+
+    /** Read the next record.
+        @return `false` at the end of the trace.
+    */
+    bool next (TraceRecord& record);
+
+    /** Start again from the first record. */
+    void rewind ();
+
+private:
+    std::FILE* file_;
+};
+
+}
+}
+
+#endif
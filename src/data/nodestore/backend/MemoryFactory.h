@@ -68,6 +68,14 @@ public:
             throw std::runtime_error("already open");
         return db;
     }
+
+    /** Discard a database and its contents. */
+    void
+    erase (std::string const& path)
+    {
+        std::lock_guard<std::mutex> _(mutex_);
+        map_.erase (path);
+    }
 };
 
 
@@ -82,12 +90,14 @@ private:
     std::string name_;
     beast::Journal journal_;
     MemoryDB* db_;
+    bool deletePath_;
 
 public:
     MemoryBackend (size_t keyBytes, Section const& keyValues,
         Scheduler& scheduler, beast::Journal journal)
         : name_ (get<std::string>(keyValues, "path"))
         , journal_ (journal)
+        , deletePath_ (false)
     {
         if (name_.empty())
             throw std::runtime_error ("Missing path in Memory backend");
@@ -108,6 +118,11 @@ public:
     void
     close() override
     {
+        // Erase the entry rather than just emptying it, so that
+        // uniquely named databases such as fast tier generations
+        // do not accumulate in the factory.
+        if (db_ && deletePath_)
+            memoryFactory.erase (name_);
         db_ = nullptr;
     }
 
@@ -157,6 +172,17 @@ public:
             store (e);
     }
 
+    void
+    sync () override
+    {
+    }
+
+    bool
+    isDurable () const override
+    {
+        return false;
+    }
+
     void
     for_each (std::function <void(NodeObject::Ptr)> f)
     {
@@ -173,6 +199,7 @@ public:
     void
     setDeletePath() override
     {
+        deletePath_ = true;
     }
 
     void
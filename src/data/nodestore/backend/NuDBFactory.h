@@ -26,10 +26,17 @@
 #include <boost/filesystem.hpp>
 #include <cassert>
 #include <chrono>
+#include <condition_variable>
 #include <cstdio>
 #include <cstdint>
+#include <deque>
 #include <exception>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <pthread.h>
 
 #include <data/nodestore/Factory.h>
 #include <data/nodestore/Manager.h>
@@ -50,7 +57,16 @@ public:
         // distribution of data sizes.
         arena_alloc_size = 16 * 1024 * 1024,
 
-        currentType = 1
+        currentType = 1,
+
+        // Default number of threads issuing batch fetch reads,
+        // including the thread which requested the batch
+        defaultFetchThreads = 4,
+
+        // Fewest keys worth handing to another thread. Keys that miss
+        // the caches cost a read each, and random keys rarely share a
+        // run of buckets, so even small slices overlap useful I/O.
+        minFetchSlice = 4
     };
 
     using api = beast::nudb::api<
@@ -63,6 +79,16 @@ public:
     std::atomic <bool> deletePath_;
     Scheduler& scheduler_;
 
+    // Read key file buckets through a memory map
+    bool mapKeyFile_;
+
+    // Threads reading slices of a batch fetch concurrently
+    std::vector <std::thread> ioThreads_;
+    std::deque <std::function <void()>> ioQueue_;
+    std::mutex ioMutex_;
+    std::condition_variable ioCond_;
+    bool ioStop_;
+
     NuDBBackend (int keyBytes, Section const& keyValues,
         Scheduler& scheduler, beast::Journal journal)
         : journal_ (journal)
@@ -70,6 +96,8 @@ public:
         , name_ (get<std::string>(keyValues, "path"))
         , deletePath_(false)
         , scheduler_ (scheduler)
+        , mapKeyFile_ (false)
+        , ioStop_ (false)
     {
         if (name_.empty())
             throw std::runtime_error (
@@ -100,10 +128,26 @@ public:
             std::cerr << e.what();
             std::terminate();
         }
+
+        get_if_exists (keyValues, "mmap", mapKeyFile_);
+        mapKeys();
+
+        int fetchThreads = defaultFetchThreads;
+        get_if_exists (keyValues, "fetch_threads", fetchThreads);
+        for (int i = 1; i < fetchThreads; ++i)
+            ioThreads_.emplace_back (&NuDBBackend::ioEntry, this);
     }
 
     ~NuDBBackend ()
     {
+        {
+            std::lock_guard <std::mutex> lock (ioMutex_);
+            ioStop_ = true;
+        }
+        ioCond_.notify_all();
+        for (auto& t : ioThreads_)
+            t.join();
+
         close();
     }
 
@@ -152,14 +196,122 @@ public:
     bool
     canFetchBatch() override
     {
-        return false;
+        return true;
     }
 
+    /** Fetch a batch of keys.
+
+        The keys are split into slices which are read concurrently,
+        the first on the calling thread. Within a slice the store sorts
+        the keys by bucket and merges reads of adjacent buckets, but
+        otherwise reads one key at a time with blocking preads. So at
+        most `fetch_threads` reads are outstanding for a batch.
+    */
     std::vector<std::shared_ptr<NodeObject>>
     fetchBatch (std::size_t n, void const* const* keys) override
     {
-        throw std::runtime_error("pure virtual called");
-        return {};
+        std::vector<std::shared_ptr<NodeObject>> results (n);
+        std::size_t const slices = std::max <std::size_t> (1,
+            std::min (ioThreads_.size() + 1, n / minFetchSlice));
+        std::size_t const per = (n + slices - 1) / slices;
+
+        std::mutex m;
+        std::condition_variable cv;
+        std::size_t pending = 0;
+        std::exception_ptr ep;
+
+        for (std::size_t first = per; first < n; first += per)
+        {
+            std::size_t const count = std::min (per, n - first);
+            {
+                std::lock_guard <std::mutex> lock (m);
+                ++pending;
+            }
+            post ([&, first, count]()
+            {
+                std::exception_ptr e;
+                try
+                {
+                    fetchSlice (count, keys + first, &results[first]);
+                }
+                catch (...)
+                {
+                    e = std::current_exception();
+                }
+                std::lock_guard <std::mutex> lock (m);
+                if (e)
+                    ep = e;
+                if (--pending == 0)
+                    cv.notify_one();
+            });
+        }
+
+        std::exception_ptr e;
+        try
+        {
+            fetchSlice (std::min (per, n), keys, results.data());
+        }
+        catch (...)
+        {
+            e = std::current_exception();
+        }
+
+        // The other slices refer to this frame, so wait for them
+        std::unique_lock <std::mutex> lock (m);
+        cv.wait (lock, [&]{ return pending == 0; });
+        if (! e)
+            e = ep;
+        if (e)
+            std::rethrow_exception (e);
+        return results;
+    }
+
+    void
+    fetchSlice (std::size_t n, void const* const* keys,
+        std::shared_ptr<NodeObject>* results)
+    {
+        db_.fetch_batch (n, keys,
+            [&](std::size_t i, void const* data, std::size_t size)
+            {
+                DecodedBlob decoded (keys[i], data, size);
+                if (! decoded.wasOk ())
+                {
+                    if (journal_.error) journal_.error <<
+                        "Corrupt NodeObject in batch fetch";
+                    return;
+                }
+                results[i] = decoded.createObject();
+            });
+    }
+
+    void
+    post (std::function <void()> f)
+    {
+        {
+            std::lock_guard <std::mutex> lock (ioMutex_);
+            ioQueue_.push_back (std::move (f));
+        }
+        ioCond_.notify_one();
+    }
+
+    void
+    ioEntry()
+    {
+        pthread_setname_np (pthread_self(), "nudb_io");
+
+        std::unique_lock <std::mutex> lock (ioMutex_);
+        for(;;)
+        {
+            ioCond_.wait (lock, [this]{
+                return ioStop_ || ! ioQueue_.empty(); });
+            if (ioQueue_.empty())
+                break;
+            auto f = std::move (ioQueue_.front());
+            ioQueue_.pop_front();
+            lock.unlock();
+            f();
+            lock.lock();
+        }
     }
 
     void
@@ -201,6 +353,18 @@ public:
         scheduler_.onBatchWrite (report);
     }
 
+    void
+    sync () override
+    {
+        db_.flush();
+    }
+
+    bool
+    isDurable () const override
+    {
+        return true;
+    }
+
     void
     for_each (std::function <void(NodeObject::Ptr)> f)
     {
@@ -222,6 +386,18 @@ public:
             });
         db_.open (dp, kp, lp,
             arena_alloc_size);
+        mapKeys();
+    }
+
+    void
+    mapKeys()
+    {
+        if (mapKeyFile_ && ! db_.map_key_file())
+        {
+            if (journal_.warning) journal_.warning <<
+                "Unable to map " << db_.key_path() <<
+                ", reading it with pread";
+        }
     }
 
     int
@@ -246,6 +422,7 @@ public:
         api::verify (dp, kp);
         db_.open (dp, kp, lp,
             arena_alloc_size);
+        mapKeys();
     }
 };
 
@@ -79,6 +79,17 @@ public:
     {
     }
 
+    void
+    sync () override
+    {
+    }
+
+    bool
+    isDurable () const override
+    {
+        return false;
+    }
+
     void
     for_each (std::function <void(NodeObject::Ptr)> f)
     {
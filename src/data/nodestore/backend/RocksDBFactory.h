@@ -340,6 +340,23 @@ public:
             throw std::runtime_error ("storeBatch failed: " + ret.ToString());
     }
 
+    void
+    sync () override
+    {
+        // Writes already reach the write ahead log, syncing it is
+        // enough to make them durable without flushing the memtable.
+        auto ret = m_db->SyncWAL ();
+
+        if (!ret.ok ())
+            throw std::runtime_error ("sync failed: " + ret.ToString());
+    }
+
+    bool
+    isDurable () const override
+    {
+        return true;
+    }
+
     void
     for_each (std::function <void(NodeObject::Ptr)> f)
     {
@@ -99,6 +99,7 @@ public:
     size_t const m_keyBytes;
     std::string m_name;
     std::unique_ptr <rocksdb::DB> m_db;
+    bool m_groupCommit;
 
     RocksDBQuickBackend (int keyBytes, Section const& keyValues,
         Scheduler& scheduler, beast::Journal journal, RocksDBQuickEnv* env)
@@ -106,6 +107,7 @@ public:
         , m_journal (journal)
         , m_keyBytes (keyBytes)
         , m_name (get<std::string>(keyValues, "path"))
+        , m_groupCommit (false)
     {
         if (m_name.empty())
             throw std::runtime_error ("Missing path in RocksDBQuickFactory backend");
@@ -118,6 +120,7 @@ public:
         get_if_exists (keyValues, "budget", budget);
         get_if_exists (keyValues, "style", style);
         get_if_exists (keyValues, "threads", threads);
+        get_if_exists (keyValues, "group_commit", m_groupCommit);
 
 
         // Set options
@@ -294,8 +297,9 @@ public:
 
         rocksdb::WriteOptions options;
 
-        // Crucial to ensure good write speed and non-blocking writes to memtable
-        options.disableWAL = true;
+        // Crucial to ensure good write speed and non-blocking writes to memtable.
+        // Group commit keeps the log, which sync() makes durable per ledger.
+        options.disableWAL = ! m_groupCommit;
         
         auto ret = m_db->Write (options, &wb);
 
@@ -303,6 +307,27 @@ public:
             throw std::runtime_error ("storeBatch failed: " + ret.ToString());
     }
 
+    void
+    sync () override
+    {
+        // Without group commit the write ahead log is disabled
+        // and there is nothing to sync.
+        if (! m_groupCommit)
+            return;
+
+        auto ret = m_db->SyncWAL ();
+
+        if (!ret.ok ())
+            throw std::runtime_error ("sync failed: " + ret.ToString());
+    }
+
+    bool
+    isDurable () const override
+    {
+        // Without the log, unflushed memtables are lost in a crash
+        return m_groupCommit;
+    }
+
     void
     for_each (std::function <void(NodeObject::Ptr)> f)
     {
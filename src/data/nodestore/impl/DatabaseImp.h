@@ -22,6 +22,8 @@
 
 #include <data/nodestore/Database.h>
 #include <data/nodestore/Scheduler.h>
+#include <data/nodestore/Trace.h>
+#include <data/nodestore/impl/FastTier.h>
 #include <data/nodestore/impl/Tuning.h>
 #include <common/base/TaggedCache.h>
 #include <common/base/KeyCache.h>
@@ -29,8 +31,10 @@
 #include <common/base/seconds_clock.h>
 #include <beast/threads/Thread.h>
 #include <data/nodestore/ScopedMetrics.h>
+#include <algorithm>
 #include <chrono>
 #include <condition_variable>
+#include <map>
 #include <set>
 #include <thread>
 #include <pthread.h>
@@ -46,8 +50,8 @@ public:
     Scheduler& m_scheduler;
     // Persistent key/value storage.
     std::unique_ptr <Backend> m_backend;
-    // Larger key/value storage, but not necessarily persistent.
-    std::unique_ptr <Backend> m_fastBackend;
+    // Bounded, ephemeral storage consulted before the persistent one.
+    std::unique_ptr <FastTier> m_fastBackend;
 
     // Positive cache
     TaggedCache <uint256, NodeObject> m_cache;
@@ -59,16 +63,25 @@ public:
     std::condition_variable   m_readCondVar;
     std::condition_variable   m_readGenCondVar;
     std::set <uint256>        m_readSet;        // set of reads to do
+    std::multimap <uint256, std::function <void ()>>
+                              m_readWaiters;    // called when a read is done
     uint256                   m_readLast;       // last hash read
     std::vector <std::thread> m_readThreads;
     bool                      m_readShut;
     uint64_t                  m_readGen;        // current read generation
 
+    // Write each ledger's nodes as one sorted, synced batch
+    bool const                m_groupCommit;
+
+    // Records every access when tracing is enabled
+    std::unique_ptr <TraceWriter> m_trace;
+
     DatabaseImp (std::string const& name,
                  Scheduler& scheduler,
                  int readThreads,
                  std::unique_ptr <Backend> backend,
-                 std::unique_ptr <Backend> fastBackend,
+                 std::unique_ptr <FastTier> fastBackend,
+                 bool groupCommit,
                  beast::Journal journal)
         : m_journal (journal)
         , m_scheduler (scheduler)
@@ -80,9 +93,11 @@ public:
             cacheTargetSize, cacheTargetSeconds)
         , m_readShut (false)
         , m_readGen (0)
+        , m_groupCommit (groupCommit)
         , m_storeCount (0)
         , m_fetchTotalCount (0)
         , m_fetchHitCount (0)
+        , m_fetchColdHitCount (0)
         , m_storeSize (0)
         , m_fetchSize (0)
     {
@@ -109,6 +124,14 @@ public:
         return m_backend->getName ();
     }
 
+    /** Record accesses to a trace file.
+        This must be called before the database is used.
+    */
+    void setTrace (std::unique_ptr <TraceWriter> trace)
+    {
+        m_trace = std::move (trace);
+    }
+
     void
     close() override
     {
@@ -126,16 +149,46 @@ public:
 
     //------------------------------------------------------------------------------
 
-    bool asyncFetch (uint256 const& hash, NodeObject::pointer& object)
+    bool asyncFetch (uint256 const& hash, NodeObject::pointer& object) override
+    {
+        return asyncFetch (hash, object, nullptr);
+    }
+
+    bool asyncFetch (uint256 const& hash, NodeObject::pointer& object,
+        std::function <void ()> const& ready) override
     {
         // See if the object is in cache
         object = m_cache.fetch (hash);
         if (object || m_negCache.touch_if_exists (hash))
+        {
+            if (m_trace)
+                m_trace->record (TraceRecord::asyncFetch, hash,
+                    object.get (), true);
+            return true;
+        }
+
+        // With no read threads a queued read would never be done, and
+        // its waiter never called, so the read is done here instead
+        if (m_readThreads.empty ())
+        {
+            object = doTimedFetch (hash, true);
             return true;
+        }
 
         {
             // No. Post a read
             std::unique_lock <std::mutex> lock (m_readLock);
+
+            // The read threads are gone or going, and would neither read
+            // nor call the waiter
+            if (m_readShut)
+            {
+                object = nullptr;
+                return true;
+            }
+
+            if (ready)
+                m_readWaiters.emplace (hash, ready);
             if (m_readSet.insert (hash).second)
                 m_readCondVar.notify_one ();
         }
@@ -176,6 +229,7 @@ public:
     NodeObject::Ptr doTimedFetch (uint256 const& hash, bool isAsync)
     {
         FetchReport report;
+        report.fetchCount = 1;
         report.isAsync = isAsync;
         report.wentToDisk = false;
 
@@ -187,6 +241,10 @@ public:
         report.wasFound = (ret != nullptr);
         m_scheduler.onFetch (report);
 
+        if (m_trace)
+            m_trace->record (isAsync ? TraceRecord::asyncFetch :
+                TraceRecord::fetch, hash, ret.get (), ! report.wentToDisk);
+
         return ret;
     }
 
@@ -226,6 +284,9 @@ public:
             //
             obj = fetchFrom (hash);
             ++m_fetchTotalCount;
+
+            if (obj != nullptr)
+                ++m_fetchColdHitCount;
         }
 
         if (obj == nullptr)
@@ -248,7 +309,7 @@ public:
 
             if (! foundInFastBackend)
             {
-                // If we have a fast back end, store it there for later.
+                // If we have a fast tier, it is queued there for later.
                 //
                 if (m_fastBackend != nullptr)
                 {
@@ -273,6 +334,102 @@ public:
         return fetchInternal (*m_backend, hash);
     }
 
+    /** Returns `true` if queued reads should be fetched in batches. */
+    virtual bool canFetchBatchFrom ()
+    {
+        return m_fastBackend == nullptr && m_backend->canFetchBatch ();
+    }
+
+    virtual std::vector <NodeObject::Ptr> fetchBatchFrom (
+        std::vector <uint256> const& hashes)
+    {
+        return fetchBatchInternal (*m_backend, hashes);
+    }
+
+    std::vector <NodeObject::Ptr> fetchBatchInternal (Backend& backend,
+        std::vector <uint256> const& hashes)
+    {
+        std::vector <void const*> keys;
+        keys.reserve (hashes.size ());
+        for (auto const& hash : hashes)
+            keys.push_back (hash.begin ());
+
+        std::vector <NodeObject::Ptr> objects =
+            backend.fetchBatch (keys.size (), keys.data ());
+
+        for (auto const& object : objects)
+        {
+            if (object)
+            {
+                ++m_fetchHitCount;
+                m_fetchSize += object->getData().size();
+            }
+        }
+
+        return objects;
+    }
+
+    /** Fetch queued reads with one backend call and report the time.
+        The batch is reported once, so that its elapsed time is not
+        rounded away by dividing it between the objects.
+    */
+    void doTimedFetchBatch (std::vector <uint256>& hashes)
+    {
+        // Drop anything which was resolved while it was queued
+        hashes.erase (std::remove_if (hashes.begin (), hashes.end (),
+            [this](uint256 const& hash)
+            {
+                return m_cache.fetch (hash) != nullptr ||
+                    m_negCache.touch_if_exists (hash);
+            }), hashes.end ());
+
+        if (hashes.empty ())
+            return;
+
+        auto const before = std::chrono::steady_clock::now();
+        std::vector <NodeObject::Ptr> objects = fetchBatchFrom (hashes);
+        auto const elapsed = std::chrono::duration_cast <std::chrono::milliseconds>
+            (std::chrono::steady_clock::now() - before);
+
+        m_fetchTotalCount += hashes.size ();
+
+        bool found = false;
+
+        for (std::size_t i = 0; i < hashes.size (); ++i)
+        {
+            NodeObject::Ptr obj = objects[i];
+
+            if (obj == nullptr)
+            {
+                // Just in case a write occurred
+                obj = m_cache.fetch (hashes[i]);
+
+                if (obj == nullptr)
+                    m_negCache.insert (hashes[i]);
+            }
+            else
+            {
+                // Counted here rather than per backend so that objects
+                // a rotating database finds in its archive count too
+                ++m_fetchColdHitCount;
+                m_cache.canonicalize (hashes[i], obj);
+                found = true;
+            }
+
+            if (m_trace)
+                m_trace->record (TraceRecord::asyncFetch, hashes[i],
+                    obj.get ());
+        }
+
+        FetchReport report;
+        report.elapsed = elapsed;
+        report.fetchCount = static_cast <int> (hashes.size ());
+        report.isAsync = true;
+        report.wentToDisk = true;
+        report.wasFound = found;
+        m_scheduler.onFetch (report);
+    }
+
     NodeObject::Ptr fetchInternal (Backend& backend,
         uint256 const& hash)
     {
@@ -326,6 +483,9 @@ public:
 
         m_cache.canonicalize (hash, object, true);
 
+        if (m_trace)
+            m_trace->record (TraceRecord::store, hash, object.get ());
+
         backend.store (object);
         ++m_storeCount;
         if (object)
@@ -340,6 +500,91 @@ public:
             if (object)
                 m_storeSize += object->getData().size();
         }
+
+        ScopedMetrics::addThreadWrites (1, 0);
+    }
+
+    void storeBatch (Batch& batch) override
+    {
+        storeBatchInternal (batch, *m_backend.get());
+    }
+
+    void storeBatchInternal (Batch& batch, Backend& backend)
+    {
+        if (batch.empty ())
+            return;
+
+        if (! m_groupCommit)
+        {
+            for (auto& object : batch)
+            {
+                m_cache.canonicalize (object->getHash (), object, true);
+                backend.store (object);
+                m_negCache.erase (object->getHash ());
+                if (m_fastBackend)
+                    m_fastBackend->store (object);
+            }
+            countBatch (batch);
+            ScopedMetrics::addThreadWrites (batch.size (), 0);
+            return;
+        }
+
+        GroupCommitReport report;
+        report.writeCount = batch.size ();
+        report.writeBytes = 0;
+        auto const before = std::chrono::steady_clock::now ();
+
+        // Key order lets the backend append to its index sequentially
+        std::sort (batch.begin (), batch.end (), NodeObject::LessThan ());
+
+        for (auto& object : batch)
+        {
+            m_cache.canonicalize (object->getHash (), object, true);
+            m_negCache.erase (object->getHash ());
+            report.writeBytes += object->getData ().size ();
+        }
+
+        backend.storeBatch (batch);
+
+        auto const beforeSync = std::chrono::steady_clock::now ();
+        backend.sync ();
+        auto const after = std::chrono::steady_clock::now ();
+
+        if (m_fastBackend)
+            m_fastBackend->storeBatch (batch);
+
+        countBatch (batch);
+
+        report.elapsed = std::chrono::duration_cast <std::chrono::milliseconds>
+            (after - before);
+        report.syncElapsed = std::chrono::duration_cast <std::chrono::milliseconds>
+            (after - beforeSync);
+        m_scheduler.onGroupCommit (report);
+
+        ScopedMetrics::addThreadWrites (batch.size (), report.elapsed.count ());
+
+        if (m_journal.debug) m_journal.debug <<
+            "Group commit of " << report.writeCount << " objects, " <<
+            report.writeBytes << " bytes in " << report.elapsed.count () <<
+            "ms (sync " << report.syncElapsed.count () << "ms)";
+    }
+
+    /** Account for a batch written to the backend. */
+    void countBatch (Batch const& batch)
+    {
+        std::uint32_t size = 0;
+        for (auto const& object : batch)
+        {
+            size += object->getData ().size ();
+
+            if (m_trace)
+                m_trace->record (TraceRecord::store, object->getHash (),
+                    object.get ());
+        }
+
+        int const copies = m_fastBackend ? 2 : 1;
+        m_storeCount += copies * batch.size ();
+        m_storeSize += copies * size;
     }
 
     //------------------------------------------------------------------------------
@@ -375,9 +620,20 @@ public:
     {
         pthread_setname_np (pthread_self(), "prefetch");
         
+        std::vector <uint256> hashes;
+        hashes.reserve (asyncBatchSize);
+
+        // Callers waiting on the reads taken
+        std::vector <std::function <void ()>> waiters;
+
+        // Most reads to take at once, decided when the first read arrives
+        // since this thread starts before a derived class is constructed
+        std::size_t limit = 0;
+
         while (1)
         {
-            uint256 hash;
+            hashes.clear ();
+            waiters.clear ();
 
             {
                 std::unique_lock <std::mutex> lock (m_readLock);
@@ -390,7 +646,24 @@ public:
                 }
 
                 if (m_readShut)
+                {
+                    // Nobody will read for the waiters left, so let them
+                    // go now rather than wait forever
+                    for (auto& e : m_readWaiters)
+                        waiters.push_back (std::move (e.second));
+                    m_readWaiters.clear ();
+                    m_readSet.clear ();
                     break;
+                }
+
+                if (limit == 0)
+                {
+                    lock.unlock ();
+
+                    // Only take several reads if the backend fetches them together
+                    limit = canFetchBatchFrom () ? asyncBatchSize : 1;
+                    continue;
+                }
 
                 // Read in key order to make the back end more efficient
                 std::set <uint256>::iterator it = m_readSet.lower_bound (m_readLast);
@@ -403,14 +676,37 @@ public:
                     m_readGenCondVar.notify_all ();
                 }
 
-                hash = *it;
-                m_readSet.erase (it);
-                m_readLast = hash;
+                // Take reads in key order, stopping at the end of the set
+                // so that the next generation starts from the beginning
+                do
+                {
+                    hashes.push_back (*it);
+                    m_readSet.erase (it++);
+
+                    // Anyone who asks for this hash from now on queues it
+                    // again, so a completion is never missed
+                    auto const range = m_readWaiters.equal_range (hashes.back ());
+                    for (auto w = range.first; w != range.second; ++w)
+                        waiters.push_back (std::move (w->second));
+                    m_readWaiters.erase (range.first, range.second);
+                }
+                while (hashes.size () < limit && it != m_readSet.end ());
+
+                m_readLast = hashes.back ();
             }
 
             // Perform the read
-            doTimedFetch (hash, true);
+            if (hashes.size () == 1)
+                doTimedFetch (hashes.front (), true);
+            else
+                doTimedFetchBatch (hashes);
+
+            for (auto const& ready : waiters)
+                ready ();
          }
+
+        for (auto const& ready : waiters)
+            ready ();
      }
 
     //------------------------------------------------------------------------------
@@ -420,33 +716,21 @@ public:
         m_backend->for_each (f);
     }
 
-    void import (Database& source)
+    ImportReport import (Database& source,
+        ImportOptions const& options) override
     {
-        importInternal (source, *m_backend.get());
+        return importInternal (source, *m_backend.get(), options);
     }
 
-    void importInternal (Database& source, Backend& dest)
+    ImportReport importInternal (Database& source, Backend& dest,
+        ImportOptions const& options)
     {
-        Batch b;
-        b.reserve (batchWritePreallocationSize);
+        ImportReport const report =
+            importObjects (source, dest, options, m_journal);
 
-        source.for_each ([&](NodeObject::Ptr object)
-        {
-            if (b.size() >= batchWritePreallocationSize)
-            {
-                dest.storeBatch (b);
-                b.clear();
-                b.reserve (batchWritePreallocationSize);
-            }
-
-            b.push_back (object);
-            ++m_storeCount;
-            if (object)
-                m_storeSize += object->getData().size();
-        });
-
-        if (! b.empty())
-            dest.storeBatch (b);
+        m_storeCount += report.objects;
+        m_storeSize += report.bytes;
+        return report;
     }
 
     std::uint32_t getStoreCount () const override
@@ -474,10 +758,29 @@ public:
         return m_fetchSize;
     }
 
+    TierCounts getTierCounts () const override
+    {
+        TierCounts counts {};
+        counts.coldHits = m_fetchColdHitCount;
+
+        if (m_fastBackend)
+        {
+            counts.enabled = true;
+            counts.currentHits = m_fastBackend->getCurrentHitCount ();
+            counts.previousHits = m_fastBackend->getPreviousHitCount ();
+            counts.rotations = m_fastBackend->getRotationCount ();
+            counts.drops = m_fastBackend->getDropCount ();
+        }
+
+        counts.misses = m_fetchTotalCount - counts.coldHits;
+        return counts;
+    }
+
 private:
     std::atomic <std::uint32_t> m_storeCount;
     std::atomic <std::uint32_t> m_fetchTotalCount;
     std::atomic <std::uint32_t> m_fetchHitCount;
+    std::atomic <std::uint32_t> m_fetchColdHitCount;
     std::atomic <std::uint32_t> m_storeSize;
     std::atomic <std::uint32_t> m_fetchSize;
 };
@@ -50,6 +50,30 @@ NodeObject::Ptr DatabaseRotatingImp::fetchFrom (uint256 const& hash)
 
     return object;
 }
+
+std::vector <NodeObject::Ptr> DatabaseRotatingImp::fetchBatchFrom (
+    std::vector <uint256> const& hashes)
+{
+    Backends b = getBackends();
+    std::vector <NodeObject::Ptr> objects =
+        fetchBatchInternal (*b.writableBackend, hashes);
+
+    // Anything not yet rotated in comes from the archive, one at a time
+    for (std::size_t i = 0; i < hashes.size (); ++i)
+    {
+        if (objects[i])
+            continue;
+
+        objects[i] = fetchInternal (*b.archiveBackend, hashes[i]);
+        if (objects[i])
+        {
+            getWritableBackend()->store (objects[i]);
+            m_negCache.erase (hashes[i]);
+        }
+    }
+
+    return objects;
+}
 }
 
 }
@@ -52,11 +52,12 @@ public:
                  int readThreads,
                  std::shared_ptr <Backend> writableBackend,
                  std::shared_ptr <Backend> archiveBackend,
-                 std::unique_ptr <Backend> fastBackend,
+                 std::unique_ptr <FastTier> fastBackend,
+                 bool groupCommit,
                  beast::Journal journal)
             : DatabaseImp (name, scheduler, readThreads,
                     std::unique_ptr <Backend>(), std::move (fastBackend),
-                    journal)
+                    groupCommit, journal)
             , writableBackend_ (writableBackend)
             , archiveBackend_ (archiveBackend)
     {}
@@ -104,9 +105,10 @@ public:
         b.writableBackend->for_each (f);
     }
 
-    void import (Database& source) override
+    ImportReport import (Database& source,
+        ImportOptions const& options) override
     {
-        importInternal (source, *getWritableBackend());
+        return importInternal (source, *getWritableBackend(), options);
     }
 
     void store (NodeObjectType type,
@@ -117,12 +119,26 @@ public:
                 *getWritableBackend());
     }
 
+    void storeBatch (Batch& batch) override
+    {
+        storeBatchInternal (batch, *getWritableBackend());
+    }
+
     NodeObject::Ptr fetchNode (uint256 const& hash) override
     {
         return fetchFrom (hash);
     }
 
     NodeObject::Ptr fetchFrom (uint256 const& hash) override;
+
+    bool canFetchBatchFrom () override
+    {
+        return m_fastBackend == nullptr &&
+            getWritableBackend()->canFetchBatch ();
+    }
+
+    std::vector <NodeObject::Ptr> fetchBatchFrom (
+        std::vector <uint256> const& hashes) override;
     TaggedCache <uint256, NodeObject>& getPositiveCache() override
     {
         return m_cache;
@@ -53,5 +53,10 @@ DummyScheduler::onBatchWrite (const BatchWriteReport& report)
 {
 }
 
+void
+DummyScheduler::onGroupCommit (const GroupCommitReport& report)
+{
+}
+
 }
 }
@@ -0,0 +1,345 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <data/nodestore/impl/FastTier.h>
+#include <data/nodestore/impl/Tuning.h>
+#include <data/nodestore/Manager.h>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <cstring>
+#include <pthread.h>
+
+namespace skywell {
+namespace NodeStore {
+
+// Prefix of the subdirectories holding generations
+static char const* const generationPrefix = "tier.";
+
+static
+std::uint64_t
+generationSize (Section const& parameters)
+{
+    std::uint64_t megabytes = fastTierSizeMB;
+    get_if_exists (parameters, "max_size_mb", megabytes);
+    if (megabytes == 0)
+        throw std::runtime_error ("max_size_mb must be positive in [temp_db]");
+
+    // Two generations share the budget
+    return megabytes * 1024 * 1024 / 2;
+}
+
+FastTier::FastTier (Section const& parameters,
+        Scheduler& scheduler, beast::Journal journal)
+    : parameters_ (parameters)
+    , scheduler_ (scheduler)
+    , journal_ (journal)
+    , path_ (get<std::string> (parameters, "path"))
+    , generationSize_ (generationSize (parameters))
+    , currentSize_ (0)
+    , shut_ (false)
+    , currentHits_ (0)
+    , previousHits_ (0)
+    , misses_ (0)
+    , rotations_ (0)
+    , drops_ (0)
+{
+    if (path_.empty ())
+        throw std::runtime_error ("Missing path in [temp_db]");
+
+    // Generations left behind by an unclean shutdown are never reopened
+    namespace fs = boost::filesystem;
+    boost::system::error_code ec;
+    if (fs::is_directory (path_, ec))
+    {
+        for (fs::directory_iterator it (path_), end; it != end; ++it)
+        {
+            if (it->path ().filename ().string ().compare (
+                    0, std::strlen (generationPrefix), generationPrefix) == 0)
+                fs::remove_all (it->path (), ec);
+        }
+    }
+
+    current_ = makeGeneration ();
+    thread_ = std::thread (&FastTier::threadEntry, this);
+}
+
+FastTier::~FastTier ()
+{
+    close ();
+}
+
+std::string
+FastTier::getName ()
+{
+    return path_;
+}
+
+void
+FastTier::close ()
+{
+    {
+        std::lock_guard <std::mutex> lock (queueMutex_);
+        shut_ = true;
+        queueCondVar_.notify_all ();
+    }
+
+    if (thread_.joinable ())
+        thread_.join ();
+
+    std::lock_guard <std::mutex> lock (mutex_);
+    if (current_)
+    {
+        current_->close ();
+        current_ = nullptr;
+    }
+    if (previous_)
+    {
+        previous_->close ();
+        previous_ = nullptr;
+    }
+}
+
+FastTier::Generations
+FastTier::getGenerations () const
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+    return Generations {current_, previous_};
+}
+
+std::shared_ptr <Backend>
+FastTier::makeGeneration ()
+{
+    boost::filesystem::path p (path_);
+    p /= generationPrefix;
+    p += "%%%%%%%%";
+
+    Section parameters (parameters_);
+    parameters.set ("path", boost::filesystem::unique_path (p).string ());
+
+    std::shared_ptr <Backend> backend = Manager::instance ().make_Backend (
+        parameters, scheduler_, journal_);
+    backend->setDeletePath ();
+    return backend;
+}
+
+//------------------------------------------------------------------------------
+
+Status
+FastTier::fetch (void const* key, NodeObject::Ptr* pObject)
+{
+    Generations const g = getGenerations ();
+
+    if (g.current)
+    {
+        Status const status = g.current->fetch (key, pObject);
+        if (status == ok && *pObject)
+        {
+            ++currentHits_;
+            return ok;
+        }
+    }
+
+    if (g.previous)
+    {
+        Status const status = g.previous->fetch (key, pObject);
+        if (status == ok && *pObject)
+        {
+            // Keep it through the next rotation
+            ++previousHits_;
+            enqueue (*pObject);
+            return ok;
+        }
+    }
+
+    ++misses_;
+    pObject->reset ();
+    return notFound;
+}
+
+std::vector <std::shared_ptr <NodeObject>>
+FastTier::fetchBatch (std::size_t n, void const* const* keys)
+{
+    std::vector <std::shared_ptr <NodeObject>> objects (n);
+    for (std::size_t i = 0; i < n; ++i)
+        fetch (keys[i], &objects[i]);
+    return objects;
+}
+
+void
+FastTier::store (NodeObject::Ptr const& object)
+{
+    enqueue (object);
+}
+
+void
+FastTier::storeBatch (Batch const& batch)
+{
+    std::lock_guard <std::mutex> lock (queueMutex_);
+
+    std::size_t const room = (queue_.size () < fastTierQueueLimit)
+        ? fastTierQueueLimit - queue_.size () : 0;
+    std::size_t const count = std::min (room, batch.size ());
+
+    queue_.insert (queue_.end (), batch.begin (), batch.begin () + count);
+    drops_ += batch.size () - count;
+
+    queueCondVar_.notify_one ();
+}
+
+void
+FastTier::enqueue (NodeObject::Ptr const& object)
+{
+    std::lock_guard <std::mutex> lock (queueMutex_);
+
+    if (queue_.size () >= fastTierQueueLimit)
+    {
+        ++drops_;
+        return;
+    }
+
+    queue_.push_back (object);
+    queueCondVar_.notify_one ();
+}
+
+void
+FastTier::sync ()
+{
+    if (auto const current = getGenerations ().current)
+        current->sync ();
+}
+
+void
+FastTier::for_each (std::function <void (NodeObject::Ptr)> f)
+{
+    Generations const g = getGenerations ();
+    if (g.previous)
+        g.previous->for_each (f);
+    if (g.current)
+        g.current->for_each (f);
+}
+
+int
+FastTier::getWriteLoad ()
+{
+    int load;
+    {
+        std::lock_guard <std::mutex> lock (queueMutex_);
+        load = static_cast <int> (queue_.size ());
+    }
+
+    if (auto const current = getGenerations ().current)
+        load += current->getWriteLoad ();
+    return load;
+}
+
+void
+FastTier::setDeletePath ()
+{
+}
+
+void
+FastTier::verify ()
+{
+    Generations const g = getGenerations ();
+    if (g.previous)
+        g.previous->verify ();
+    if (g.current)
+        g.current->verify ();
+}
+
+//------------------------------------------------------------------------------
+
+void
+FastTier::rotate ()
+{
+    std::shared_ptr <Backend> next = makeGeneration ();
+    std::shared_ptr <Backend> retired;
+
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        retired = std::move (previous_);
+        previous_ = std::move (current_);
+        current_ = std::move (next);
+    }
+
+    currentSize_ = 0;
+
+    // Fetches which copied the retired generation before the swap may
+    // still be reading it, but no new ones can start. Whichever of them
+    // lets go last destroys it, and the backend's destructor closes it
+    // and removes its files.
+    retired.reset ();
+
+    ++rotations_;
+
+    if (journal_.debug) journal_.debug <<
+        "Fast tier rotated, " << previousHits_ << " promotions, " <<
+        drops_ << " drops so far";
+}
+
+void
+FastTier::threadEntry ()
+{
+    pthread_setname_np (pthread_self (), "fasttier");
+
+    Batch batch;
+
+    while (1)
+    {
+        batch.clear ();
+
+        {
+            std::unique_lock <std::mutex> lock (queueMutex_);
+
+            while (!shut_ && queue_.empty ())
+                queueCondVar_.wait (lock);
+
+            // Whatever is still queued is only a cache fill
+            if (shut_)
+                break;
+
+            batch.swap (queue_);
+        }
+
+        std::shared_ptr <Backend> const current = getGenerations ().current;
+        current->storeBatch (batch);
+
+        for (auto const& object : batch)
+            currentSize_ += object->getData ().size ();
+
+        if (currentSize_ >= generationSize_)
+        {
+            try
+            {
+                rotate ();
+            }
+            catch (std::exception const& e)
+            {
+                // Keep filling the current generation and try again later
+                currentSize_ = 0;
+                if (journal_.error) journal_.error <<
+                    "Fast tier rotation failed: " << e.what ();
+            }
+        }
+    }
+}
+
+}
+}
@@ -0,0 +1,180 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef SKYWELL_NODESTORE_FASTTIER_H_INCLUDED
+#define SKYWELL_NODESTORE_FASTTIER_H_INCLUDED
+
+#include <data/nodestore/Backend.h>
+#include <data/nodestore/Scheduler.h>
+#include <common/base/BasicConfig.h>
+#include <beast/utility/Journal.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace skywell {
+namespace NodeStore {
+
+/** A bounded, ephemeral tier in front of the persistent backend.
+
+    Backends cannot remove single objects, so eviction works on whole
+    generations, the same way online delete rotates the node database.
+    Objects are written to the current generation. Once it holds half of
+    the byte budget it becomes the previous generation and a new, empty
+    one takes its place; the old previous generation is discarded along
+    with its files. An object fetched from the previous generation is
+    copied into the current one, so anything used within the lifetime of
+    a generation survives the next rotation. The result approximates LRU
+    with a footprint between one half and the whole budget.
+
+    Writes, promotions and rotations happen on a worker thread. When it
+    falls behind, new writes are dropped rather than queued without bound;
+    a dropped object is simply fetched from the persistent backend again.
+
+    Each generation is an ordinary backend created from the `[temp_db]`
+    section, with `path` replaced by a unique subdirectory of it. The
+    budget is set in megabytes with `max_size_mb`.
+*/
+class FastTier : public Backend
+{
+public:
+    FastTier (Section const& parameters,
+        Scheduler& scheduler, beast::Journal journal);
+
+    ~FastTier ();
+
+    std::string getName () override;
+
+    void close () override;
+
+    Status fetch (void const* key, NodeObject::Ptr* pObject) override;
+
+    bool canFetchBatch () override
+    {
+        return false;
+    }
+
+    std::vector <std::shared_ptr <NodeObject>>
+    fetchBatch (std::size_t n, void const* const* keys) override;
+
+    /** Queue an object for the current generation. */
+    void store (NodeObject::Ptr const& object) override;
+
+    /** Queue a batch of objects for the current generation. */
+    void storeBatch (Batch const& batch) override;
+
+    void sync () override;
+
+    /** Generations are discarded, so nothing here is durable. */
+    bool isDurable () const override
+    {
+        return false;
+    }
+
+    void for_each (std::function <void (NodeObject::Ptr)> f) override;
+
+    int getWriteLoad () override;
+
+    /** Generations are always removed, so this does nothing. */
+    void setDeletePath () override;
+
+    void verify () override;
+
+    /** Fetches found in the current generation. */
+    std::uint32_t getCurrentHitCount () const
+    {
+        return currentHits_;
+    }
+
+    /** Fetches found in the previous generation and promoted. */
+    std::uint32_t getPreviousHitCount () const
+    {
+        return previousHits_;
+    }
+
+    /** Fetches found in neither generation. */
+    std::uint32_t getMissCount () const
+    {
+        return misses_;
+    }
+
+    /** Generations discarded since the tier was opened. */
+    std::uint32_t getRotationCount () const
+    {
+        return rotations_;
+    }
+
+    /** Objects dropped because the worker thread fell behind. */
+    std::uint32_t getDropCount () const
+    {
+        return drops_;
+    }
+
+private:
+    struct Generations
+    {
+        std::shared_ptr <Backend> current;
+        std::shared_ptr <Backend> previous;
+    };
+
+    Generations getGenerations () const;
+
+    std::shared_ptr <Backend> makeGeneration ();
+
+    void enqueue (NodeObject::Ptr const& object);
+
+    void rotate ();
+
+    void threadEntry ();
+
+    Section parameters_;
+    Scheduler& scheduler_;
+    beast::Journal journal_;
+    std::string const path_;
+
+    // Bytes written to a generation before it is retired
+    std::uint64_t const generationSize_;
+
+    mutable std::mutex mutex_;
+    std::shared_ptr <Backend> current_;
+    std::shared_ptr <Backend> previous_;
+
+    // Only touched by the worker thread
+    std::uint64_t currentSize_;
+
+    std::mutex queueMutex_;
+    std::condition_variable queueCondVar_;
+    Batch queue_;
+    bool shut_;
+    std::thread thread_;
+
+    std::atomic <std::uint32_t> currentHits_;
+    std::atomic <std::uint32_t> previousHits_;
+    std::atomic <std::uint32_t> misses_;
+    std::atomic <std::uint32_t> rotations_;
+    std::atomic <std::uint32_t> drops_;
+};
+
+}
+}
+
+#endif
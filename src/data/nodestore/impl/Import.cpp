@@ -0,0 +1,488 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <data/nodestore/Import.h>
+#include <data/nodestore/Backend.h>
+#include <data/nodestore/Database.h>
+#include <protocol/Serializer.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace skywell {
+namespace NodeStore {
+
+ImportOptions::ImportOptions ()
+    : threads (std::max (1u, std::thread::hardware_concurrency ()))
+    , verifyEvery (0)
+{
+}
+
+ImportOptions::ImportOptions (Section const& section)
+    : ImportOptions ()
+{
+    get_if_exists (section, "import_threads", threads);
+    get_if_exists (section, "import_checkpoint", checkpoint);
+    get_if_exists (section, "import_verify", verifyEvery);
+
+    threads = std::max (threads, 1);
+}
+
+ImportReport::ImportReport ()
+    : objects (0)
+    , bytes (0)
+    , skipped (0)
+    , verified (0)
+    , corrupt (0)
+    , elapsed (0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+// Batches queued per worker before the reader waits
+std::size_t const queueDepth = 4;
+
+// How often progress is logged and the checkpoint advanced
+std::chrono::seconds const reportInterval (10);
+
+// How far an import is known to be durable: the number of objects the
+// source had yielded, and the hash of the last of them
+struct Checkpoint
+{
+    std::size_t position = 0;
+    uint256 key;
+};
+
+Checkpoint
+readCheckpoint (std::string const& path)
+{
+    Checkpoint checkpoint;
+
+    if (! path.empty ())
+    {
+        std::ifstream in (path);
+        std::string key;
+        if (in && ! (in >> checkpoint.position >> key &&
+                checkpoint.key.SetHex (key, true)))
+            throw std::runtime_error (
+                "nodestore: unreadable import checkpoint " + path);
+    }
+
+    return checkpoint;
+}
+
+void
+writeCheckpoint (std::string const& path, Checkpoint const& checkpoint)
+{
+    // Replace the file in one step so a crash leaves the old one intact
+    std::string const temp = path + ".tmp";
+    {
+        std::ofstream out (temp, std::ios::trunc);
+        out << checkpoint.position << ' ' << to_string (checkpoint.key) << '\n';
+        if (! out)
+            throw std::runtime_error (
+                "nodestore: can't write import checkpoint " + temp);
+    }
+
+    if (std::rename (temp.c_str (), path.c_str ()) != 0)
+        throw std::runtime_error (
+            "nodestore: can't replace import checkpoint " + path);
+}
+
+class ImportPipeline
+{
+public:
+    ImportPipeline (Backend& dest, ImportOptions const& options,
+            beast::Journal journal)
+        : dest_ (dest)
+        , options_ (options)
+        , journal_ (journal)
+        , resume_ (readCheckpoint (options.checkpoint))
+        , resumed_ (resume_.position == 0)
+        , position_ (0)
+        , seq_ (0)
+        , nextSeq_ (0)
+        , durable_ (resume_)
+        , done_ (false)
+        , objects_ (0)
+        , bytes_ (0)
+        , sampled_ (0)
+        , verified_ (0)
+        , corrupt_ (0)
+    {
+        // A checkpoint written after a sync which loses data on a crash
+        // would make a resumed import silently skip objects
+        if (! options_.checkpoint.empty () && ! dest_.isDurable ())
+            throw std::runtime_error ("nodestore: import checkpoints "
+                "need a durable destination, not " + dest_.getName ());
+    }
+
+    ImportReport
+    run (Database& source)
+    {
+        start_ = clock_type::now ();
+        lastReport_ = start_;
+
+        if (! resumed_ && journal_.warning) journal_.warning <<
+            "Import resuming after " << resume_.position << " objects, " <<
+            "at " << resume_.key;
+
+        workers_.reserve (options_.threads);
+        for (int i = 0; i < options_.threads; ++i)
+            workers_.emplace_back (&ImportPipeline::work, this);
+
+        try
+        {
+            source.for_each ([this](NodeObject::Ptr object)
+            {
+                ++position_;
+
+                if (! object)
+                    return;
+
+                if (! resumed_)
+                {
+                    skip (*object);
+                    return;
+                }
+
+                batch_.push_back (std::move (object));
+
+                if (batch_.size () >= batchWritePreallocationSize)
+                    submit ();
+            });
+
+            if (! resumed_)
+                throw std::runtime_error ("nodestore: import checkpoint "
+                    "key " + to_string (resume_.key) + " is not in the source");
+
+            if (! batch_.empty ())
+                submit ();
+        }
+        catch (...)
+        {
+            stop ();
+            throw;
+        }
+
+        stop ();
+
+        if (error_)
+            std::rethrow_exception (error_);
+
+        dest_.sync ();
+
+        if (! options_.checkpoint.empty ())
+            std::remove (options_.checkpoint.c_str ());
+
+        ImportReport report;
+        report.objects = objects_;
+        report.bytes = bytes_;
+        report.skipped = resume_.position;
+        report.verified = verified_;
+        report.corrupt = corrupt_;
+        report.elapsed = std::chrono::duration_cast <
+            std::chrono::milliseconds> (clock_type::now () - start_);
+
+        logProgress (report.elapsed);
+
+        return report;
+    }
+
+private:
+    typedef std::chrono::steady_clock clock_type;
+
+    struct Job
+    {
+        std::size_t seq;
+
+        // Source position and hash of the batch's last object
+        Checkpoint end;
+
+        Batch batch;
+    };
+
+    // Pass over an object an earlier run copied. The resume key must
+    // turn up exactly where it did in that run, otherwise the source's
+    // order changed and the objects before it are not the ones copied.
+    void
+    skip (NodeObject const& object)
+    {
+        if (object.getHash () != resume_.key)
+            return;
+
+        if (position_ != resume_.position)
+            throw std::runtime_error ("nodestore: import checkpoint key " +
+                to_string (resume_.key) + " moved from position " +
+                std::to_string (resume_.position) + " to " +
+                std::to_string (position_) + ", the source order changed");
+
+        resumed_ = true;
+    }
+
+    // Queue the current batch, waiting while the workers are behind
+    void
+    submit ()
+    {
+        {
+            std::unique_lock <std::mutex> lock (mutex_);
+
+            space_.wait (lock, [this]
+            {
+                return error_ ||
+                    queue_.size () < queueDepth * workers_.size ();
+            });
+
+            if (error_)
+                std::rethrow_exception (error_);
+
+            Job job;
+            job.seq = seq_++;
+            job.end.position = position_;
+            job.end.key = batch_.back ()->getHash ();
+            job.batch.swap (batch_);
+            queue_.push_back (std::move (job));
+        }
+
+        ready_.notify_one ();
+
+        batch_.reserve (batchWritePreallocationSize);
+
+        auto const now = clock_type::now ();
+        if (now - lastReport_ >= reportInterval)
+        {
+            lastReport_ = now;
+            checkpoint ();
+            logProgress (std::chrono::duration_cast <
+                std::chrono::milliseconds> (now - start_));
+        }
+    }
+
+    // Record how far the import is known to be durable
+    void
+    checkpoint ()
+    {
+        if (options_.checkpoint.empty ())
+            return;
+
+        Checkpoint durable;
+        {
+            std::lock_guard <std::mutex> lock (mutex_);
+            durable = durable_;
+        }
+
+        if (durable.position == 0)
+            return;
+
+        // Everything counted in durable was stored before this sync
+        dest_.sync ();
+        writeCheckpoint (options_.checkpoint, durable);
+    }
+
+    void
+    logProgress (std::chrono::milliseconds elapsed)
+    {
+        if (! journal_.info)
+            return;
+
+        double const seconds =
+            std::max <double> (elapsed.count (), 1) / 1000.0;
+        std::size_t const objects = objects_;
+        std::size_t const bytes = bytes_;
+
+        journal_.info <<
+            "Import: " << objects << " objects, " <<
+            bytes / (1024 * 1024) << " MB in " <<
+            static_cast <long long> (seconds) << "s (" <<
+            static_cast <long long> (objects / seconds) << " objects/s, " <<
+            static_cast <long long> (bytes / seconds / (1024 * 1024)) <<
+            " MB/s), " << verified_ << " verified, " <<
+            corrupt_ << " corrupt";
+    }
+
+    void
+    stop ()
+    {
+        {
+            std::lock_guard <std::mutex> lock (mutex_);
+            done_ = true;
+        }
+
+        ready_.notify_all ();
+
+        for (auto& worker : workers_)
+            worker.join ();
+
+        workers_.clear ();
+    }
+
+    void
+    work ()
+    {
+        for (;;)
+        {
+            Job job;
+            {
+                std::unique_lock <std::mutex> lock (mutex_);
+
+                ready_.wait (lock, [this]
+                {
+                    return error_ || done_ || ! queue_.empty ();
+                });
+
+                if (error_ || queue_.empty ())
+                    return;
+
+                job = std::move (queue_.front ());
+                queue_.pop_front ();
+            }
+
+            space_.notify_one ();
+
+            try
+            {
+                store (job.batch);
+            }
+            catch (...)
+            {
+                {
+                    std::lock_guard <std::mutex> lock (mutex_);
+                    if (! error_)
+                        error_ = std::current_exception ();
+                }
+
+                ready_.notify_all ();
+                space_.notify_all ();
+                return;
+            }
+
+            std::lock_guard <std::mutex> lock (mutex_);
+
+            // Batches finish out of order; only a run of finished
+            // batches from the start moves the durable position
+            finished_.emplace (job.seq, job.end);
+            while (! finished_.empty () &&
+                finished_.begin ()->first == nextSeq_)
+            {
+                durable_ = finished_.begin ()->second;
+                finished_.erase (finished_.begin ());
+                ++nextSeq_;
+            }
+        }
+    }
+
+    void
+    store (Batch const& batch)
+    {
+        dest_.storeBatch (batch);
+
+        if (options_.verifyEvery != 0)
+        {
+            for (auto const& object : batch)
+            {
+                if (sampled_++ % options_.verifyEvery == 0)
+                    verify (*object);
+            }
+        }
+
+        std::size_t bytes = 0;
+        for (auto const& object : batch)
+            bytes += object->getData ().size ();
+
+        objects_ += batch.size ();
+        bytes_ += bytes;
+    }
+
+    // Read a sampled object back from the destination and check that
+    // it round-tripped intact and still hashes to its key
+    void
+    verify (NodeObject const& object)
+    {
+        ++verified_;
+
+        NodeObject::Ptr stored;
+        Status const status = dest_.fetch (object.getHash ().begin (), &stored);
+
+        if (status == ok && stored &&
+                stored->getData () == object.getData () &&
+                getSHA512Half (stored->getData ()) == object.getHash ())
+            return;
+
+        ++corrupt_;
+
+        if (journal_.error) journal_.error <<
+            "Import: " << object.getHash () << " did not read back intact, " <<
+            "status " << status;
+    }
+
+    Backend& dest_;
+    ImportOptions const options_;
+    beast::Journal journal_;
+
+    // Used only by the reading thread
+    Checkpoint const resume_;
+    bool resumed_;
+    std::size_t position_;
+    std::size_t seq_;
+    Batch batch_;
+    clock_type::time_point start_;
+    clock_type::time_point lastReport_;
+    std::vector <std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::condition_variable space_;
+    std::deque <Job> queue_;
+    std::map <std::size_t, Checkpoint> finished_;
+    std::size_t nextSeq_;
+    Checkpoint durable_;
+    bool done_;
+    std::exception_ptr error_;
+
+    std::atomic <std::size_t> objects_;
+    std::atomic <std::size_t> bytes_;
+    std::atomic <std::size_t> sampled_;
+    std::atomic <std::size_t> verified_;
+    std::atomic <std::size_t> corrupt_;
+};
+
+} // namespace
+
+ImportReport
+importObjects (Database& source, Backend& dest,
+    ImportOptions const& options, beast::Journal journal)
+{
+    ImportPipeline pipeline (dest, options, journal);
+    return pipeline.run (source);
+}
+
+}
+}
@@ -84,6 +84,18 @@ ManagerImp::make_Backend (
     return backend;
 }
 
+std::unique_ptr <FastTier>
+ManagerImp::make_FastTier (
+    Section const& parameters,
+    Scheduler& scheduler,
+    beast::Journal journal)
+{
+    if (parameters.size () == 0)
+        return nullptr;
+
+    return std::make_unique <FastTier> (parameters, scheduler, journal);
+}
+
 std::unique_ptr <Database>
 ManagerImp::make_Database (
     std::string const& name,
@@ -96,13 +108,18 @@ ManagerImp::make_Database (
     std::unique_ptr <Backend> backend (make_Backend (
         backendParameters, scheduler, journal));
 
-    std::unique_ptr <Backend> fastBackend (
-        (fastBackendParameters.size () > 0)
-            ? make_Backend (fastBackendParameters, scheduler, journal)
-            : nullptr);
+    bool groupCommit = false;
+    get_if_exists (backendParameters, "group_commit", groupCommit);
+
+    std::string tracePath;
+    get_if_exists (backendParameters, "trace", tracePath);
 
-    return std::make_unique <DatabaseImp> (name, scheduler, readThreads,
-        std::move (backend), std::move (fastBackend), journal);
+    auto db = std::make_unique <DatabaseImp> (name, scheduler, readThreads,
+        std::move (backend), make_FastTier (fastBackendParameters,
+            scheduler, journal), groupCommit, journal);
+    if (! tracePath.empty ())
+        db->setTrace (std::make_unique <TraceWriter> (tracePath));
+    return std::move (db);
 }
 
 std::unique_ptr <DatabaseRotating>
@@ -112,12 +129,18 @@ ManagerImp::make_DatabaseRotating (
         std::int32_t readThreads,
         std::shared_ptr <Backend> writableBackend,
         std::shared_ptr <Backend> archiveBackend,
-        std::unique_ptr <Backend> fastBackend,
+        Section const& fastBackendParameters,
+        bool groupCommit,
+        std::string const& tracePath,
         beast::Journal journal)
 {
-    return std::make_unique <DatabaseRotatingImp> (name, scheduler,
+    auto db = std::make_unique <DatabaseRotatingImp> (name, scheduler,
             readThreads, writableBackend, archiveBackend,
-            std::move (fastBackend), journal);
+            make_FastTier (fastBackendParameters, scheduler, journal),
+            groupCommit, journal);
+    if (! tracePath.empty ())
+        db->setTrace (std::make_unique <TraceWriter> (tracePath));
+    return std::move (db);
 }
 
 Factory*
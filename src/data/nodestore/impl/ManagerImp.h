@@ -21,6 +21,7 @@
 #define SKYWELL_NODESTORE_MANAGERIMP_H_INCLUDED
 
 #include <data/nodestore/Manager.h>
+#include <data/nodestore/impl/FastTier.h>
 #include <mutex>
 #include <vector>
 
@@ -61,6 +62,13 @@ public:
         Scheduler& scheduler,
         beast::Journal journal) override;
 
+    /** Create the fast tier, or `nullptr` if it is not configured. */
+    std::unique_ptr <FastTier>
+    make_FastTier (
+        Section const& parameters,
+        Scheduler& scheduler,
+        beast::Journal journal);
+
     std::unique_ptr <Database>
     make_Database (
         std::string const& name,
@@ -77,7 +85,9 @@ public:
         std::int32_t readThreads,
         std::shared_ptr <Backend> writableBackend,
         std::shared_ptr <Backend> archiveBackend,
-        std::unique_ptr <Backend> fastBackend,
+        Section const& fastBackendParameters,
+        bool groupCommit,
+        std::string const& tracePath,
         beast::Journal journal) override;
 };
 
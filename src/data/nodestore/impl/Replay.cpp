@@ -0,0 +1,364 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <data/nodestore/Replay.h>
+#include <data/nodestore/Backend.h>
+#include <data/nodestore/Trace.h>
+#include <common/base/UnorderedContainers.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace skywell {
+namespace NodeStore {
+
+ReplayOptions::ReplayOptions ()
+    : speed (0)
+    , threads (std::max (1u, std::thread::hardware_concurrency ()))
+    , cached (false)
+{
+}
+
+ReplayOptions::ReplayOptions (Section const& section)
+    : ReplayOptions ()
+{
+    get_if_exists (section, "replay_speed", speed);
+    get_if_exists (section, "replay_threads", threads);
+    get_if_exists (section, "replay_cached", cached);
+
+    speed = std::max (speed, 0.0);
+    threads = std::max (threads, 1);
+}
+
+ReplayLatency::ReplayLatency ()
+    : count (0)
+    , p50 (0)
+    , p90 (0)
+    , p99 (0)
+    , p999 (0)
+    , max (0)
+{
+}
+
+ReplayReport::ReplayReport ()
+    : preloaded (0)
+    , mismatched (0)
+    , elapsed (0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+// Records queued per thread before the reader waits
+std::size_t const queueDepth = 256;
+
+// Objects written per call while preloading
+std::size_t const preloadBatch = 256;
+
+/** A stand-in for a recorded object.
+    The payload is derived from the key, so repeated runs are identical.
+*/
+NodeObject::Ptr
+makeObject (TraceRecord const& record)
+{
+    Blob data (record.size);
+
+    std::uint64_t x;
+    std::memcpy (&x, record.key.begin (), sizeof (x));
+    x |= 1;
+    for (auto& b : data)
+    {
+        // xorshift64
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        b = static_cast <unsigned char> (x);
+    }
+
+    return NodeObject::createObject (
+        static_cast <NodeObjectType> (record.type),
+            std::move (data), record.key);
+}
+
+bool
+replayed (TraceRecord const& record, ReplayOptions const& options)
+{
+    return record.op == TraceRecord::store ||
+        options.cached || (record.flags & TraceRecord::cached) == 0;
+}
+
+std::size_t
+preload (TraceReader& reader, Backend& backend,
+    ReplayOptions const& options)
+{
+    hash_set <uint256> present;
+    Batch batch;
+    std::size_t count = 0;
+
+    TraceRecord record;
+    while (reader.next (record))
+    {
+        if (! replayed (record, options))
+            continue;
+
+        if (record.op == TraceRecord::store)
+        {
+            present.insert (record.key);
+        }
+        else if ((record.flags & TraceRecord::found) &&
+            present.insert (record.key).second)
+        {
+            batch.push_back (makeObject (record));
+            if (batch.size () >= preloadBatch)
+            {
+                backend.storeBatch (batch);
+                count += batch.size ();
+                batch.clear ();
+            }
+        }
+    }
+
+    if (! batch.empty ())
+    {
+        backend.storeBatch (batch);
+        count += batch.size ();
+    }
+
+    backend.sync ();
+    return count;
+}
+
+ReplayLatency
+summarize (std::vector <std::uint32_t>& samples)
+{
+    ReplayLatency latency;
+    latency.count = samples.size ();
+    if (samples.empty ())
+        return latency;
+
+    std::sort (samples.begin (), samples.end ());
+
+    auto const at = [&samples](double q)
+    {
+        std::size_t const i = static_cast <std::size_t> (
+            q * (samples.size () - 1));
+        return std::chrono::microseconds (samples[i]);
+    };
+
+    latency.p50 = at (0.50);
+    latency.p90 = at (0.90);
+    latency.p99 = at (0.99);
+    latency.p999 = at (0.999);
+    latency.max = std::chrono::microseconds (samples.back ());
+    return latency;
+}
+
+class ReplayPool
+{
+public:
+    ReplayPool (Backend& backend, int threads)
+        : backend_ (backend)
+        , limit_ (queueDepth * threads)
+        , done_ (false)
+        , mismatched_ (0)
+    {
+        for (int i = 0; i < threads; ++i)
+            threads_.emplace_back (&ReplayPool::run, this);
+    }
+
+    ~ReplayPool ()
+    {
+        finish ();
+    }
+
+    void
+    post (TraceRecord const& record)
+    {
+        std::unique_lock <std::mutex> lock (mutex_);
+        while (queue_.size () >= limit_)
+            spaceCondVar_.wait (lock);
+        queue_.push_back (record);
+        workCondVar_.notify_one ();
+    }
+
+    void
+    finish ()
+    {
+        {
+            std::lock_guard <std::mutex> lock (mutex_);
+            done_ = true;
+            workCondVar_.notify_all ();
+        }
+
+        for (auto& t : threads_)
+            t.join ();
+        threads_.clear ();
+    }
+
+    void
+    report (ReplayReport& report)
+    {
+        report.fetch = summarize (fetches_);
+        report.store = summarize (stores_);
+        report.mismatched = mismatched_;
+    }
+
+private:
+    void
+    run ()
+    {
+        std::vector <std::uint32_t> fetches;
+        std::vector <std::uint32_t> stores;
+
+        for (;;)
+        {
+            TraceRecord record;
+            {
+                std::unique_lock <std::mutex> lock (mutex_);
+                while (! done_ && queue_.empty ())
+                    workCondVar_.wait (lock);
+                if (queue_.empty ())
+                    break;
+                record = queue_.front ();
+                queue_.pop_front ();
+                spaceCondVar_.notify_one ();
+            }
+
+            if (record.op == TraceRecord::store)
+            {
+                NodeObject::Ptr const object = makeObject (record);
+
+                auto const before = std::chrono::steady_clock::now ();
+                backend_.store (object);
+                stores.push_back (elapsed (before));
+            }
+            else
+            {
+                NodeObject::Ptr object;
+
+                auto const before = std::chrono::steady_clock::now ();
+                backend_.fetch (record.key.begin (), &object);
+                fetches.push_back (elapsed (before));
+
+                if ((object != nullptr) !=
+                        ((record.flags & TraceRecord::found) != 0))
+                    ++mismatched_;
+            }
+        }
+
+        std::lock_guard <std::mutex> lock (mutex_);
+        fetches_.insert (fetches_.end (), fetches.begin (), fetches.end ());
+        stores_.insert (stores_.end (), stores.begin (), stores.end ());
+    }
+
+    static
+    std::uint32_t
+    elapsed (std::chrono::steady_clock::time_point before)
+    {
+        return static_cast <std::uint32_t> (std::chrono::duration_cast <
+            std::chrono::microseconds> (
+                std::chrono::steady_clock::now () - before).count ());
+    }
+
+    Backend& backend_;
+    std::size_t const limit_;
+
+    std::mutex mutex_;
+    std::condition_variable workCondVar_;
+    std::condition_variable spaceCondVar_;
+    std::deque <TraceRecord> queue_;
+    bool done_;
+
+    std::vector <std::thread> threads_;
+    std::vector <std::uint32_t> fetches_;
+    std::vector <std::uint32_t> stores_;
+    std::atomic <std::size_t> mismatched_;
+};
+
+}
+
+//------------------------------------------------------------------------------
+
+ReplayReport
+replayTrace (std::string const& trace, Backend& backend,
+    ReplayOptions const& options, beast::Journal journal)
+{
+    ReplayReport report;
+    TraceReader reader (trace);
+
+    report.preloaded = preload (reader, backend, options);
+    if (journal.info) journal.info <<
+        "Replay preloaded " << report.preloaded << " objects";
+
+    reader.rewind ();
+
+    auto const start = std::chrono::steady_clock::now ();
+    {
+        ReplayPool pool (backend, options.threads);
+
+        // Time of the first replayed record
+        std::uint64_t origin = 0;
+        bool first = true;
+
+        TraceRecord record;
+        while (reader.next (record))
+        {
+            if (! replayed (record, options))
+                continue;
+
+            if (first)
+            {
+                origin = record.time;
+                first = false;
+            }
+
+            if (options.speed > 0)
+            {
+                // Records a little older than the first one must not
+                // wrap around to a huge delay
+                std::int64_t const offset = std::max <std::int64_t> (0,
+                    static_cast <std::int64_t> (record.time) -
+                        static_cast <std::int64_t> (origin));
+                std::this_thread::sleep_until (start +
+                    std::chrono::microseconds (static_cast <std::int64_t> (
+                        offset / options.speed)));
+            }
+
+            pool.post (record);
+        }
+
+        pool.finish ();
+        pool.report (report);
+    }
+
+    report.elapsed = std::chrono::duration_cast <std::chrono::milliseconds> (
+        std::chrono::steady_clock::now () - start);
+    return report;
+}
+
+}
+}
@@ -48,6 +48,14 @@ ScopedMetrics::get ()
     return scopedMetricsPtr.get ();
 }
 
+ScopedMetrics*
+ScopedMetrics::exchange (ScopedMetrics* metrics)
+{
+    ScopedMetrics* const prev = scopedMetricsPtr.get ();
+    scopedMetricsPtr.reset (metrics);
+    return prev;
+}
+
 void
 ScopedMetrics::incrementThreadFetches ()
 {
@@ -55,5 +63,16 @@ ScopedMetrics::incrementThreadFetches ()
         ++scopedMetricsPtr.get ()->fetches;
 }
 
+void
+ScopedMetrics::addThreadWrites (std::size_t count,
+    std::size_t stallMilliseconds)
+{
+    if (auto const metrics = scopedMetricsPtr.get ())
+    {
+        metrics->writes += count;
+        metrics->writeStallMilliseconds += stallMilliseconds;
+    }
+}
+
 }
 }
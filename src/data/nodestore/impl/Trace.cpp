@@ -0,0 +1,172 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <data/nodestore/Trace.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace skywell {
+namespace NodeStore {
+
+namespace {
+
+char const magic[8] = { 'N', 'S', 'T', 'R', 'A', 'C', 'E', '1' };
+
+// Records buffered before they are written out
+std::size_t const bufferRecords = 4096;
+
+template <class Int>
+unsigned char*
+put (unsigned char* p, Int v)
+{
+    for (std::size_t i = 0; i < sizeof (Int); ++i)
+        *p++ = static_cast <unsigned char> (v >> (8 * i));
+    return p;
+}
+
+template <class Int>
+unsigned char const*
+get (unsigned char const* p, Int& v)
+{
+    v = 0;
+    for (std::size_t i = 0; i < sizeof (Int); ++i)
+        v |= static_cast <Int> (*p++) << (8 * i);
+    return p;
+}
+
+}
+
+//------------------------------------------------------------------------------
+
+TraceWriter::TraceWriter (std::string const& path)
+    : start_ (std::chrono::steady_clock::now ())
+    , file_ (std::fopen (path.c_str (), "wb"))
+{
+    if (file_ == nullptr ||
+        std::fwrite (magic, sizeof (magic), 1, file_) != 1)
+    {
+        if (file_)
+            std::fclose (file_);
+        throw std::runtime_error ("nodestore: can't create trace " + path);
+    }
+
+    buffer_.reserve (bufferRecords * TraceRecord::bytes);
+}
+
+TraceWriter::~TraceWriter ()
+{
+    flush ();
+    std::fclose (file_);
+}
+
+void
+TraceWriter::record (TraceRecord::Op op, uint256 const& key,
+    NodeObject const* object, bool cached)
+{
+    std::uint8_t flags = 0;
+    std::uint32_t size = 0;
+    std::uint8_t type = 0;
+    if (object != nullptr)
+    {
+        flags |= TraceRecord::found;
+        size = static_cast <std::uint32_t> (object->getData ().size ());
+        type = static_cast <std::uint8_t> (object->getType ());
+    }
+    if (cached)
+        flags |= TraceRecord::cached;
+
+    // The time is filled in last
+    unsigned char r[TraceRecord::bytes];
+    unsigned char* p = r + sizeof (std::uint64_t);
+    p = put (p, size);
+    p = put (p, static_cast <std::uint8_t> (op));
+    p = put (p, flags);
+    p = put (p, type);
+    std::memcpy (p, key.begin (), key.size ());
+
+    std::lock_guard <std::mutex> lock (mutex_);
+
+    // Stamped under the lock so that times never go backwards in the file
+    std::uint64_t const time = std::chrono::duration_cast <
+        std::chrono::microseconds> (
+            std::chrono::steady_clock::now () - start_).count ();
+    put (r, time);
+
+    buffer_.insert (buffer_.end (), r, r + sizeof (r));
+    if (buffer_.size () >= bufferRecords * TraceRecord::bytes)
+        flush ();
+}
+
+void
+TraceWriter::flush ()
+{
+    // A short write only loses trace records, never node data
+    if (! buffer_.empty ())
+        std::fwrite (buffer_.data (), buffer_.size (), 1, file_);
+    buffer_.clear ();
+}
+
+//------------------------------------------------------------------------------
+
+TraceReader::TraceReader (std::string const& path)
+    : file_ (std::fopen (path.c_str (), "rb"))
+{
+    char m[sizeof (magic)];
+    if (file_ == nullptr ||
+        std::fread (m, sizeof (m), 1, file_) != 1 ||
+        std::memcmp (m, magic, sizeof (m)) != 0)
+    {
+        if (file_)
+            std::fclose (file_);
+        throw std::runtime_error ("nodestore: not a trace " + path);
+    }
+}
+
+TraceReader::~TraceReader ()
+{
+    std::fclose (file_);
+}
+
+bool
+TraceReader::next (TraceRecord& record)
+{
+    unsigned char r[TraceRecord::bytes];
+    if (std::fread (r, sizeof (r), 1, file_) != 1)
+        return false;
+
+    unsigned char const* p = r;
+    p = get (p, record.time);
+    p = get (p, record.size);
+    p = get (p, record.op);
+    p = get (p, record.flags);
+    p = get (p, record.type);
+    std::memcpy (record.key.begin (), p, record.key.size ());
+    return true;
+}
+
+void
+TraceReader::rewind ()
+{
+    std::fseek (file_, sizeof (magic), SEEK_SET);
+}
+
+}
+}
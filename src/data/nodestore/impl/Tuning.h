@@ -33,6 +33,16 @@ enum
 
     // Fraction of the cache one query source can take
     ,asyncDivider = 8
+
+    // Most queued reads one prefetch thread takes at once
+    // when the backend supports batch fetches
+    ,asyncBatchSize = 64
+
+    // Default byte budget of the fast tier, in megabytes
+    ,fastTierSizeMB = 1024
+
+    // Most objects waiting to be written to the fast tier
+    ,fastTierQueueLimit = 65536
 };
 
 }
@@ -24,6 +24,7 @@
 #include <protocol/HashPrefix.h>
 #include <lz4.h>
 #include <snappy.h>
+#include <array>
 #include <cstddef>
 #include <cstring>
 #include <utility>
@@ -127,6 +128,128 @@ lz4_compress (void const* in,
     return result;
 }
 
+// The preset dictionary for object type 4. It holds the byte runs
+// which begin and recur in serialized ledger entries, transactions
+// and metadata: the blob header and hash prefix of a leaf, entry and
+// transaction types followed by zero flags, zero directory node
+// fields, common currency codes, and the object and array markers
+// of metadata. A small blob has no history of its own for lz4 to
+// match against, so these runs are otherwise stored literally.
+//
+// This is part of the on-disk format. To change it, add a new
+// object type and keep decoding this one.
+//
+template <class = void>
+std::pair<char const*, int>
+lz4_dictionary_v1()
+{
+    static std::uint8_t const v[] =
+    {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x4d, 0x4c, 0x4e,
+        0x00, 0x11, 0x00, 0x61, 0x22, 0x00, 0x00, 0x00, 0x00, 0x24, 0x25, 0x00,
+        0x00, 0x00, 0x00, 0x2d, 0x00, 0x00, 0x00, 0x00, 0x55, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x4d, 0x4c, 0x4e, 0x00, 0x11, 0x00,
+        0x72, 0x22, 0x00, 0x00, 0x37, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x38, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x55, 0x62,
+        0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x43, 0x4e, 0x59, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+        0x66, 0xd4, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x43, 0x4e, 0x59,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x62, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x55, 0x53, 0x44, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x66, 0xd4, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x55, 0x53, 0x44, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x4d, 0x4c, 0x4e, 0x00,
+        0x11, 0x00, 0x6f, 0x22, 0x00, 0x00, 0x00, 0x00, 0x24, 0x33, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x34, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x36, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x03, 0x4d, 0x4c, 0x4e, 0x00, 0x11, 0x00, 0x64, 0x22, 0x00, 0x00, 0x00,
+        0x00, 0x58, 0x31, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x32,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x04, 0x53, 0x4e, 0x44, 0x00, 0x00, 0x12, 0x00,
+        0x00, 0x22, 0x80, 0x00, 0x00, 0x00, 0x24, 0x20, 0x1b, 0x00, 0x00, 0x00,
+        0x00, 0x61, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x68, 0x40,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x73, 0x21, 0x74, 0x46, 0x30, 0x44, 0x02,
+        0x20, 0x81, 0x14, 0x00, 0x00, 0x00, 0x00, 0x83, 0x14, 0x20, 0x1c, 0x00,
+        0x00, 0x00, 0x00, 0xf8, 0xe5, 0x11, 0x00, 0x61, 0x25, 0x56, 0x00, 0x00,
+        0x00, 0x00, 0xe7, 0x22, 0x00, 0x00, 0x00, 0x00, 0x24, 0xe1, 0xe6, 0x62,
+        0x40, 0xe1, 0xe1, 0xe5, 0x11, 0x00, 0x72, 0x25, 0xe1, 0xe1, 0xe3, 0x11,
+        0x00, 0x6f, 0x56, 0xe1, 0xe1, 0xe4, 0x11, 0x00, 0x6f, 0x56, 0xe1, 0xe1,
+        0xf1, 0x03, 0x10, 0x00
+    };
+    return { reinterpret_cast<char const*>(v), sizeof(v) };
+}
+
+template <class BufferFactory>
+std::pair<void const*, std::size_t>
+lz4_dict_decompress (void const* in,
+    std::size_t in_size, BufferFactory&& bf)
+{
+    using beast::nudb::codec_error;
+    using namespace beast::nudb::detail;
+    std::pair<void const*, std::size_t> result;
+    std::uint8_t const* p = reinterpret_cast<
+        std::uint8_t const*>(in);
+    auto const n = read_varint(
+        p, in_size, result.second);
+    if (n == 0)
+        throw codec_error(
+            "lz4 dictionary decompress");
+    void* const out = bf(result.second);
+    result.first = out;
+    auto const dict = lz4_dictionary_v1();
+    if (LZ4_decompress_safe_usingDict(
+        reinterpret_cast<char const*>(in) + n,
+            reinterpret_cast<char*>(out),
+                in_size - n, result.second,
+                    dict.first, dict.second) !=
+                        static_cast<int>(result.second))
+        throw codec_error(
+            "lz4 dictionary decompress");
+    return result;
+}
+
+// Returns the compressed size, which is not smaller
+// than in_size if the input did not compress.
+template <class BufferFactory>
+std::pair<void const*, std::size_t>
+lz4_dict_compress (void const* in,
+    std::size_t in_size, BufferFactory&& bf)
+{
+    using beast::nudb::codec_error;
+    using namespace beast::nudb::detail;
+    // Loading the dictionary resets the stream, so
+    // each thread reuses one stream for every blob.
+    thread_local LZ4_stream_t stream;
+    std::pair<void const*, std::size_t> result;
+    std::array<std::uint8_t, varint_traits<
+        std::size_t>::max> vi;
+    auto const n = write_varint(
+        vi.data(), in_size);
+    auto const out_max =
+        LZ4_compressBound(in_size);
+    std::uint8_t* out = reinterpret_cast<
+        std::uint8_t*>(bf(n + out_max));
+    result.first = out;
+    std::memcpy(out, vi.data(), n);
+    auto const dict = lz4_dictionary_v1();
+    LZ4_loadDict(&stream, dict.first, dict.second);
+    auto const out_size = LZ4_compress_fast_continue(
+        &stream, reinterpret_cast<char const*>(in),
+            reinterpret_cast<char*>(out + n),
+                in_size, out_max, 1);
+    if (out_size == 0)
+        throw codec_error(
+            "lz4 dictionary compress");
+    result.second = n + out_size;
+    return result;
+}
+
 //------------------------------------------------------------------------------
 
 /*
@@ -136,6 +259,10 @@ lz4_compress (void const* in,
     1 = lz4 compressed
     2 = inner node compressed
     3 = full inner node
+    4 = lz4 compressed with the preset dictionary v1
+
+    The type is the leading varint of every stored blob. Objects
+    are written as types 0, 2, 3 or 4; type 1 is still read.
 */
 
 template <class BufferFactory>
@@ -172,6 +299,12 @@ nodeobject_decompress (void const* in,
             p, in_size, bf);
         break;
     }
+    case 4: // lz4 with dictionary
+    {
+        result = lz4_dict_decompress(
+            p, in_size, bf);
+        break;
+    }
     case 2: // inner node
     {
         auto const hs =
@@ -262,7 +395,7 @@ nodeobject_compress (void const* in,
     using beast::nudb::codec_error;
     using namespace beast::nudb::detail;
 
-    std::size_t type = 1;
+    std::size_t type = 4;
     // Check for inner node
     if (in_size == 525)
     {
@@ -363,6 +496,37 @@ nodeobject_compress (void const* in,
         result.second = vn + lzr.second;
         break;
     }
+    case 4: // lz4 with dictionary
+    {
+        std::uint8_t* p;
+        auto const lzr = lz4_dict_compress(
+                in, in_size, [&p, &vn, &bf]
+            (std::size_t n)
+            {
+                p = reinterpret_cast<
+                    std::uint8_t*>(
+                        bf(vn + n));
+                return p + vn;
+            });
+        if (lzr.second >= in_size)
+        {
+            // Incompressible, store it as is. The buffer
+            // may be reused since the output is discarded.
+            auto const vn0 = write_varint(
+                vi.data(), 0);
+            result.second = vn0 + in_size;
+            p = reinterpret_cast<
+                std::uint8_t*>(bf(result.second));
+            result.first = p;
+            std::memcpy(p, vi.data(), vn0);
+            std::memcpy(p + vn0, in, in_size);
+            break;
+        }
+        std::memcpy(p, vi.data(), vn);
+        result.first = p;
+        result.second = vn + lzr.second;
+        break;
+    }
     default:
         throw std::logic_error(
             "nodeobject codec: unknown=" +
@@ -460,7 +624,7 @@ public:
     decompress (void const* in,
         std::size_t in_size, BufferFactory&& bf) const
     {
-        return lz4_compress(in, in_size, bf);
+        return lz4_decompress(in, in_size, bf);
     }
 
     template <class BufferFactory>
@@ -0,0 +1,171 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <data/nodestore/impl/FastTier.h>
+#include <data/nodestore/DummyScheduler.h>
+#include <beast/module/core/diagnostic/UnitTestUtilities.h>
+#include <beast/unit_test/suite.h>
+#include <boost/filesystem.hpp>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+namespace skywell {
+namespace NodeStore {
+
+// Fills a small fast tier until it rotates twice, checking that an
+// object fetched from the previous generation is promoted and survives
+// the next rotation, that one which is not fetched is dropped, and that
+// each retired generation is closed and its files removed.
+class FastTier_test : public beast::unit_test::suite
+{
+public:
+    enum
+    {
+        objectBytes = 4096,
+
+        // Just over one generation of a tier with max_size_mb = 1
+        fillCount = 130
+    };
+
+    static
+    NodeObject::Ptr
+    makeObject (std::uint32_t n, std::size_t size)
+    {
+        uint256 hash;
+        hash.begin ()[0] = 1;
+        std::memcpy (hash.begin () + 1, &n, sizeof (n));
+        Blob data (size, static_cast <unsigned char> (n));
+        return NodeObject::createObject (
+            hotACCOUNT_NODE, std::move (data), hash);
+    }
+
+    static
+    Batch
+    makeFill (std::uint32_t first)
+    {
+        Batch batch;
+        for (std::uint32_t i = 0; i < fillCount; ++i)
+            batch.push_back (makeObject (first + i, objectBytes));
+        return batch;
+    }
+
+    // The worker thread stores asynchronously, so poll for its effects
+    template <class Predicate>
+    static
+    bool
+    waitFor (Predicate pred)
+    {
+        for (int i = 0; i < 5000; ++i)
+        {
+            if (pred ())
+                return true;
+            std::this_thread::sleep_for (std::chrono::milliseconds (1));
+        }
+        return false;
+    }
+
+    static
+    bool
+    contains (FastTier& tier, NodeObject::Ptr const& object)
+    {
+        NodeObject::Ptr found;
+        return tier.fetch (object->getHash ().begin (), &found) == ok &&
+            found && found->isCloneOf (object);
+    }
+
+    static
+    std::size_t
+    countGenerations (std::string const& path)
+    {
+        namespace fs = boost::filesystem;
+        std::size_t n = 0;
+        for (fs::directory_iterator it (path), end; it != end; ++it)
+            ++n;
+        return n;
+    }
+
+    void
+    run ()
+    {
+        testcase ("promotion and rotation");
+
+        DummyScheduler scheduler;
+        beast::Journal journal;
+
+        beast::UnitTestUtilities::TempDirectory dir ("fast_tier");
+        std::string const path = dir.getFullPathName ().toStdString ();
+
+        Section params;
+        params.set ("type", "NuDB");
+        params.set ("path", path);
+        params.set ("max_size_mb", "1");
+
+        FastTier tier (params, scheduler, journal);
+
+        auto const promoted = makeObject (0, 1024);
+        auto const dropped = makeObject (1, 1024);
+        tier.store (promoted);
+        tier.store (dropped);
+        expect (waitFor ([&]{ return contains (tier, promoted) &&
+            contains (tier, dropped); }), "stored");
+
+        tier.storeBatch (makeFill (100));
+        expect (waitFor ([&]{ return tier.getRotationCount () == 1; }),
+            "first rotation");
+        expect (countGenerations (path) == 2, "two generations");
+
+        // Found in the previous generation, so queued for the current one
+        expect (contains (tier, promoted), "fetch from previous");
+        expect (tier.getPreviousHitCount () == 1, "promotion counted");
+
+        // The queue is written in order, so once this object is
+        // visible the promoted one has been written too
+        auto const marker = makeObject (2, 1024);
+        tier.store (marker);
+        expect (waitFor ([&]{ return contains (tier, marker); }),
+            "marker stored");
+
+        tier.storeBatch (makeFill (1000));
+        expect (waitFor ([&]{ return tier.getRotationCount () == 2; }),
+            "second rotation");
+
+        // The first generation was closed, which removed its files
+        expect (countGenerations (path) == 2, "retired generation removed");
+
+        expect (contains (tier, promoted), "promoted object kept");
+        expect (tier.getPreviousHitCount () == 2, "found in previous");
+
+        auto const misses = tier.getMissCount ();
+        expect (! contains (tier, dropped), "unfetched object dropped");
+        expect (tier.getMissCount () == misses + 1, "miss counted");
+
+        expect (tier.getDropCount () == 0, "nothing dropped");
+
+        tier.close ();
+        expect (countGenerations (path) == 0, "generations removed");
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(FastTier,NodeStore,skywell);
+
+}
+}
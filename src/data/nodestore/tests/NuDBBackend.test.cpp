@@ -0,0 +1,164 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <data/nodestore/backend/NuDBFactory.h>
+#include <data/nodestore/DummyScheduler.h>
+#include <beast/module/core/diagnostic/UnitTestUtilities.h>
+#include <beast/random/xor_shift_engine.h>
+#include <beast/unit_test/suite.h>
+#include <algorithm>
+#include <random>
+
+namespace skywell {
+namespace NodeStore {
+
+// Checks that NuDBBackend::fetchBatch returns each object at its key's
+// index, across the slices read by the fetch threads, both through
+// pread and through a memory-mapped key file.
+class NuDBBackend_test : public beast::unit_test::suite
+{
+public:
+    enum
+    {
+        numObjects = 2000,
+        keyBytes = 32
+    };
+
+    static
+    Batch
+    makeBatch (std::size_t count, std::uint64_t seed)
+    {
+        beast::xor_shift_engine gen (seed);
+        std::uniform_int_distribution <std::size_t> size (32, 512);
+        std::uniform_int_distribution <int> byte (0, 255);
+
+        Batch batch;
+        batch.reserve (count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            uint256 hash;
+            for (auto& b : hash)
+                b = static_cast <unsigned char> (byte (gen));
+
+            Blob data (size (gen));
+            for (auto& b : data)
+                b = static_cast <unsigned char> (byte (gen));
+
+            batch.push_back (NodeObject::createObject (
+                hotACCOUNT_NODE, std::move (data), hash));
+        }
+        return batch;
+    }
+
+    void
+    checkFetchBatch (Backend& backend, Batch const& stored,
+        Batch const& missing, std::string const& what)
+    {
+        // Interleave stored and missing keys, then shuffle them
+        std::vector <NodeObject::Ptr> expected;
+        for (std::size_t i = 0; i < stored.size (); ++i)
+        {
+            expected.push_back (stored[i]);
+            if (i < missing.size ())
+                expected.push_back (missing[i]);
+        }
+        std::shuffle (expected.begin (), expected.end (),
+            beast::xor_shift_engine (7));
+
+        std::vector <void const*> keys;
+        keys.reserve (expected.size ());
+        for (auto const& object : expected)
+            keys.push_back (object->getHash ().begin ());
+
+        auto const results = backend.fetchBatch (keys.size (), keys.data ());
+
+        if (! expect (results.size () == expected.size (),
+                what + ": result count"))
+            return;
+
+        std::size_t found = 0;
+        bool ok = true;
+        for (std::size_t i = 0; i < results.size (); ++i)
+        {
+            bool const isStored = std::find (stored.begin (), stored.end (),
+                expected[i]) != stored.end ();
+
+            if (! isStored)
+            {
+                ok = ok && ! results[i];
+                continue;
+            }
+
+            ok = ok && results[i] &&
+                results[i]->isCloneOf (expected[i]);
+            if (results[i])
+                ++found;
+        }
+
+        expect (ok, what + ": wrong objects");
+        expect (found == stored.size (), what + ": missing objects");
+    }
+
+    void
+    run ()
+    {
+        testcase ("fetchBatch");
+
+        DummyScheduler scheduler;
+        beast::Journal journal;
+
+        beast::UnitTestUtilities::TempDirectory path ("node_db");
+        Section params;
+        params.set ("path", path.getFullPathName ().toStdString ());
+        params.set ("fetch_threads", "4");
+
+        Batch const stored = makeBatch (numObjects, 1);
+        Batch const missing = makeBatch (numObjects / 4, 2);
+
+        {
+            NuDBBackend backend (keyBytes, params, scheduler, journal);
+            backend.storeBatch (stored);
+            expect (backend.canFetchBatch (), "can fetch batch");
+            checkFetchBatch (backend, stored, missing, "pool");
+        }
+
+        {
+            NuDBBackend backend (keyBytes, params, scheduler, journal);
+            checkFetchBatch (backend, stored, missing, "pread");
+
+            // Few enough keys for slices of the smallest size
+            checkFetchBatch (backend,
+                Batch (stored.begin (), stored.begin () + 10),
+                Batch (missing.begin (), missing.begin () + 3), "small");
+        }
+
+        params.set ("mmap", "1");
+        {
+            NuDBBackend backend (keyBytes, params, scheduler, journal);
+            checkFetchBatch (backend, stored, missing, "mmap");
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(NuDBBackend,NodeStore,skywell);
+
+}
+}
@@ -37,7 +37,6 @@ AcceptedLedgerTx::AcceptedLedgerTx (Ledger::ref ledger, SerialIter& sit)
     mAffected = mMeta->getAffectedAccounts ();
     mResult   =   mMeta->getResultTER ();
 
-    buildJson ();
 }
 
 AcceptedLedgerTx::AcceptedLedgerTx (Ledger::ref ledger,
@@ -49,7 +48,6 @@ AcceptedLedgerTx::AcceptedLedgerTx (Ledger::ref ledger,
     , mAffected (met->getAffectedAccounts ())
 {
     mResult = mMeta->getResultTER ();
-    buildJson ();
 }
 
 AcceptedLedgerTx::AcceptedLedgerTx (Ledger::ref ledger,
@@ -60,7 +58,6 @@ AcceptedLedgerTx::AcceptedLedgerTx (Ledger::ref ledger,
     , mResult (result)
     , mAffected (txn->getMentionedAccounts ())
 {
-    buildJson ();
 }
 
 std::string AcceptedLedgerTx::getEscMeta () const
@@ -70,22 +67,22 @@ std::string AcceptedLedgerTx::getEscMeta () const
     return sqlEscape (mRawMeta);
 }
 
-void AcceptedLedgerTx::buildJson ()
+Json::Value AcceptedLedgerTx::getJson () const
 {
-    mJson = Json::objectValue;
-    mJson[jss::transaction] = mTxn->getJson (0);
+    Json::Value ret (Json::objectValue);
+    ret[jss::transaction] = mTxn->getJson (0);
 
     if (mMeta)
     {
-        mJson[jss::meta] = mMeta->getJson (0);
-        mJson[jss::raw_meta] = strHex (mRawMeta);
+        ret[jss::meta] = mMeta->getJson (0);
+        ret[jss::raw_meta] = strHex (mRawMeta);
     }
 
-    mJson[jss::result] = transHuman (mResult);
+    ret[jss::result] = transHuman (mResult);
 
     if (!mAffected.empty ())
     {
-        Json::Value& affected = (mJson[jss::affected] = Json::arrayValue);
+        Json::Value& affected = (ret[jss::affected] = Json::arrayValue);
         for (auto const& ra : mAffected)
         {
             affected.append (ra.humanAccountID ());
@@ -103,10 +100,12 @@ void AcceptedLedgerTx::buildJson ()
             LedgerEntrySet les (mLedger, tapNONE, true);
             auto const ownerFunds (les.accountFunds (account, amount, fhIGNORE_FREEZE));
 
-            mJson[jss::transaction][jss::owner_funds] = ownerFunds.getText ();
+            ret[jss::transaction][jss::owner_funds] = ownerFunds.getText ();
         }
     }
     */
+
+    return ret;
 }
 
 } // skywell
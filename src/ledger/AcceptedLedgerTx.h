@@ -63,6 +63,11 @@ public:
     {
         return mMeta;
     }
+    /** The serialized metadata, if it was read from a ledger. */
+    Blob const& getRawMeta () const
+    {
+        return mRawMeta;
+    }
 
     std::vector <SkywellAddress> const& getAffected () const
     {
@@ -101,10 +106,10 @@ public:
 
     std::string getEscMeta () const;
 
-    Json::Value getJson () const
-    {
-        return mJson;
-    }
+    /** Describe the transaction and its effects.
+        This is built on each call, since publishing does not need it.
+    */
+    Json::Value getJson () const;
 
 private:
     Ledger::pointer                 mLedger;
@@ -113,9 +118,6 @@ private:
     TER                             mResult;
     std::vector<SkywellAddress>     mAffected;
     Blob                            mRawMeta;
-    Json::Value                     mJson;
-
-    void buildJson ();
 };
 
 } // skywell
@@ -1326,6 +1326,28 @@ void Ledger::visitStateItems (std::function<void (SLE::ref)> function) const
     }
 }
 
+void Ledger::visitStateItemsParallel (std::function<void (SLE::ref)> function) const
+{
+    try
+    {
+        if (mAccountStateMap)
+        {
+            mAccountStateMap->visitLeavesParallel(
+                std::bind(&visitHelper, std::ref(function),
+                          std::placeholders::_1));
+        }
+    }
+    catch (SHAMapMissingNode&)
+    {
+        if (mHash.isNonZero ())
+        {
+            getApp().getInboundLedgers().acquire(
+                mHash, mLedgerSeq, InboundLedger::fcGENERIC);
+        }
+        throw;
+    }
+}
+
 uint256 Ledger::getFirstLedgerIndex () const
 {
     std::shared_ptr<SHAMapItem> node = mAccountStateMap->peekFirstItem ();
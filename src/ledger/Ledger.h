@@ -300,6 +300,11 @@ public:
         std::function <bool (SLE::ref)>) const;
     void visitStateItems (std::function<void (SLE::ref)>) const;
 
+    /** Like visitStateItems, but from several threads in no particular order.
+        @see SHAMap::visitLeavesParallel
+    */
+    void visitStateItemsParallel (std::function<void (SLE::ref)>) const;
+
     // database functions (low-level)
     static Ledger::pointer loadByIndex (std::uint32_t ledgerIndex);
     static Ledger::pointer loadByHash (uint256 const& ledgerHash);
@@ -319,77 +319,59 @@ void LedgerHistory::handleMismatch (LedgerHash const& built, LedgerHash const& v
         return;
     }
 
-    // Find differences between built and valid ledgers
-    using SHAMapItemInfo = std::pair<uint256, Blob>;
-    std::vector <SHAMapItemInfo> builtTx, validTx;
-    // Get built ledger hashes and metadata
-    builtLedger->peekTransactionMap()->visitLeaves(
-        [&builtTx](std::shared_ptr<SHAMapItem> const& item)
+    // Find differences between built and valid ledgers, skipping
+    // the subtrees the two transaction maps share
+    using Difference = std::pair <std::shared_ptr<SHAMapItem>,
+                                  std::shared_ptr<SHAMapItem>>;
+    std::vector <Difference> differences;
+    std::size_t builtOnly = 0;
+    std::size_t validOnly = 0;
+    builtLedger->peekTransactionMap()->visitDeltas(
+        *validLedger->peekTransactionMap(),
+        [&](std::shared_ptr<SHAMapItem> const& built,
+            std::shared_ptr<SHAMapItem> const& valid)
         {
-            builtTx.push_back({item->getTag(), item->peekData()});
+            if (!valid)
+                ++builtOnly;
+            else if (!built)
+                ++validOnly;
+            differences.push_back({built, valid});
+            return true;
         });
-    // Get valid ledger hashes and metadata
-    validLedger->peekTransactionMap()->visitLeaves(
-        [&validTx](std::shared_ptr<SHAMapItem> const& item)
-        {
-            validTx.push_back({item->getTag(), item->peekData()});
-        });
-
-    // Sort both by hash
-    std::sort (builtTx.begin(), builtTx.end(),
-                    [](SHAMapItemInfo const& x, SHAMapItemInfo const& y)
-                        {return x.first < y.first;});
-    std::sort (validTx.begin(), validTx.end(),
-                    [](SHAMapItemInfo const& x, SHAMapItemInfo const& y)
-                        {return x.first < y.first;});
 
-    if (builtTx == validTx)
+    if (differences.empty())
     {
-        WriteLog (lsERROR, LedgerMaster) <<
-            "MISMATCH with same " << builtTx.size() << " transactions";
+        WriteLog (lsERROR, LedgerMaster) << "MISMATCH with same transactions";
         return;
     }
 
+    // Counted from the differences, since counting every transaction
+    // would walk both maps in full
     WriteLog (lsERROR, LedgerMaster) << "MISMATCH with " <<
-        builtTx.size() << " built and " <<
-        validTx.size() << " valid transactions.";
+        builtOnly << " transactions only built, " <<
+        validOnly << " only valid and " <<
+        (differences.size() - builtOnly - validOnly) <<
+        " with different metadata";
 
     // Log all differences between built and valid ledgers
-    auto b = builtTx.cbegin();
-    auto be = builtTx.cend();
-    auto v = validTx.cbegin();
-    auto ve = validTx.cend();
-    while (b != be && v != ve)
+    for (auto const& d : differences)
     {
-        if (b->first < v->first)
+        if (!d.second)
         {
-            // b->first in built but not in valid
-            log_one(builtLedger, b->first, "valid");
-            ++b;
+            // in built but not in valid
+            log_one(builtLedger, d.first->getTag(), "valid");
         }
-        else if (v->first < b->first)
+        else if (!d.first)
         {
-            // v->first in valid but not in built
-            log_one(validLedger, v->first, "built");
-            ++v;
+            // in valid but not in built
+            log_one(validLedger, d.second->getTag(), "built");
         }
-        else  // b->first == v->first, same transaction
+        else
         {
-            if (b->second != v->second)
-            {
-                // Same transaction with different metadata
-                log_metadata_difference(builtLedger, validLedger, b->first);
-            }
-            ++b;
-            ++v;
+            // Same transaction with different metadata
+            log_metadata_difference(builtLedger, validLedger, d.first->getTag());
         }
     }
-    // all of these are in built but not in valid
-    for (; b != be; ++b)
-        log_one(builtLedger, b->first, "valid");
-    // all of these are in valid but not in built
-    for (; v != ve; ++v)
-        log_one(validLedger, v->first, "built");
 }
 
 void LedgerHistory::builtLedger (Ledger::ref ledger)
@@ -20,6 +20,8 @@
 #include <BeastConfig.h>
 #include <algorithm>
 #include <cassert>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <common/misc/Utility.h>
 #include <ledger/LedgerMaster.h>
@@ -74,8 +76,13 @@ public:
 
     CanonicalTXSet mHeldTransactions;
 
-    LockType mCompleteLock;
-    RangeSet mCompleteLedgers;
+    // The ledgers we have, published as immutable snapshots so that
+    // readers do not hold a lock while they query the set. Loading the
+    // pointer still takes one of the standard library's internal locks
+    // for shared_ptr atomics, but only to copy the pointer. Writers take
+    // mCompleteLock, copy the current set, and swap in the copy.
+    std::mutex mCompleteLock;
+    std::shared_ptr <RangeSet const> mCompleteLedgers;
 
     std::unique_ptr <LedgerCleaner> mLedgerCleaner;
 
@@ -116,6 +123,7 @@ public:
         , m_journal (journal)
         , mLedgerHistory (collector)
         , mHeldTransactions (uint256 ())
+        , mCompleteLedgers (std::make_shared <RangeSet> ())
         , mLedgerCleaner (make_LedgerCleaner (*this, deprecatedLogs().journal("LedgerCleaner")))
         , mMinValidations (0)
         , mLastValidateSeq (0)
@@ -140,6 +148,21 @@ public:
     {
     }
 
+    std::shared_ptr <RangeSet const> getCompleteSnapshot () const
+    {
+        return std::atomic_load (&mCompleteLedgers);
+    }
+
+    template <class Function>
+    void updateComplete (Function&& f)
+    {
+        std::lock_guard <std::mutex> sl (mCompleteLock);
+        auto next = std::make_shared <RangeSet> (*mCompleteLedgers);
+        f (*next);
+        std::atomic_store (&mCompleteLedgers,
+            std::shared_ptr <RangeSet const> (std::move (next)));
+    }
+
     LedgerIndex getCurrentLedgerIndex ()
     {
         return mCurrentLedger.get ()->getLedgerSeq ();
@@ -435,25 +458,22 @@ public:
 
     bool haveLedgerRange (std::uint32_t from, std::uint32_t to)
     {
-        ScopedLockType sl (mCompleteLock);
-
-        std::uint32_t prevMissing = mCompleteLedgers.prevMissing (to + 1);
+        std::uint32_t prevMissing = getCompleteSnapshot ()->prevMissing (to + 1);
 
         return (prevMissing == RangeSet::absent) || (prevMissing < from);
     }
 
     bool haveLedger (std::uint32_t seq)
     {
-        ScopedLockType sl (mCompleteLock);
-
-        return mCompleteLedgers.hasValue (seq);
+        return getCompleteSnapshot ()->hasValue (seq);
     }
 
     void clearLedger (std::uint32_t seq)
     {
-        ScopedLockType sl (mCompleteLock);
-
-        return mCompleteLedgers.clearValue (seq);
+        updateComplete ([seq](RangeSet& complete)
+        {
+            complete.clearValue (seq);
+        });
     }
 
     // returns Ledgers we have all the nodes for
@@ -464,10 +484,7 @@ public:
         if (!maxVal)
             return false;
 
-        {
-            ScopedLockType sl (mCompleteLock);
-            minVal = mCompleteLedgers.prevMissing (maxVal);
-        }
+        minVal = getCompleteSnapshot ()->prevMissing (maxVal);
 
         if (minVal == RangeSet::absent)
             minVal = maxVal;
@@ -485,10 +502,7 @@ public:
         if (!maxVal)
             return false;
 
-        {
-            ScopedLockType sl (mCompleteLock);
-            minVal = mCompleteLedgers.prevMissing (maxVal);
-        }
+        minVal = getCompleteSnapshot ()->prevMissing (maxVal);
 
         if (minVal == RangeSet::absent)
             minVal = maxVal;
@@ -574,10 +588,7 @@ public:
                 if (getApp().isShutdown ())
                     return;
 
-                {
-                    ScopedLockType ml (mCompleteLock);
-                    mCompleteLedgers.setRange (minHas, maxHas);
-                }
+                setLedgerRangePresent (minHas, maxHas);
                 maxHas = minHas;
                 ledgerHashes = Ledger::getHashesByIndex ((seq < 500)
                     ? 0
@@ -595,10 +606,7 @@ public:
             prevHash = it->second.second;
         }
 
-        {
-            ScopedLockType ml (mCompleteLock);
-            mCompleteLedgers.setRange (minHas, maxHas);
-        }
+        setLedgerRangePresent (minHas, maxHas);
         {
             ScopedLockType ml (m_mutex);
             mFillInProgress = 0;
@@ -715,10 +723,10 @@ public:
 
         {
 
+            updateComplete ([&ledger](RangeSet& complete)
             {
-                ScopedLockType ml (mCompleteLock);
-                mCompleteLedgers.setValue (ledger->getLedgerSeq ());
-            }
+                complete.setValue (ledger->getLedgerSeq ());
+            });
 
             ScopedLockType ml (m_mutex);
 
@@ -1030,11 +1038,8 @@ public:
                     (mValidLedgerSeq == mPubLedgerSeq) &&
                     (getValidatedLedgerAge() < MAX_LEDGER_AGE_ACQUIRE))
                 { // We are in sync, so can acquire
-                    std::uint32_t missing;
-                    {
-                        ScopedLockType sl (mCompleteLock);
-                        missing = mCompleteLedgers.prevMissing(mPubLedger->getLedgerSeq());
-                    }
+                    std::uint32_t missing = getCompleteSnapshot ()->prevMissing (
+                        mPubLedger->getLedgerSeq());
 
                     WriteLog (lsTRACE, LedgerMaster) << "tryAdvance discovered missing " << missing;
 
@@ -1453,9 +1458,7 @@ public:
 
     std::string getCompleteLedgers ()
     {
-        ScopedLockType sl (mCompleteLock);
-
-        return mCompleteLedgers.toString ();
+        return getCompleteSnapshot ()->toString ();
     }
 
     uint256 getHashBySeq (std::uint32_t index)
@@ -1588,8 +1591,10 @@ public:
 
     void setLedgerRangePresent (std::uint32_t minV, std::uint32_t maxV)
     {
-        ScopedLockType sl (mCompleteLock);
-        mCompleteLedgers.setRange (minV, maxV);
+        updateComplete ([minV, maxV](RangeSet& complete)
+        {
+            complete.setRange (minV, maxV);
+        });
     }
     void tune (int size, int age)
     {
@@ -1618,12 +1623,14 @@ public:
 
     void clearPriorLedgers (LedgerIndex seq) override
     {
-        ScopedLockType sl (mCompleteLock);
-        for (LedgerIndex i = mCompleteLedgers.getFirst(); i < seq; ++i)
+        updateComplete ([seq](RangeSet& complete)
         {
-            if (haveLedger (i))
-                clearLedger (i);
-        }
+            for (LedgerIndex i = complete.getFirst(); i < seq; ++i)
+            {
+                if (complete.hasValue (i))
+                    complete.clearValue (i);
+            }
+        });
     }
 
     void clearLedgerCachePrior (LedgerIndex seq) override
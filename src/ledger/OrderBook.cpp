@@ -25,6 +25,7 @@
 #include <common/core/Config.h>
 #include <common/core/JobQueue.h>
 #include <protocol/Indexes.h>
+#include <algorithm>
 
 namespace skywell {
 
@@ -69,6 +70,7 @@ void OrderBookDB::setup (Ledger::ref ledger)
 }
 
 static void updateHelper (SLE::ref entry,
+    std::mutex& lock,
     hash_set< uint256 >& seen,
     OrderBookDB::IssueToOrderBook& destMap,
     OrderBookDB::IssueToOrderBook& sourceMap,
@@ -86,6 +88,9 @@ static void updateHelper (SLE::ref entry,
         book.out.currency.copyFrom (entry->getFieldH160 (sfTakerGetsCurrency));
 
         uint256 index = getBookBase (book);
+
+        // Entries arrive concurrently
+        std::lock_guard<std::mutex> sl (lock);
         if (seen.insert (index).second)
         {
             auto orderBook = std::make_shared<OrderBook> (index, book);
@@ -99,6 +104,19 @@ static void updateHelper (SLE::ref entry,
     }
 }
 
+// The walk is parallel, so put each issue's books in a fixed order
+static void sortBooks (OrderBookDB::IssueToOrderBook& books)
+{
+    for (auto& entry : books)
+    {
+        std::sort (entry.second.begin (), entry.second.end (),
+            [](OrderBook::ref lhs, OrderBook::ref rhs)
+            {
+                return lhs->getBookBase () < rhs->getBookBase ();
+            });
+    }
+}
+
 void OrderBookDB::update (Ledger::pointer ledger)
 {
     hash_set<uint256> seen;
@@ -110,11 +128,13 @@ void OrderBookDB::update (Ledger::pointer ledger)
 
     // walk through the entire ledger looking for orderbook entries
     int books = 0;
+    std::mutex lock;
 
     try
     {
-        ledger->visitStateItems(std::bind(&updateHelper, 
+        ledger->visitStateItemsParallel(std::bind(&updateHelper,
                                           std::placeholders::_1,
+                                          std::ref(lock),
                                           std::ref(seen), 
                                           std::ref(destMap),
                                           std::ref(sourceMap), 
@@ -132,6 +152,10 @@ void OrderBookDB::update (Ledger::pointer ledger)
     }
 
     WriteLog (lsDEBUG, OrderBookDB) << "OrderBookDB::update< " << books << " books found";
+
+    sortBooks (sourceMap);
+    sortBooks (destMap);
+
     {
         ScopedLockType sl (mLock);
 
@@ -232,7 +256,8 @@ BookListeners::pointer OrderBookDB::getBookListeners (Book const& book)
 // Based on the meta, send the meta to the streams that are listening.
 // We need to determine which streams a given meta effects.
 void OrderBookDB::processTxn (
-    Ledger::ref ledger, const AcceptedLedgerTx& alTx, Json::Value const& jvObj)
+    Ledger::ref ledger, const AcceptedLedgerTx& alTx,
+    std::function <Json::Value const& ()> const& jvObj)
 {
     ScopedLockType sl (mLock);
 
@@ -271,7 +296,7 @@ void OrderBookDB::processTxn (
                                  data->getFieldAmount (sfTakerPays).issue()});
 
                             if (listeners)
-                                listeners->publish (jvObj);
+                                listeners->publish (jvObj ());
                         }
                     }
                 }
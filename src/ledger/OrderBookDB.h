@@ -23,6 +23,7 @@
 #include <ledger/AcceptedLedgerTx.h>
 #include <ledger/BookListeners.h>
 #include <common/misc/OrderBook.h>
+#include <functional>
 
 namespace skywell {
 
@@ -51,9 +52,10 @@ public:
     BookListeners::pointer makeBookListeners (Book const&);
 
     // see if this txn effects any orderbook
+    // The message is only built if some book has listeners
     void processTxn (
         Ledger::ref ledger, const AcceptedLedgerTx& alTx,
-        Json::Value const& jvObj);
+        std::function <Json::Value const& ()> const& jvObj);
 
     typedef hash_map<Issue, OrderBook::List> IssueToOrderBook;
 
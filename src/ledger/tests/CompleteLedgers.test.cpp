@@ -0,0 +1,180 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <common/base/RangeSet.h>
+#include <beast/unit_test/suite.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace skywell {
+
+namespace CompleteLedgersTest {
+
+// The set of complete ledgers behind one lock, as LedgerMaster held it
+class Locked
+{
+public:
+    bool hasValue (std::uint32_t seq)
+    {
+        std::lock_guard <std::recursive_mutex> sl (mutex_);
+        return set_.hasValue (seq);
+    }
+
+    std::uint32_t prevMissing (std::uint32_t seq)
+    {
+        std::lock_guard <std::recursive_mutex> sl (mutex_);
+        return set_.prevMissing (seq);
+    }
+
+    void setValue (std::uint32_t seq)
+    {
+        std::lock_guard <std::recursive_mutex> sl (mutex_);
+        set_.setValue (seq);
+    }
+
+private:
+    std::recursive_mutex mutex_;
+    RangeSet set_;
+};
+
+// The set published as immutable snapshots, as LedgerMaster holds it now
+class Snapshot
+{
+public:
+    Snapshot ()
+        : set_ (std::make_shared <RangeSet> ())
+    {
+    }
+
+    bool hasValue (std::uint32_t seq)
+    {
+        return std::atomic_load (&set_)->hasValue (seq);
+    }
+
+    std::uint32_t prevMissing (std::uint32_t seq)
+    {
+        return std::atomic_load (&set_)->prevMissing (seq);
+    }
+
+    void setValue (std::uint32_t seq)
+    {
+        std::lock_guard <std::mutex> sl (mutex_);
+        auto next = std::make_shared <RangeSet> (*set_);
+        next->setValue (seq);
+        std::atomic_store (&set_,
+            std::shared_ptr <RangeSet const> (std::move (next)));
+    }
+
+private:
+    std::mutex mutex_;
+    std::shared_ptr <RangeSet const> set_;
+};
+
+} // CompleteLedgersTest
+
+// Readers ask whether ledgers are present, the way the RPC and peer
+// handlers do, while one writer adds a ledger every 50 microseconds.
+class CompleteLedgers_test : public beast::unit_test::suite
+{
+public:
+    typedef std::chrono::steady_clock clock_type;
+
+    template <class Set>
+    void measure (std::string const& name, int readers)
+    {
+        Set set;
+
+        // A history with gaps, so lookups walk a few ranges
+        std::uint32_t seq = 1;
+        for (; seq < 20000; ++seq)
+        {
+            if (seq % 1000 != 0)
+                set.setValue (seq);
+        }
+
+        std::atomic <bool> stop (false);
+        std::atomic <std::uint64_t> reads (0);
+
+        std::vector <std::thread> threads;
+        for (int i = 0; i < readers; ++i)
+        {
+            threads.emplace_back ([&set, &stop, &reads, i]
+            {
+                std::uint64_t n = 0;
+                std::uint32_t probe = 1 + i;
+                while (! stop.load (std::memory_order_relaxed))
+                {
+                    probe = (probe * 7919 + 1) % 20000;
+                    set.hasValue (probe);
+                    set.prevMissing (probe);
+                    n += 2;
+                }
+                reads += n;
+            });
+        }
+
+        auto const start = clock_type::now ();
+        auto const end = start + std::chrono::milliseconds (500);
+        while (clock_type::now () < end)
+        {
+            set.setValue (seq++);
+            std::this_thread::sleep_for (std::chrono::microseconds (50));
+        }
+        stop = true;
+
+        for (auto& t : threads)
+            t.join ();
+
+        using namespace std::chrono;
+        double const seconds = duration <double> (
+            clock_type::now () - start).count ();
+        log << std::setw (8) << name << " " << readers << " readers: " <<
+            std::fixed << std::setprecision (2) <<
+            reads / seconds / 1e6 << "M reads per second";
+    }
+
+    void run ()
+    {
+        using namespace CompleteLedgersTest;
+
+        unsigned const cores = std::thread::hardware_concurrency ();
+        log << cores << " hardware threads";
+
+        for (int readers : { 1, 2, 4, 8 })
+        {
+            measure <Locked> ("locked", readers);
+            measure <Snapshot> ("snapshot", readers);
+        }
+
+        pass ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(CompleteLedgers,ledger,skywell);
+
+} // skywell
@@ -68,6 +68,7 @@
 #include <services/websocket/MakeServer.h>
 #include <protocol/STParsedJSON.h>
 #include <crypto/RandomNumbers.h>
+#include <consensus/ConsensusTimings.h>
 #include <consensus/validators/make_Manager.h>
 #include <data/nodestore/backend/RocksDBQuickFactory.h>
 #include <data/nodestore/backend/RocksDBFactory.h>
@@ -172,6 +173,12 @@ public:
     {
         getApp().getOPs().missingNodeInLedger (refNum);
     }
+
+    JobQueue&
+    jobQueue() override
+    {
+        return getApp().getJobQueue();
+    }
 };
 
 } // detail
@@ -289,14 +296,16 @@ public:
     std::unique_ptr <IHashRouter> mHashRouter;
     std::unique_ptr <Validations> mValidations;
     std::unique_ptr <LoadManager> m_loadManager;
+    std::unique_ptr <ConsensusTimings> m_consensusTimings;
     beast::DeadlineTimer m_sweepTimer;
     beast::DeadlineTimer m_entropyTimer;
 
     std::unique_ptr <DatabaseCon> mTxnDB;
     std::unique_ptr <DatabaseCon> mLedgerDB;
     std::unique_ptr <DatabaseCon> mWalletDB;
+    std::unique_ptr <DatabaseCon> mValidationDB;
     std::unique_ptr <Overlay> m_overlay;
-    std::vector <std::unique_ptr<beast::Stoppable>> websocketServers_;
+    std::vector <std::unique_ptr<websocket::Listener>> websocketServers_;
 
     boost::asio::signal_set m_signals;
     beast::WaitableEvent m_stop;
@@ -408,10 +417,14 @@ public:
 
         , mHashRouter (IHashRouter::New (IHashRouter::getDefaultHoldTime ()))
 
-        , mValidations (make_Validations ())
+        , mValidations (make_Validations (setup_Validations (
+            getConfig ().section (SECTION_VALIDATION_ARCHIVE))))
 
         , m_loadManager (make_LoadManager (*this, m_logs.journal("LoadManager")))
 
+        , m_consensusTimings (std::make_unique <ConsensusTimings> (
+            m_collectorManager->group ("consensus")))
+
         , m_sweepTimer (this)
 
         , m_entropyTimer (this)
@@ -442,6 +455,8 @@ public:
 
         //  HACK
         m_nodeStoreScheduler.setJobQueue (*m_jobQueue);
+        m_nodeStoreScheduler.setCollector (
+            m_collectorManager->group ("nodestore"));
 
         add (*m_validators);
         add (m_ledgerMaster->getPropertySource ());
@@ -593,6 +608,11 @@ public:
         return *m_shaMapStore;
     }
 
+    ConsensusTimings& getConsensusTimings () override
+    {
+        return *m_consensusTimings;
+    }
+
     Overlay& overlay ()
     {
         return *m_overlay;
@@ -618,6 +638,12 @@ public:
         assert (mLedgerDB.get() != nullptr);
         return *mLedgerDB;
     }
+    DatabaseCon& getValidationDB ()
+    {
+        if (mValidationDB)
+            return *mValidationDB;
+        return getLedgerDB ();
+    }
     DatabaseCon& getWalletDB ()
     {
         assert (mWalletDB.get() != nullptr);
@@ -666,6 +692,11 @@ public:
 		mWalletDB = std::make_unique <DatabaseCon>(setup, "wallet",
 			WalletDBInit, WalletDBCount);
 
+		// Validations share the ledger database unless given their own
+		if (!setup.mysqlStrings[3].empty ())
+			mValidationDB = std::make_unique <DatabaseCon>(setup, "validation",
+				ValidationDBInit, ValidationDBCount);
+
 		return
 			mTxnDB.get() != nullptr &&
 			mLedgerDB.get() != nullptr &&
@@ -745,6 +776,8 @@ public:
 		*/
         mTxnDB->setupCheckpointing (m_jobQueue.get());
         mLedgerDB->setupCheckpointing (m_jobQueue.get());
+        if (mValidationDB)
+            mValidationDB->setupCheckpointing (m_jobQueue.get());
 
         if (!getConfig ().RUN_STANDALONE)
             updateTables ();
@@ -846,6 +879,7 @@ public:
                     port.name << "]";
                 throw std::exception();
             }
+            add (*server); // add to PropertyStream
             websocketServers_.emplace_back (std::move (server));
         }
 
@@ -1596,7 +1630,16 @@ void ApplicationImp::updateTables ()
             "Node import from '" << source->getName () << "' to '"
                                  << getApp().getNodeStore().getName () << "'.";
 
-        getApp().getNodeStore().import (*source);
+        NodeStore::ImportReport const report =
+            getApp().getNodeStore().import (*source, NodeStore::ImportOptions (
+                getConfig ()[ConfigSection::importNodeDatabase ()]));
+
+        WriteLog (lsWARNING, NodeObject) <<
+            "Node import copied " << report.objects << " objects (" <<
+            report.bytes << " bytes) in " << report.elapsed.count () << "ms" <<
+            ", resumed after " << report.skipped <<
+            ", " << report.corrupt << " corrupt of " << report.verified <<
+            " verified.";
     }
 }
 
@@ -39,6 +39,7 @@ namespace RPC { class Manager; }
 //  TODO Fix forward declares required for header dependency loops
 class AmendmentTable;
 class CollectorManager;
+class ConsensusTimings;
 namespace shamap {
 class Family;
 } // shamap
@@ -114,10 +115,18 @@ public:
     virtual Resource::Manager&      getResourceManager () = 0;
     virtual PathRequests&           getPathRequests () = 0;
     virtual SHAMapStore&            getSHAMapStore () = 0;
+    virtual ConsensusTimings&       getConsensusTimings () = 0;
 
     virtual DatabaseCon& getTxnDB () = 0;
     virtual DatabaseCon& getLedgerDB () = 0;
 
+    /** Retrieve the database which archives stale validations.
+
+        This is the ledger database unless [mysql_config] has a fourth
+        connection string for a separate one.
+    */
+    virtual DatabaseCon& getValidationDB () = 0;
+
     virtual std::chrono::milliseconds getIOLatency () = 0;
 
     /** Retrieve the "wallet database"
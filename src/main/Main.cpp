@@ -34,6 +34,9 @@
 #include <common/core/Config.h>
 #include <common/core/ConfigSections.h>
 #include <common/json/to_string.h>
+#include <data/nodestore/DummyScheduler.h>
+#include <data/nodestore/Manager.h>
+#include <data/nodestore/Replay.h>
 #include <network/resource/Fees.h>
 #include <services/net/RPCCall.h>
 #include <services/rpc/RPCHandler.h>
@@ -87,7 +90,8 @@ void startServer ()
             }
 
             Resource::Charge loadType = Resource::feeReferenceRPC;
-            RPC::Context context {jvCommand, loadType, getApp().getOPs (), Role::ADMIN};
+            RPC::Context context {jvCommand, loadType, getApp().getOPs (),
+                Role::ADMIN, nullptr, {}, {}, {}};
 
             Json::Value jvResult;
             RPC::doCommand (context, jvResult);
@@ -122,6 +126,7 @@ void printHelp (const po::options_description& desc)
 		"     can_delete [<ledgerid>|<ledgerhash>|now|always|never]\n"
 		"     connect <ip> [<port>]\n"
 		"     consensus_info\n"
+		"     consensus_timings [<limit>]\n"
 		"     data_info\n"
 		"     get_counts\n"
 		"     json <method> <json>\n"
@@ -226,6 +231,126 @@ static int runUnitTests (std::string const& pattern,
     return EXIT_SUCCESS;
 }
 
+/** Copy the import node database into the node database, then exit.
+
+    Unlike --import this does not start the server, so the copy gets the
+    whole machine. An interrupted run resumes from its checkpoint.
+*/
+static int runMigration ()
+{
+    Section const& from = getConfig ()[ConfigSection::importNodeDatabase ()];
+    Section const& to = getConfig ()[ConfigSection::nodeDatabase ()];
+
+    if (! getConfig ().exists (ConfigSection::importNodeDatabase ()) ||
+        ! getConfig ().exists (ConfigSection::nodeDatabase ()))
+    {
+        std::cerr << "Both the [" << ConfigSection::importNodeDatabase () <<
+            "] and [" << ConfigSection::nodeDatabase () <<
+            "] sections are required." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // With online deletion the store is split into rotating backends
+    // whose locations are kept in the state database.
+    if (to.exists ("online_delete"))
+    {
+        std::cerr << "Cannot migrate into a node database with " <<
+            "online_delete, use --import instead." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    beast::Journal journal (deprecatedLogs ().journal ("NodeObject"));
+
+    try
+    {
+        NodeStore::DummyScheduler scheduler;
+        std::unique_ptr <NodeStore::Database> source =
+            NodeStore::Manager::instance ().make_Database ("NodeStore.import",
+                scheduler, journal, 0, from);
+        std::unique_ptr <NodeStore::Backend> dest =
+            NodeStore::Manager::instance ().make_Backend (to, scheduler, journal);
+
+        std::cerr << "Migrating node objects from '" << source->getName () <<
+            "' to '" << dest->getName () << "'." << std::endl;
+
+        NodeStore::ImportReport const report = NodeStore::importObjects (
+            *source, *dest, NodeStore::ImportOptions (from), journal);
+
+        std::cerr << "Copied " << report.objects << " objects (" <<
+            report.bytes << " bytes) in " << report.elapsed.count () << "ms" <<
+            ", resumed after " << report.skipped <<
+            ", " << report.corrupt << " corrupt of " << report.verified <<
+            " verified." << std::endl;
+
+        return report.corrupt ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "Migration failed: " << e.what () << std::endl;
+    }
+
+    return EXIT_FAILURE;
+}
+
+/** Replay a node store trace against the benchmark backend, then exit.
+
+    The backend is created from scratch and removed afterwards, so any
+    type can be measured against the same recorded workload.
+*/
+static int runBenchmark (std::string const& trace)
+{
+    Section const& config =
+        getConfig ()[ConfigSection::benchmarkNodeDatabase ()];
+
+    if (! getConfig ().exists (ConfigSection::benchmarkNodeDatabase ()))
+    {
+        std::cerr << "The [" << ConfigSection::benchmarkNodeDatabase () <<
+            "] section is required." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    beast::Journal journal (deprecatedLogs ().journal ("NodeObject"));
+
+    try
+    {
+        NodeStore::DummyScheduler scheduler;
+        std::unique_ptr <NodeStore::Backend> backend =
+            NodeStore::Manager::instance ().make_Backend (
+                config, scheduler, journal);
+        backend->setDeletePath ();
+
+        std::cerr << "Replaying '" << trace << "' against '" <<
+            backend->getName () << "'." << std::endl;
+
+        NodeStore::ReplayReport const report = NodeStore::replayTrace (
+            trace, *backend, NodeStore::ReplayOptions (config), journal);
+
+        auto const print = [](char const* name,
+            NodeStore::ReplayLatency const& l)
+        {
+            std::cerr << name << ": " << l.count << " ops, us p50 " <<
+                l.p50.count () << " p90 " << l.p90.count () <<
+                " p99 " << l.p99.count () << " p99.9 " << l.p999.count () <<
+                " max " << l.max.count () << std::endl;
+        };
+
+        std::cerr << "Replayed in " << report.elapsed.count () << "ms after " <<
+            "preloading " << report.preloaded << " objects, " <<
+            report.mismatched << " fetches differed from the trace." <<
+            std::endl;
+        print ("fetch", report.fetch);
+        print ("store", report.store);
+
+        return EXIT_SUCCESS;
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "Benchmark failed: " << e.what () << std::endl;
+    }
+
+    return EXIT_FAILURE;
+}
+
 //------------------------------------------------------------------------------
 
 int run (int argc, char** argv)
@@ -277,6 +402,8 @@ int run (int argc, char** argv)
     ("net"          , "Get the initial ledger from the network.")
     ("fg"           , "Run in the foreground.")
     ("import"       , importText.c_str ())
+    ("migrate"      , "Like --import, but copy without starting the server and exit when done.")
+    ("benchmark"    , po::value<std::string> (), "Replay a node store trace against the [benchmark_db] backend and exit.")
     ("version"      , "Display the build version.")
     ;
 
@@ -349,6 +476,8 @@ int run (int argc, char** argv)
         && !vm.count ("fg")
         && !vm.count ("standalone")
         && !vm.count ("shutdowntest")
+        && !vm.count ("migrate")
+        && !vm.count ("benchmark")
         && !vm.count ("unittest"))
     {
         std::string logMe = DoSustain (getConfig ().getDebugLogFile ().string ());
@@ -412,6 +541,12 @@ int run (int argc, char** argv)
         getConfig ().doImport = true;
     }
 
+    if (!iResult && vm.count ("migrate"))
+        return runMigration ();
+
+    if (!iResult && vm.count ("benchmark"))
+        return runBenchmark (vm["benchmark"].as<std::string> ());
+
     if (vm.count ("ledger"))
     {
         getConfig ().START_LEDGER = vm["ledger"].as<std::string> ();
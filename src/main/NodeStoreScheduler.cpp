@@ -35,6 +35,14 @@ void NodeStoreScheduler::setJobQueue (JobQueue& jobQueue)
     m_jobQueue = &jobQueue;
 }
 
+void NodeStoreScheduler::setCollector (
+    beast::insight::Collector::ptr const& collector)
+{
+    m_persistTime = collector->make_event ("ledger_persist");
+    m_syncTime = collector->make_event ("ledger_sync");
+    m_persistCount = collector->make_event ("ledger_objects");
+}
+
 void NodeStoreScheduler::onStop ()
 {
 }
@@ -67,7 +75,8 @@ void NodeStoreScheduler::onFetch (NodeStore::FetchReport const& report)
 {
     if (report.wentToDisk)
     {
-        m_jobQueue->addLoadEvents (report.isAsync ? jtNS_ASYNC_READ : jtNS_SYNC_READ, 1, report.elapsed);
+        m_jobQueue->addLoadEvents (report.isAsync ? jtNS_ASYNC_READ : jtNS_SYNC_READ,
+            report.fetchCount, report.elapsed);
     }
 }
 
@@ -76,4 +85,14 @@ void NodeStoreScheduler::onBatchWrite (NodeStore::BatchWriteReport const& report
     m_jobQueue->addLoadEvents (jtNS_WRITE, report.writeCount, report.elapsed);
 }
 
+void NodeStoreScheduler::onGroupCommit (NodeStore::GroupCommitReport const& report)
+{
+    m_jobQueue->addLoadEvents (jtNS_WRITE, report.writeCount, report.elapsed);
+
+    m_persistTime.notify (report.elapsed);
+    m_syncTime.notify (report.syncElapsed);
+    m_persistCount.notify (static_cast <beast::insight::Event::value_type> (
+        report.writeCount));
+}
+
 } // skywell
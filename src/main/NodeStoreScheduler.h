@@ -23,6 +23,7 @@
 #include <data/nodestore/Scheduler.h>
 #include <common/core/JobQueue.h>
 #include <beast/threads/Stoppable.h>
+#include <beast/Insight.h>
 #include <atomic>
 
 namespace skywell {
@@ -40,17 +41,25 @@ public:
     //
     void setJobQueue (JobQueue& jobQueue);
 
+    /** Report per-ledger group commit statistics to insight. */
+    void setCollector (beast::insight::Collector::ptr const& collector);
+
     void onStop ();
     void onChildrenStopped ();
     void scheduleTask (NodeStore::Task& task);
     void onFetch (NodeStore::FetchReport const& report) override;
     void onBatchWrite (NodeStore::BatchWriteReport const& report) override;
+    void onGroupCommit (NodeStore::GroupCommitReport const& report) override;
 
 private:
     void doTask (NodeStore::Task& task, Job&);
 
     JobQueue* m_jobQueue;
     std::atomic<int> m_taskCount;
+
+    beast::insight::Event m_persistTime;
+    beast::insight::Event m_syncTime;
+    beast::insight::Event m_persistCount;
 };
 
 } // skywell
@@ -65,6 +65,7 @@ JSS ( account_index );              // in: AccountCurrencies, AccountOffers,
                                     //     AccountInfo, AccountLines,
                                     //     AccountObjects, OwnerInfo
                                     // out: AccountOffers
+JSS ( account_nodes );              // out: ConsensusTimings
 JSS ( account_objects );            // out: AccountObjects
 JSS ( account_root );               // in: LedgerEntry
 JSS ( accounts );                   // in: LedgerEntry, Subscribe,
@@ -91,6 +92,7 @@ JSS ( both );                       // in: Subscribe, Unsubscribe
 JSS ( both_sides );                 // in: Subscribe, Unsubscribe
 JSS ( build_path );                 // in: TransactionSign
 JSS ( build_version );              // out: NetworkOPs
+JSS ( bytes_written );              // out: ConsensusTimings
 JSS ( can_delete );                 // out: CanDelete
 JSS ( check_nodes );                // in: LedgerCleaner
 JSS ( clear );                      // in/out: FetchInfo
@@ -274,6 +276,7 @@ JSS ( peer_authorized );            // out: AccountLines
 JSS ( peer_id );                    // out: LedgerProposal
 JSS ( peer_index );                 // in/out: AccountLines
 JSS ( peers );                      // out: InboundLedger, handlers/Peers
+JSS ( phases );                     // out: ConsensusTimings
 JSS ( port );                       // in: Connect
 JSS ( previous_ledger );            // out: LedgerPropose
 JSS ( proof );                      // in: BookOffers
@@ -284,6 +287,7 @@ JSS ( pubkey_node );                // out: NetworkOPs
 JSS ( pubkey_validator );           // out: NetworkOPs
 JSS ( public_key );                 // out: OverlayImpl, PeerImp, WalletPropose
 JSS ( public_key_hex );             // out: WalletPropose
+JSS ( publish );                    // out: ConsensusTimings
 JSS ( published_ledger );           // out: NetworkOPs
 JSS ( quality );                    // out: NetworkOPs
 JSS ( quality_in );                 // out: AccountLines
@@ -307,6 +311,7 @@ JSS ( manager_account );            // out: NetworkOPs
 JSS ( issuerop_account );           // out: NetworkOPs
 JSS ( response );                   // websocket
 JSS ( result );                     // RPC
+JSS ( rounds );                     // out: ConsensusTimings
 JSS ( skywell_lines );              // out: NetworkOPs
 JSS ( skywell_state );              // in: LedgerEntr
 JSS ( rt_accounts );                // in: Subscribe, Unsubscribe
@@ -353,6 +358,7 @@ JSS ( transTreeHash );              // out: ledger/Ledger.cpp
 JSS ( transaction );                // in: Tx
                                     // out: NetworkOPs, AcceptedLedgerTx,
 JSS ( transaction_hash );           // out: LedgerProposal, LedgerToJson
+JSS ( transaction_nodes );          // out: ConsensusTimings
 JSS ( transactions );               // out: LedgerToJson,
                                     // in: AccountTx*, Unsubscribe
 JSS ( treenode_cache_size );        // out: GetCounts
@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef SKYWELL_PROTOCOL_MULDIV_H_INCLUDED
+#define SKYWELL_PROTOCOL_MULDIV_H_INCLUDED
+
+#include <cstdint>
+#include <stdexcept>
+
+namespace skywell {
+namespace detail {
+
+// Compute (a * b + c) / d with 64 bit halves, whose quotient must fit in
+// 64 bits. Used where the compiler has no 128 bit integer type.
+inline
+std::uint64_t
+mulDivPortable (std::uint64_t a, std::uint64_t b,
+    std::uint64_t c, std::uint64_t d)
+{
+    // Form the 128 bit product in hi:lo from 32 bit halves
+    std::uint64_t const aLo = a & 0xffffffff, aHi = a >> 32;
+    std::uint64_t const bLo = b & 0xffffffff, bHi = b >> 32;
+
+    std::uint64_t const ll = aLo * bLo;
+    std::uint64_t const lh = aLo * bHi;
+    std::uint64_t const hl = aHi * bLo;
+    std::uint64_t const mid = (ll >> 32) + (lh & 0xffffffff) + (hl & 0xffffffff);
+
+    std::uint64_t lo = (mid << 32) | (ll & 0xffffffff);
+    std::uint64_t hi = aHi * bHi + (lh >> 32) + (hl >> 32) + (mid >> 32);
+
+    lo += c;
+    if (lo < c)
+        ++hi;
+
+    if (hi >= d)
+        throw std::runtime_error ("Value overflow");
+
+    // Long division, one quotient bit per step
+    std::uint64_t q = 0;
+    for (int i = 0; i < 64; ++i)
+    {
+        bool const carry = (hi >> 63) != 0;
+        hi = (hi << 1) | (lo >> 63);
+        lo <<= 1;
+        q <<= 1;
+
+        if (carry || hi >= d)
+        {
+            hi -= d;
+            q |= 1;
+        }
+    }
+    return q;
+}
+
+#if defined(__SIZEOF_INT128__)
+// Compute (a * b + c) / d with the compiler's 128 bit integer
+inline
+std::uint64_t
+mulDivWide (std::uint64_t a, std::uint64_t b,
+    std::uint64_t c, std::uint64_t d)
+{
+    unsigned __int128 const v = static_cast<unsigned __int128> (a) * b + c;
+
+    if ((v >> 64) >= d)
+        throw std::runtime_error ("Value overflow");
+
+    return static_cast<std::uint64_t> (v / d);
+}
+#endif
+
+/** Compute (a * b + c) / d without losing the high bits of the product.
+
+    Throws std::runtime_error if the quotient does not fit in 64 bits.
+*/
+inline
+std::uint64_t
+mulDiv (std::uint64_t a, std::uint64_t b, std::uint64_t c, std::uint64_t d)
+{
+#if defined(__SIZEOF_INT128__)
+    return mulDivWide (a, b, c, d);
+#else
+    return mulDivPortable (a, b, c, d);
+#endif
+}
+
+} // detail
+} // skywell
+
+#endif
@@ -28,10 +28,11 @@ namespace skywell {
 
 // These must stay at the top of this file, and in this order
 // Files-cope statics are preferred here because the SFields must be
-// file-scope.  The following 3 objects must have scope prior to
+// file-scope.  The following 4 objects must have scope prior to
 // the file-scope SFields.
 static std::mutex SField_mutex;
 static std::map<int, SField const*> knownCodeToField;
+static std::map<std::string, SField const*> knownNameToField;
 static std::map<int, std::unique_ptr<SField const>> unknownCodeToField;
 
 int SField::num = 0;
@@ -46,6 +47,8 @@ struct SField::make
     {
         SField result(std::forward<Args>(args)...);
         knownCodeToField[result.fieldCode] = p;
+        if (!result.fieldName.empty ())
+            knownNameToField[result.fieldName] = p;
         return result;
     }
 
@@ -54,6 +57,8 @@ struct SField::make
     {
         TypedField<T> result(std::forward<Args>(args)...);
         knownCodeToField[result.fieldCode] = p;
+        if (!result.fieldName.empty ())
+            knownNameToField[result.fieldName] = p;
         return result;
     }
 };
@@ -381,11 +386,11 @@ std::string SField::getName () const
 SField const&
 SField::getField (std::string const& fieldName)
 {
-    for (auto const & fieldPair : knownCodeToField)
-    {
-        if (fieldPair.second->fieldName == fieldName)
-            return * (fieldPair.second);
-    }
+    auto it = knownNameToField.find (fieldName);
+
+    if (it != knownNameToField.end ())
+        return * (it->second);
+
     {
         StaticScopedLockType sl (SField_mutex);
 
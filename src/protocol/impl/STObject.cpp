@@ -123,7 +123,12 @@ bool STObject::setType (const SOTemplate& type)
                 valid = false;
             }
             v.emplace_back(std::move(*iter));
-            v_.erase(iter);
+
+            // Order of the unmatched fields does not matter, so fill
+            // the hole from the back instead of shifting everything
+            if (iter != std::prev (v_.end ()))
+                *iter = std::move (v_.back ());
+            v_.pop_back ();
         }
         else
         {
@@ -183,6 +188,12 @@ bool STObject::set (SerialIter& sit, int depth)
 
     v_.clear();
 
+    // Top level objects (transactions, ledger entries, validations) are
+    // large enough that growing one field at a time reallocates several
+    // times. Nested objects are usually small, so they are left alone.
+    if (depth == 0)
+        v_.reserve (reserveSize);
+
     // Consume data in the pipe until we run out or reach the end
     //
     while (!reachedEndOfObject && !sit.empty ())
@@ -139,24 +139,18 @@ static Json::Value singleton_expected (std::string const& object,
 
 
 // This function is used by parseObject to parse any JSON type that doesn't
-// recurse.  Everything represented here is a leaf-type.
+// recurse.  Everything represented here is a leaf-type. The caller has
+// already resolved fieldName to a valid field.
 static boost::optional<detail::STVar> parseLeaf (
     std::string const& json_name,
     std::string const& fieldName,
+    SField const& field,
     SField const* name,
     Json::Value const& value,
     Json::Value& error)
 {
     boost::optional <detail::STVar> ret;
 
-    auto const& field = SField::getField (fieldName);
-
-    if (field == sfInvalid)
-    {
-        error = unknown_field (json_name, fieldName);
-        return ret;
-    }
-
     switch (field.fieldType)
     {
     case STI_UINT8:
@@ -689,9 +683,12 @@ static boost::optional <STObject> parseObject (
 
     STObject data (inName);
 
-    for (auto const& fieldName : json.getMemberNames ())
+    // Walk the members directly rather than copying their names
+    // and looking each one up again
+    for (auto it = json.begin (); it != json.end (); ++it)
     {
-        Json::Value const& value = json [fieldName];
+        std::string const fieldName (it.memberName ());
+        Json::Value const& value = *it;
 
         auto const& field = SField::getField (fieldName);
 
@@ -753,7 +750,7 @@ static boost::optional <STObject> parseObject (
         default:
             {
                 auto leaf =
-                    parseLeaf (json_name, fieldName, &inName, value, error);
+                    parseLeaf (json_name, fieldName, field, &inName, value, error);
 
                 if (!leaf)
                     return boost::none;
@@ -802,10 +799,8 @@ static boost::optional <detail::STVar> parseArray (
                 return boost::none;
             }
 
-            // TODO: There doesn't seem to be a nice way to get just the
-            // first/only key in an object without copying all keys into
-            // a vector
-            std::string const objectName (json[i].getMemberNames()[0]);;
+            auto const        member (json[i].begin ());
+            std::string const objectName (member.memberName ());
             auto const&       nameField (SField::getField(objectName));
 
             if (nameField == sfInvalid)
@@ -814,7 +809,7 @@ static boost::optional <detail::STVar> parseArray (
                 return boost::none;
             }
 
-            Json::Value const objectFields (json[i][objectName]);
+            Json::Value const& objectFields (*member);
 
             std::stringstream ss;
             ss << json_name << "." <<
@@ -33,6 +33,7 @@
 #include <openssl/ripemd.h>
 #include <openssl/pem.h>
 #include <algorithm>
+#include <array>
 #include <mutex>
 
 namespace skywell {
@@ -354,18 +355,100 @@ Account SkywellAddress::getAccountID () const
     }
 }
 
-typedef std::mutex StaticLockType;
-typedef std::lock_guard <StaticLockType> StaticScopedLockType;
+namespace {
 
-static StaticLockType s_lock;
-static hash_map <Blob, std::string> rncMapOld, rncMapNew;
+/** Rendered account IDs, split into shards with a lock each.
+    Each shard keeps two generations. A lookup that hits the old one
+    moves the entry to the new one, and when the new one fills up the
+    old one is dropped.
+*/
+class AccountIDCache
+{
+public:
+    bool
+    find (Blob const& id, std::string& text)
+    {
+        Shard& shard = shardFor (id);
+        std::lock_guard <std::mutex> sl (shard.lock);
+
+        auto it = shard.mapNew.find (id);
+        if (it != shard.mapNew.end ())
+        {
+            text = it->second;
+            return true;
+        }
+
+        it = shard.mapOld.find (id);
+        if (it == shard.mapOld.end ())
+            return false;
+
+        text = it->second;
+        shard.mapOld.erase (it);
+        insert (shard, id, text);
+        return true;
+    }
+
+    void
+    insert (Blob const& id, std::string const& text)
+    {
+        Shard& shard = shardFor (id);
+        std::lock_guard <std::mutex> sl (shard.lock);
+        insert (shard, id, text);
+    }
+
+    void
+    clear ()
+    {
+        for (auto& shard : shards_)
+        {
+            std::lock_guard <std::mutex> sl (shard.lock);
+            shard.mapOld.clear ();
+            shard.mapNew.clear ();
+        }
+    }
+
+private:
+    static std::size_t const shardCount = 16;
+    static std::size_t const shardSize = 128000 / shardCount;
+
+    struct Shard
+    {
+        std::mutex lock;
+        hash_map <Blob, std::string> mapOld;
+        hash_map <Blob, std::string> mapNew;
+    };
+
+    Shard&
+    shardFor (Blob const& id)
+    {
+        // Account IDs are hashes, so any byte spreads them evenly
+        return shards_[id.empty () ? 0 : id.back () % shardCount];
+    }
+
+    static
+    void
+    insert (Shard& shard, Blob const& id, std::string const& text)
+    {
+        if (shard.mapNew.size () >= shardSize)
+        {
+            shard.mapOld = std::move (shard.mapNew);
+            shard.mapNew.clear ();
+            shard.mapNew.reserve (shardSize);
+        }
+
+        shard.mapNew[id] = text;
+    }
+
+    std::array <Shard, shardCount> shards_;
+};
+
+AccountIDCache accountIDCache;
+
+}
 
 void SkywellAddress::clearCache ()
 {
-    StaticScopedLockType sl (s_lock);
-
-    rncMapOld.clear ();
-    rncMapNew.clear ();
+    accountIDCache.clear ();
 }
 
 std::string SkywellAddress::humanAccountID () const
@@ -379,37 +462,11 @@ std::string SkywellAddress::humanAccountID () const
     {
         std::string ret;
 
+        // Render outside the lock, since that is the expensive part
+        if (!accountIDCache.find (vchData, ret))
         {
-            StaticScopedLockType sl (s_lock);
-
-            auto it = rncMapNew.find (vchData);
-
-            if (it != rncMapNew.end ())
-            {
-                // Found in new map, nothing to do
-                ret = it->second;
-            }
-            else
-            {
-                it = rncMapOld.find (vchData);
-
-                if (it != rncMapOld.end ())
-                {
-                    ret = it->second;
-                    rncMapOld.erase (it);
-                }
-                else
-                    ret = ToString ();
-
-                if (rncMapNew.size () >= 128000)
-                {
-                    rncMapOld = std::move (rncMapNew);
-                    rncMapNew.clear ();
-                    rncMapNew.reserve (128000);
-                }
-
-                rncMapNew[vchData] = ret;
-            }
+            ret = ToString ();
+            accountIDCache.insert (vchData, ret);
         }
 
         return ret;
@@ -0,0 +1,378 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <protocol/STAmount.h>
+#include <protocol/impl/MulDiv.h>
+#include <crypto/CBigNum.h>
+#include <beast/unit_test/suite.h>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace skywell {
+
+class MulDiv_test : public beast::unit_test::suite
+{
+public:
+    static std::uint64_t const tenTo14 = 100000000000000ull;
+    static std::uint64_t const tenTo17 = tenTo14 * 1000;
+
+    // The BIGNUM sequence STAmount used before mulDiv
+    static
+    std::uint64_t
+    bigMulDiv (std::uint64_t a, std::uint64_t b,
+        std::uint64_t c, std::uint64_t d)
+    {
+        CBigNum v;
+
+        if ((BN_add_word64 (&v, a) != 1) || (BN_mul_word64 (&v, b) != 1))
+            throw std::runtime_error ("internal bn error");
+
+        if (c != 0)
+            BN_add_word64 (&v, c);
+
+        if (BN_div_word64 (&v, d) == ((std::uint64_t) - 1))
+            throw std::runtime_error ("internal bn error");
+
+        if (BN_num_bits (&v) > 64)
+            throw std::runtime_error ("Value overflow");
+
+        return v.getuint64 ();
+    }
+
+    template <class MulDiv>
+    void
+    check (char const* name, MulDiv mulDiv, std::uint64_t a,
+        std::uint64_t b, std::uint64_t c, std::uint64_t d)
+    {
+        bool expected = true;
+        std::uint64_t want = 0;
+        try
+        {
+            want = bigMulDiv (a, b, c, d);
+        }
+        catch (std::runtime_error const&)
+        {
+            expected = false;
+        }
+
+        try
+        {
+            std::uint64_t const got = mulDiv (a, b, c, d);
+            if (! expect (expected && got == want, name))
+                log << name << ": " << a << " * " << b << " + " << c <<
+                    " / " << d << " = " << got << ", wanted " << want;
+        }
+        catch (std::runtime_error const&)
+        {
+            expect (! expected, name);
+        }
+    }
+
+    void
+    checkBoth (std::uint64_t a, std::uint64_t b,
+        std::uint64_t c, std::uint64_t d)
+    {
+        check ("portable", &detail::mulDivPortable, a, b, c, d);
+#if defined(__SIZEOF_INT128__)
+        check ("wide", &detail::mulDivWide, a, b, c, d);
+#endif
+    }
+
+    void testEdges ()
+    {
+        testcase ("edges");
+
+        std::vector <std::uint64_t> const values = {
+            1, 2, 9, 10, 0xffffffffull, 0x100000000ull,
+            STAmount::cMinValue, STAmount::cMinValue + 1,
+            STAmount::cMaxValue - 1, STAmount::cMaxValue,
+            STAmount::cMaxNativeN, STAmount::cMaxNative,
+            tenTo14, tenTo17, 0x7fffffffffffffffull,
+            0xfffffffffffffffeull, 0xffffffffffffffffull };
+
+        for (auto a : values)
+        {
+            for (auto b : values)
+            {
+                for (auto d : values)
+                {
+                    checkBoth (a, b, 0, d);
+                    checkBoth (a, b, d - 1, d);
+                }
+                checkBoth (a, b, tenTo14 - 1, tenTo14);
+            }
+        }
+    }
+
+    void testRandom ()
+    {
+        testcase ("random");
+
+        std::mt19937_64 gen;
+        std::uniform_int_distribution <std::uint64_t> mantissa (
+            STAmount::cMinValue, STAmount::cMaxValue);
+        std::uniform_int_distribution <std::uint64_t> any;
+
+        for (int i = 0; i < 100000; ++i)
+        {
+            auto const a = mantissa (gen);
+            auto const b = mantissa (gen);
+            auto const d = mantissa (gen);
+
+            // The products multiply and divide form, with both roundings
+            checkBoth (a, b, 0, tenTo14);
+            checkBoth (a, b, tenTo14 - 1, tenTo14);
+            checkBoth (a, tenTo17, 0, d);
+            checkBoth (a, tenTo17, d - 1, d);
+
+            // Arbitrary operands, most of which overflow
+            auto const x = any (gen);
+            checkBoth (x, any (gen) >> (i % 64), any (gen) >> (i % 64),
+                (any (gen) >> (i % 64)) | 1);
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    // The rounding helper STAmount applies after the divide
+    static
+    void
+    canonicalizeRound (bool native, std::uint64_t& value,
+        int& offset, bool roundUp)
+    {
+        if (!roundUp)
+            return;
+
+        if (native)
+        {
+            if (offset < 0)
+            {
+                int loops = 0;
+
+                while (offset < -1)
+                {
+                    value /= 10;
+                    ++offset;
+                    ++loops;
+                }
+
+                value += (loops >= 2) ? 9 : 10;
+                value /= 10;
+                ++offset;
+            }
+        }
+        else if (value > STAmount::cMaxValue)
+        {
+            while (value > (10 * STAmount::cMaxValue))
+            {
+                value /= 10;
+                ++offset;
+            }
+
+            value += 9;
+            value /= 10;
+            ++offset;
+        }
+    }
+
+    static
+    void
+    normalize (STAmount const& v, std::uint64_t& value, int& offset)
+    {
+        value = v.mantissa ();
+        offset = v.exponent ();
+
+        if (v.native ())
+        {
+            while (value < STAmount::cMinValue)
+            {
+                value *= 10;
+                --offset;
+            }
+        }
+    }
+
+    // The BIGNUM versions of the operations, for non-native results
+    static
+    STAmount
+    oldMultiply (STAmount const& v1, STAmount const& v2,
+        Issue const& issue)
+    {
+        std::uint64_t value1, value2;
+        int offset1, offset2;
+        normalize (v1, value1, offset1);
+        normalize (v2, value2, offset2);
+
+        return STAmount (issue, bigMulDiv (value1, value2, 0, tenTo14) + 7,
+            offset1 + offset2 + 14, v1.negative () != v2.negative ());
+    }
+
+    static
+    STAmount
+    oldDivide (STAmount const& num, STAmount const& den,
+        Issue const& issue)
+    {
+        std::uint64_t numVal, denVal;
+        int numOffset, denOffset;
+        normalize (num, numVal, numOffset);
+        normalize (den, denVal, denOffset);
+
+        return STAmount (issue, bigMulDiv (numVal, tenTo17, 0, denVal) + 5,
+            numOffset - denOffset - 17, num.negative () != den.negative ());
+    }
+
+    static
+    STAmount
+    oldMulRound (STAmount const& v1, STAmount const& v2,
+        Issue const& issue, bool roundUp)
+    {
+        std::uint64_t value1, value2;
+        int offset1, offset2;
+        normalize (v1, value1, offset1);
+        normalize (v2, value2, offset2);
+
+        bool const resultNegative = v1.negative () != v2.negative ();
+        std::uint64_t amount = bigMulDiv (value1, value2,
+            (resultNegative != roundUp) ? tenTo14 - 1 : 0, tenTo14);
+        int offset = offset1 + offset2 + 14;
+        canonicalizeRound (
+            isSWT (issue), amount, offset, resultNegative != roundUp);
+        return STAmount (issue, amount, offset, resultNegative);
+    }
+
+    static
+    STAmount
+    oldDivRound (STAmount const& num, STAmount const& den,
+        Issue const& issue, bool roundUp)
+    {
+        std::uint64_t numVal, denVal;
+        int numOffset, denOffset;
+        normalize (num, numVal, numOffset);
+        normalize (den, denVal, denOffset);
+
+        bool const resultNegative = num.negative () != den.negative ();
+        std::uint64_t amount = bigMulDiv (numVal, tenTo17,
+            (resultNegative != roundUp) ? denVal - 1 : 0, denVal);
+        int offset = numOffset - denOffset - 17;
+        canonicalizeRound (
+            isSWT (issue), amount, offset, resultNegative != roundUp);
+        return STAmount (issue, amount, offset, resultNegative);
+    }
+
+    // Both must produce the same amount, or both must throw
+    template <class New, class Old>
+    void
+    same (char const* name, New const& fresh, Old const& old)
+    {
+        bool threw = false;
+        STAmount want;
+        try
+        {
+            want = old ();
+        }
+        catch (std::runtime_error const&)
+        {
+            threw = true;
+        }
+
+        try
+        {
+            STAmount const got = fresh ();
+            if (! expect (! threw && got == want &&
+                    got.negative () == want.negative (), name))
+                log << name << ": " << got.getFullText () <<
+                    ", wanted " << want.getFullText ();
+        }
+        catch (std::runtime_error const&)
+        {
+            expect (threw, name);
+        }
+    }
+
+    void testAmounts ()
+    {
+        testcase ("amounts");
+
+        Issue const usd (Currency (0x5553440000000000), Account (0x4985601));
+
+        std::vector <std::uint64_t> const mantissas = {
+            STAmount::cMinValue, STAmount::cMinValue + 1,
+            STAmount::cMaxValue - 1, STAmount::cMaxValue,
+            3141592653589793ull };
+        std::vector <std::uint64_t> const drops = {
+            1, 7, 1000000, 99999999999ull, STAmount::cMaxNativeN };
+
+        std::vector <STAmount> amounts;
+        for (auto const mantissa : mantissas)
+        {
+            for (auto const offset : { STAmount::cMinOffset,
+                STAmount::cMinOffset + 1, -15, 0, 15,
+                STAmount::cMaxOffset - 1, STAmount::cMaxOffset })
+            {
+                amounts.emplace_back (usd, mantissa, offset, false);
+                amounts.emplace_back (usd, mantissa, offset, true);
+            }
+        }
+
+        // Native amounts reach mulDiv after being scaled into range
+        for (auto const n : drops)
+        {
+            amounts.emplace_back (n, false);
+            amounts.emplace_back (n, true);
+        }
+
+        for (auto const& a : amounts)
+        {
+            for (auto const& b : amounts)
+            {
+                same ("multiply",
+                    [&]{ return multiply (a, b, usd); },
+                    [&]{ return oldMultiply (a, b, usd); });
+                same ("divide",
+                    [&]{ return divide (a, b, usd); },
+                    [&]{ return oldDivide (a, b, usd); });
+
+                for (bool const roundUp : { false, true })
+                {
+                    same ("mulRound",
+                        [&]{ return mulRound (a, b, usd, roundUp); },
+                        [&]{ return oldMulRound (a, b, usd, roundUp); });
+                    same ("divRound",
+                        [&]{ return divRound (a, b, usd, roundUp); },
+                        [&]{ return oldDivRound (a, b, usd, roundUp); });
+                }
+            }
+        }
+    }
+
+    void run ()
+    {
+        testEdges ();
+        testRandom ();
+        testAmounts ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(MulDiv,protocol,skywell);
+
+} // skywell
@@ -0,0 +1,189 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <protocol/STParsedJSON.h>
+#include <protocol/STTx.h>
+#include <protocol/SkywellAddress.h>
+#include <common/json/json_reader.h>
+#include <common/json/json_writer.h>
+#include <beast/chrono/chrono_io.h>
+#include <beast/unit_test/suite.h>
+#include <chrono>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+namespace skywell {
+
+// Measures the submit path from request text to STTx: Json::Reader
+// builds the DOM, STParsedJSON converts it and STTx is built from the
+// result. Each stage is timed on its own over the same documents.
+class STParsedJSON_test : public beast::unit_test::suite
+{
+public:
+    typedef std::chrono::high_resolution_clock clock_type;
+
+    static std::string account (int n)
+    {
+        return SkywellAddress::createAccountID (
+            Account (n)).humanAccountID ();
+    }
+
+    // Signed transactions as they arrive in a submit request
+    std::vector <std::string> makeCorpus ()
+    {
+        std::vector <std::string> corpus;
+        Json::FastWriter writer;
+
+        auto const common = [](Json::Value& tx, int n)
+        {
+            tx["Account"] = account (n);
+            tx["Fee"] = "10";
+            tx["Flags"] = 2147483648u;
+            tx["Sequence"] = 1000 + n;
+            tx["LastLedgerSequence"] = 500000 + n;
+            tx["SigningPubKey"] = "0330E7FC9D56BB25D6893BA3F317AE5BCF33B3291BD"
+                "63DB32654A313222F7FD020";
+            tx["TxnSignature"] = "3045022100D184EB4AE5956FF600E7536EE459345C"
+                "7BBCF097A84CC61A93B9AF7197EDB98702201CEA8009B7BEEBAA2AACC0359"
+                "B41C427C1C5B550A4CA4B80CF2174AF2D6D5DCE";
+        };
+
+        for (int n = 1; n <= 16; ++n)
+        {
+            {
+                // Native payment
+                Json::Value tx (Json::objectValue);
+                tx["TransactionType"] = "Payment";
+                common (tx, n);
+                tx["Destination"] = account (n + 100);
+                tx["Amount"] = std::to_string (1000000 * n);
+                corpus.push_back (writer.write (tx));
+            }
+            {
+                // Issued currency payment with paths
+                Json::Value tx (Json::objectValue);
+                tx["TransactionType"] = "Payment";
+                common (tx, n);
+                tx["Destination"] = account (n + 200);
+                Json::Value& amount = tx["Amount"];
+                amount["currency"] = "USD";
+                amount["issuer"] = account (1000);
+                amount["value"] = "12.345";
+                tx["SendMax"] = std::to_string (20000000 * n);
+                Json::Value& path = tx["Paths"].append (Json::arrayValue);
+                Json::Value& step = path.append (Json::objectValue);
+                step["currency"] = "USD";
+                step["issuer"] = account (1000);
+                Json::Value& hop = path.append (Json::objectValue);
+                hop["account"] = account (1001);
+                corpus.push_back (writer.write (tx));
+            }
+            {
+                // Native payment with a memo
+                Json::Value tx (Json::objectValue);
+                tx["TransactionType"] = "Payment";
+                common (tx, n);
+                tx["Destination"] = account (n + 300);
+                tx["Amount"] = "2500000";
+                tx["DestinationTag"] = n;
+                Json::Value& memo = tx["Memos"].append (
+                    Json::objectValue)["Memo"];
+                memo["MemoType"] = "6F72646572";
+                memo["MemoData"] = "72656620313233343536373839";
+                corpus.push_back (writer.write (tx));
+            }
+        }
+
+        return corpus;
+    }
+
+    template <class Duration>
+    void report (std::string const& what, Duration elapsed, std::size_t n)
+    {
+        using namespace std::chrono;
+        auto const us = duration_cast <microseconds> (elapsed).count ();
+        log << std::setw (12) << what << " " <<
+            duration <double> (elapsed) << "s, " <<
+            (n ? double (us) / n : 0) << "us each";
+    }
+
+    void run ()
+    {
+        enum
+        {
+            rounds = 2000
+        };
+
+        auto const corpus = makeCorpus ();
+        std::size_t const n = rounds * corpus.size ();
+
+        // Stage 1: request text to Json::Value
+        std::vector <Json::Value> values (corpus.size ());
+        {
+            Json::Reader reader;
+            auto const start = clock_type::now ();
+            for (int r = 0; r < rounds; ++r)
+                for (std::size_t i = 0; i < corpus.size (); ++i)
+                    reader.parse (corpus[i], values[i]);
+            report ("Reader", clock_type::now () - start, n);
+        }
+
+        for (auto const& value : values)
+            expect (value.isObject (), "parse");
+
+        // Stage 2: Json::Value to STObject
+        {
+            bool ok = true;
+            auto const start = clock_type::now ();
+            for (int r = 0; r < rounds; ++r)
+                for (auto const& value : values)
+                    ok = STParsedJSONObject ("tx_json", value).object && ok;
+            report ("STParsedJSON", clock_type::now () - start, n);
+            expect (ok, "STParsedJSON");
+        }
+
+        // Stage 3: STObject to STTx, including a copy of the object
+        {
+            std::vector <STObject> objects;
+            for (auto const& value : values)
+                objects.push_back (*STParsedJSONObject ("tx_json", value).object);
+
+            std::size_t built = 0;
+            auto const start = clock_type::now ();
+            for (int r = 0; r < rounds; ++r)
+            {
+                for (auto const& object : objects)
+                {
+                    STObject copy (object);
+                    STTx const tx (std::move (copy));
+                    built += tx.getTxnType () == ttPAYMENT;
+                }
+            }
+            report ("STTx", clock_type::now () - start, n);
+            expect (built == n, "STTx");
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(STParsedJSON,protocol,skywell);
+
+} // skywell
@@ -26,6 +26,7 @@
 #include <protocol/Book.h>
 #include <network/resource/Consumer.h>
 #include <beast/threads/Stoppable.h>
+#include <atomic>
 #include <mutex>
 
 namespace skywell {
@@ -116,6 +117,24 @@ public:
     // virtual so that a derived class can optimize this case
     virtual void send (Json::Value const& jvObj, std::string const& sObj, bool broadcast);
 
+    /** Send a stream message in the binary stream format.
+        Only called when isBinary() is true.
+    */
+    virtual void sendBinary (std::string const& message);
+
+    /** Returns `true` if ledger and transaction streams should be sent
+        in the binary stream format instead of JSON.
+    */
+    bool isBinary () const
+    {
+        return mBinary;
+    }
+
+    void setBinary (bool binary)
+    {
+        mBinary = binary;
+    }
+
     std::uint64_t getSeq ();
 
     void onSendEmpty ();
@@ -143,6 +162,7 @@ private:
     hash_set<SkywellAddress>      mSubAccountTransaction;
     std::shared_ptr<PathRequest>  mPathRequest;
     std::uint64_t                 mSeq;
+    std::atomic <bool>            mBinary;
 };
 
 } // skywell
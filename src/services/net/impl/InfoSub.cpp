@@ -46,6 +46,7 @@ InfoSub::Source::Source (char const* name, Stoppable& parent)
 InfoSub::InfoSub (Source& source, Consumer consumer)
     : m_consumer (consumer)
     , m_source (source)
+    , mBinary (false)
 {
     static std::atomic <int> s_seq_id (0);
     mSeq = ++s_seq_id;
@@ -78,6 +79,10 @@ void InfoSub::send (
     send (jvObj, broadcast);
 }
 
+void InfoSub::sendBinary (std::string const&)
+{
+}
+
 std::uint64_t InfoSub::getSeq ()
 {
     return mSeq;
@@ -476,6 +476,17 @@ private:
         return jvRequest;
     }
 
+    // consensus_timings [<limit>]
+    Json::Value parseConsensusTimings (Json::Value const& jvParams)
+    {
+        Json::Value jvRequest (Json::objectValue);
+
+        if (jvParams.size ())
+            jvRequest[jss::limit] = jvParams[0u].asUInt ();
+
+        return jvRequest;
+    }
+
     // Return an error for attemping to subscribe/unsubscribe via RPC.
     Json::Value parseEvented (Json::Value const& jvParams)
     {
@@ -996,6 +1007,7 @@ public:
             {   "can_delete",           &RPCParser::parseCanDelete,             0,  1   },
             {   "connect",              &RPCParser::parseConnect,               1,  2   },
             {   "consensus_info",       &RPCParser::parseAsIs,                  0,  0   },
+            {   "consensus_timings",    &RPCParser::parseConsensusTimings,      0,  1   },
             {   "data_info",            &RPCParser::parseAsIs,                  0,  0   },
             {   "feature",              &RPCParser::parseFeature,               0,  2   },
             {   "fetch_info",           &RPCParser::parseFetchInfo,             0,  1   },
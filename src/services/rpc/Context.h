@@ -41,6 +41,7 @@ struct Context
     Role role;
     InfoSub::pointer infoSub;
     RPC::Yield yield;
+    RPC::Suspend suspend;
     NodeStore::ScopedMetrics metrics;
 };
 
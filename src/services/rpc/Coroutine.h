@@ -30,8 +30,10 @@ class Coroutine
 {
 public:
     using YieldFunction = std::function <void (Yield const&)>;
+    using SuspendFunction = std::function <void (Yield const&, Suspend const&)>;
 
     explicit Coroutine (YieldFunction const&);
+    explicit Coroutine (SuspendFunction const&);
     ~Coroutine();
 
     /** Is the coroutine finished? */
@@ -40,6 +42,14 @@ public:
     /** Run one more step of the coroutine. */
     void operator()() const;
 
+    /** Arrange for the coroutine to be resumed, if its last step ended
+        in a Suspend.
+        @param resume Called when the coroutine may run another step.
+        @return `false` if the step ended in a Yield instead, in which case
+                the coroutine may run again right away.
+    */
+    bool resumeWhenReady (std::function <void ()> const& resume) const;
+
 private:
     struct Impl;
 
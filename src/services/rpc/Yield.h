@@ -40,6 +40,19 @@ namespace RPC {
 */
 using Yield = std::function <void ()>;
 
+/** Suspend is like Yield, except that the coroutine does not run again
+    until something else resumes it.
+
+    The argument is called once the coroutine has stopped, with a function
+    which resumes it. It must arrange for that function to be called once,
+    perhaps from another thread, when whatever the coroutine waits for
+    has happened.
+
+    The same rules about locks apply as for Yield.
+*/
+using Suspend = std::function <void (
+    std::function <void (std::function <void ()> const&)> const&)>;
+
 /** Wrap an Output so it yields after approximately `chunkSize` bytes.
 
     chunkedYieldingOutput() only yields after a call to output(), so there might
@@ -23,6 +23,8 @@
 #include <services/rpc/impl/LookupLedger.h>
 #include <protocol/ErrorCodes.h>
 #include <services/rpc/impl/AccountFromString.h>
+#include <services/rpc/impl/Prefetch.h>
+#include <protocol/Indexes.h>
 
 namespace skywell {
 
@@ -65,6 +67,9 @@ Json::Value doAccountInfo (RPC::Context& context)
     if (!jvAccepted.empty ())
         return jvAccepted;
 
+    RPC::prefetchEntry (context, *ledger, getAccountRootIndex (naAccount));
+    RPC::prefetchEntry (context, *ledger, getNickNameIndex (naAccount));
+
     auto asAccepted = context.netOps.getAccountState (ledger, naAccount);
 
     if (asAccepted)
@@ -109,6 +114,8 @@ Json::Value doNicknameInfo(RPC::Context& context)
 	if (!jvAccepted.empty())
 		return jvAccepted;
 
+	RPC::prefetchEntry(context, *ledger, getNickNameIndex(naAccount));
+
 	auto asAccepted = context.netOps.getAccountState1(ledger, naAccount);
 
 	if (asAccepted)
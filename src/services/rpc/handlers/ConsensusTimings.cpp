@@ -0,0 +1,44 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012-2014 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <services/rpc/Context.h>
+#include <consensus/ConsensusTimings.h>
+#include <protocol/JsonFields.h>
+#include <main/Application.h>
+
+namespace skywell {
+
+// {
+//   limit: integer                 // optional, most recent rounds to return
+// }
+Json::Value doConsensusTimings (RPC::Context& context)
+{
+    std::size_t limit = ConsensusTimings::ringSize;
+
+    if (context.params.isMember (jss::limit))
+        limit = context.params[jss::limit].asUInt ();
+
+    Json::Value jvResult;
+    jvResult[jss::rounds] = getApp().getConsensusTimings ().getJson (limit);
+
+    return jvResult;
+}
+
+} // skywell
@@ -24,6 +24,7 @@ namespace skywell {
 
 Json::Value doAccountInfo           (RPC::Context&);
 Json::Value doAccountTx             (RPC::Context&);
+Json::Value doConsensusTimings      (RPC::Context&);
 Json::Value doLedgerAccept          (RPC::Context&);
 Json::Value doLedgerCleaner         (RPC::Context&);
 Json::Value doLedgerClosed          (RPC::Context&);
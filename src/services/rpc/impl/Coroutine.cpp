@@ -19,29 +19,57 @@
 
 #include <BeastConfig.h>
 #include <services/rpc/Coroutine.h>
+#include <data/nodestore/ScopedMetrics.h>
 // #include <services/rpc/tests/TestOutputSuite.test.h>
 
 namespace skywell {
 namespace RPC {
 
 using CoroutinePull = boost::coroutines::coroutine <void>::pull_type;
+using Start = std::function <void (std::function <void ()> const&)>;
 
 struct Coroutine::Impl : CoroutinePull
 {
-    Impl (CoroutinePull&& p) : CoroutinePull (std::move(p)) {}
+    Impl (CoroutinePull&& p, std::shared_ptr<Start> const& s)
+        : CoroutinePull (std::move(p)), suspended (s)
+    {
+    }
+
+    // Set when the last step ended in a Suspend
+    std::shared_ptr<Start> suspended;
+
+    // The metrics the coroutine had installed when it last stopped
+    NodeStore::ScopedMetrics* metrics = nullptr;
 };
 
 Coroutine::Coroutine (YieldFunction const& yieldFunction)
+    : Coroutine (SuspendFunction (
+        [yieldFunction] (Yield const& yield, Suspend const&)
+        {
+            yieldFunction (yield);
+        }))
+{
+}
+
+Coroutine::Coroutine (SuspendFunction const& suspendFunction)
 {
-    CoroutinePull pull ([yieldFunction] (
+    auto suspended = std::make_shared<Start> ();
+
+    CoroutinePull pull ([suspendFunction, suspended] (
         boost::coroutines::coroutine <void>::push_type& push)
     {
         Yield yield = [&push] () { push(); };
+        Suspend suspend = [&push, suspended] (Start const& start)
+        {
+            // Resuming must wait until this coroutine has stopped
+            *suspended = start;
+            push();
+        };
         yield ();
-        yieldFunction (yield);
+        suspendFunction (yield, suspend);
     });
 
-    impl_ = std::make_shared<Impl> (std::move (pull));
+    impl_ = std::make_shared<Impl> (std::move (pull), suspended);
 }
 
 Coroutine::~Coroutine() = default;
@@ -53,8 +81,41 @@ Coroutine::operator bool() const
 
 void Coroutine::operator()() const
 {
+    // Metrics created on the coroutine's stack live in thread local
+    // storage, so they are installed for each step and taken away after
+    // it. Otherwise the thread would keep them while running other jobs,
+    // and the next step, perhaps on another thread, would not see them.
+    struct Swap
+    {
+        Impl& impl;
+        NodeStore::ScopedMetrics* const outer;
+
+        explicit Swap (Impl& i)
+            : impl (i)
+            , outer (NodeStore::ScopedMetrics::exchange (i.metrics))
+        {
+        }
+
+        ~Swap ()
+        {
+            impl.metrics = NodeStore::ScopedMetrics::exchange (outer);
+        }
+    };
+
+    Swap swap (*impl_);
     (*impl_)();
 }
 
+bool Coroutine::resumeWhenReady (std::function <void ()> const& resume) const
+{
+    if (! *impl_->suspended)
+        return false;
+
+    Start start;
+    std::swap (start, *impl_->suspended);
+    start (resume);
+    return true;
+}
+
 } // RPC
 } // skywell
@@ -100,6 +100,7 @@ HandlerTable HANDLERS({
     // Request-response methods
     {   "account_info",         byRef (&doAccountInfo),         Role::USER,  NO_CONDITION  },
     {   "account_tx",           byRef (&doAccountTxSwitch),     Role::USER,  NO_CONDITION  },
+    {   "consensus_timings",    byRef (&doConsensusTimings),    Role::ADMIN,   NO_CONDITION  },
     {   "ledger_accept",        byRef (&doLedgerAccept),        Role::ADMIN,   NEEDS_CURRENT_LEDGER  },
     {   "ledger_cleaner",       byRef (&doLedgerCleaner),       Role::ADMIN,   NEEDS_NETWORK_CONNECTION  },
     {   "ledger_closed",        byRef (&doLedgerClosed),        Role::USER,  NO_CONDITION   },
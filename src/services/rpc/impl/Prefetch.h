@@ -0,0 +1,43 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012=2014 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef SKYWELL_RPC_PREFETCH_H_INCLUDED
+#define SKYWELL_RPC_PREFETCH_H_INCLUDED
+
+#include <ledger/Ledger.h>
+#include <services/rpc/Context.h>
+
+namespace skywell {
+namespace RPC {
+
+/** Bring a ledger entry into memory before it is looked up.
+
+    When the request runs in a coroutine, each node on the path to the
+    entry which is not in memory is read by the NodeStore's prefetch
+    threads while the coroutine is suspended, so that the job queue
+    thread serves other work in the meantime. Otherwise this does
+    nothing, and the lookup reads the nodes itself.
+*/
+void prefetchEntry (
+    Context& context, Ledger const& ledger, uint256 const& index);
+
+} // RPC
+} // skywell
+
+#endif
@@ -0,0 +1,152 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <services/rpc/Coroutine.h>
+#include <data/nodestore/ScopedMetrics.h>
+#include <beast/unit_test/suite.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace skywell {
+namespace RPC {
+
+class Coroutine_test : public beast::unit_test::suite
+{
+public:
+    void testYield ()
+    {
+        testcase ("yield");
+
+        std::vector <std::string> steps;
+        Coroutine coroutine (Coroutine::YieldFunction (
+            [&] (Yield const& yield)
+            {
+                steps.push_back ("a");
+                yield ();
+                steps.push_back ("b");
+            }));
+
+        expect (coroutine, "not started");
+        expect (steps.empty (), "nothing runs before the first step");
+
+        coroutine ();
+        expect (steps == std::vector <std::string> ({"a"}));
+        expect (! coroutine.resumeWhenReady ([&] { fail ("resumed"); }),
+            "a yield may run again right away");
+
+        coroutine ();
+        expect (steps == std::vector <std::string> ({"a", "b"}));
+        expect (! coroutine, "finished");
+    }
+
+    void testSuspend ()
+    {
+        testcase ("suspend");
+
+        std::vector <std::string> steps;
+        std::function <void ()> resumer;
+
+        Coroutine coroutine (Coroutine::SuspendFunction (
+            [&] (Yield const& yield, Suspend const& suspend)
+            {
+                steps.push_back ("a");
+                suspend ([&] (std::function <void ()> const& resume)
+                {
+                    // Only called once the step has ended
+                    steps.push_back ("start");
+                    resumer = resume;
+                });
+                steps.push_back ("b");
+                yield ();
+                steps.push_back ("c");
+            }));
+
+        coroutine ();
+        expect (steps == std::vector <std::string> ({"a"}),
+            "the start function waits for the step to end");
+
+        bool resumed = false;
+        expect (coroutine.resumeWhenReady ([&] { resumed = true; }));
+        expect (steps == std::vector <std::string> ({"a", "start"}));
+        expect (! resumed, "not resumed until the start function says so");
+
+        resumer ();
+        expect (resumed);
+
+        coroutine ();
+        expect (steps == std::vector <std::string> ({"a", "start", "b"}));
+        expect (! coroutine.resumeWhenReady ([&] { fail ("resumed"); }),
+            "a yield after a suspend is not suspended");
+
+        coroutine ();
+        expect (steps ==
+            std::vector <std::string> ({"a", "start", "b", "c"}));
+        expect (! coroutine, "finished");
+    }
+
+    void testThreads ()
+    {
+        testcase ("threads");
+
+        std::size_t fetches = 0;
+        Coroutine coroutine (Coroutine::SuspendFunction (
+            [&] (Yield const&, Suspend const& suspend)
+            {
+                NodeStore::ScopedMetrics metrics;
+                NodeStore::ScopedMetrics::incrementThreadFetches ();
+                suspend ([] (std::function <void ()> const& resume)
+                {
+                    resume ();
+                });
+                NodeStore::ScopedMetrics::incrementThreadFetches ();
+                fetches = metrics.fetches;
+            }));
+
+        coroutine ();
+        expect (NodeStore::ScopedMetrics::get () == nullptr,
+            "the metrics are not left behind on the thread");
+
+        std::function <void ()> run = [&] { coroutine (); };
+        expect (coroutine.resumeWhenReady ([&]
+            {
+                // Finish on another thread
+                std::thread (run).join ();
+            }));
+
+        expect (! coroutine, "finished");
+        expect (fetches == 2, "the metrics follow the coroutine");
+        expect (NodeStore::ScopedMetrics::get () == nullptr,
+            "the thread's metrics are untouched");
+    }
+
+    void run ()
+    {
+        testYield ();
+        testSuspend ();
+        testThreads ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(Coroutine,RPC,skywell);
+
+} // RPC
+} // skywell
@@ -49,6 +49,12 @@ struct Port
     std::string ssl_chain;
     std::shared_ptr<boost::asio::ssl::context> context;
 
+    // Outbound queue of each websocket client, and what to do when
+    // it fills: "drop", "coalesce" or "disconnect"
+    std::size_t send_queue_messages = 4096;
+    std::size_t send_queue_bytes = 16 * 1024 * 1024;
+    std::string send_queue_overflow = "coalesce";
+
     // Returns `true` if any websocket protocols are specified
     template <class = void>
     bool
@@ -169,13 +169,20 @@ void runCoroutine (RPC::Coroutine coroutine, JobQueue& jobQueue)
     if (!coroutine)
         return;
 
-    // Reschedule the job on the job queue.
-    jobQueue.addJob (
-        jtCLIENT, "RPC-Coroutine",
-        [coroutine, &jobQueue] (Job&)
-        {
-            runCoroutine (coroutine, jobQueue);
-        });
+    auto resume = [coroutine, &jobQueue] ()
+    {
+        // Reschedule the job on the job queue.
+        jobQueue.addJob (
+            jtCLIENT, "RPC-Coroutine",
+            [coroutine, &jobQueue] (Job&)
+            {
+                runCoroutine (coroutine, jobQueue);
+            });
+    };
+
+    // A suspended coroutine holds no thread until it is resumed
+    if (! coroutine.resumeWhenReady (resume))
+        resume ();
 }
 
 } // namespace
@@ -206,15 +213,15 @@ ServerHandlerImp::onRequest (HTTP::Session& session)
 
     if (setup_.yieldStrategy.useCoroutines == RPC::YieldStrategy::UseCoroutines::yes)
     {
-        RPC::Coroutine::YieldFunction yieldFunction = [this, detach] (Yield const& y) { processSession (detach, y); };
+        RPC::Coroutine::SuspendFunction suspendFunction = [this, detach] (Yield const& y, Suspend const& s) { processSession (detach, y, s); };
 
-        runCoroutine (RPC::Coroutine (yieldFunction), m_jobQueue);
+        runCoroutine (RPC::Coroutine (suspendFunction), m_jobQueue);
     }
     else
     {
         m_jobQueue.addJob (
             jtCLIENT, "RPC-Client",
-            [=] (Job&) { processSession (detach, RPC::Yield{}); });
+            [=] (Job&) { processSession (detach, RPC::Yield{}, RPC::Suspend{}); });
     }
 }
 
@@ -234,7 +241,8 @@ ServerHandlerImp::onStopped (HTTP::Server&)
 
 // Dispatched on the job queue
 void
-ServerHandlerImp::processSession (std::shared_ptr<HTTP::Session> const& session, Yield const& yield)
+ServerHandlerImp::processSession (std::shared_ptr<HTTP::Session> const& session, Yield const& yield,
+    Suspend const& suspend)
 {
     auto output = makeOutput (*session);
     if (auto byteYieldCount = setup_.yieldStrategy.byteYieldCount)
@@ -248,7 +256,8 @@ ServerHandlerImp::processSession (std::shared_ptr<HTTP::Session> const& session,
         to_string (session->body()),
         end,
         output,
-        yield);
+        yield,
+        suspend);
 
     if (session->request().keep_alive())
         session->complete();
@@ -262,7 +271,8 @@ ServerHandlerImp::processRequest (
     std::string const& request,
     boost::asio::ip::tcp::endpoint const& remoteIPAddress,
     Output output,
-    Yield yield)
+    Yield yield,
+    Suspend suspend)
 {
     Json::Value jsonRPC;
     {
@@ -381,7 +391,7 @@ ServerHandlerImp::processRequest (
         << "doRpcCommand:" << strMethod << ":" << params.toStyledString();
 
     auto const start (std::chrono::high_resolution_clock::now ());
-    RPC::Context context {params, loadType, m_networkOPs, role, nullptr, yield};
+    RPC::Context context {params, loadType, m_networkOPs, role, nullptr, yield, suspend, {}};
     //RPC::RPCInfo::updateCmd(context.params,true);
     
     std::string response;
@@ -528,6 +538,9 @@ struct ParsedPort
     std::string ssl_key;
     std::string ssl_cert;
     std::string ssl_chain;
+    std::size_t send_queue_messages = 4096;
+    std::size_t send_queue_bytes = 16 * 1024 * 1024;
+    std::string send_queue_overflow = "coalesce";
 
     boost::optional<boost::asio::ip::address> ip;
     boost::optional<std::uint16_t> port;
@@ -629,6 +642,9 @@ parse_Port (ParsedPort& port, Section const& section, std::ostream& log)
     set (port.ssl_key,         "ssl_key",        section);
     set (port.ssl_cert,        "ssl_cert",       section);
     set (port.ssl_chain,       "ssl_chain",      section);
+    set (port.send_queue_messages, "send_queue_messages", section);
+    set (port.send_queue_bytes,    "send_queue_bytes",    section);
+    set (port.send_queue_overflow, "send_queue_overflow", section);
 }
 
 HTTP::Port
@@ -682,6 +698,18 @@ to_Port(ParsedPort const& parsed, std::ostream& log)
     p.ssl_cert       = parsed.ssl_cert;
     p.ssl_chain      = parsed.ssl_chain;
 
+    if (parsed.send_queue_overflow != "drop" &&
+        parsed.send_queue_overflow != "coalesce" &&
+        parsed.send_queue_overflow != "disconnect")
+    {
+        log << "Invalid value '" << parsed.send_queue_overflow <<
+            "' for key 'send_queue_overflow' in [" << p.name << "]\n";
+        throw std::exception();
+    }
+    p.send_queue_messages = parsed.send_queue_messages;
+    p.send_queue_bytes    = parsed.send_queue_bytes;
+    p.send_queue_overflow = parsed.send_queue_overflow;
+
     return p;
 }
 
@@ -63,6 +63,7 @@ public:
 private:
     using Output = Json::Output;
     using Yield  = RPC::Yield;
+    using Suspend = RPC::Suspend;
 
     void
     setup (Setup const& setup, beast::Journal journal) override;
@@ -114,14 +115,16 @@ private:
     //--------------------------------------------------------------------------
 
     void
-    processSession (std::shared_ptr<HTTP::Session> const&, Yield const&);
+    processSession (std::shared_ptr<HTTP::Session> const&, Yield const&,
+        Suspend const&);
 
     void
     processRequest (HTTP::Port const& port, 
                     std::string const& request,
                     boost::asio::ip::tcp::endpoint const& remoteIPAddress,
                     Output,
-                    Yield);
+                    Yield,
+                    Suspend);
 
     //
     // PropertyStream
@@ -22,6 +22,7 @@
 
 #include <main/Application.h>
 #include <common/misc/NetworkOPs.h>
+#include <common/misc/impl/BinaryStream.h>
 #include <common/base/CountedObject.h>
 #include <common/base/Log.h>
 #include <common/core/Config.h>
@@ -37,7 +38,9 @@
 #include <services/server/Port.h>
 #include <services/rpc/RPCHandler.h>
 #include <services/server/Role.h>
+#include <services/websocket/SendQueue.h>
 #include <services/websocket/WebSocket.h>
+#include <beast/utility/PropertyStream.h>
 #include <boost/asio.hpp>
 #include <memory>
 
@@ -47,6 +50,15 @@ namespace websocket {
 template <class WebSocket>
 class HandlerImpl;
 
+inline
+SendQueue::Overflow
+overflowPolicy (HTTP::Port const& port)
+{
+    SendQueue::Overflow overflow = SendQueue::Overflow::coalesce;
+    SendQueue::parse (port.send_queue_overflow, overflow);
+    return overflow;
+}
+
 /** A Skywell WebSocket connection handler.
 */
 template <class WebSocket>
@@ -81,6 +93,11 @@ public:
 
     void send (Json::Value const& jvObj, bool broadcast);
 
+    void send (Json::Value const& jvObj, std::string const& sObj,
+        bool broadcast) override;
+
+    void sendBinary (std::string const& message) override;
+
     void disconnect ();
 
     static void handle_disconnect(weak_connection_ptr c);
@@ -99,7 +116,20 @@ public:
     // Generically implemented per version.
     void setPingTimer ();
 
+    void onWrite (beast::PropertyStream::Map& map);
+
 private:
+    // Bytes websocketpp may hold for the socket before the send queue
+    // stops handing it messages, and how long to wait when it is full
+    static std::size_t const sendBufferLimit = 256 * 1024;
+    static int const sendRetryMilliseconds = 50;
+
+    void enqueue (std::string const& message, bool broadcast,
+        SendQueue::Kind kind, bool binary);
+    void drainSendQueue ();
+    void sendTimer (typename WebSocket::ErrorCode const& e);
+
+
     HTTP::Port const& m_port;
     Resource::Manager& m_resourceManager;
     Resource::Consumer m_usage;
@@ -115,6 +145,11 @@ private:
     bool m_receiveQueueRunning = false;
     bool m_isDead = false;
 
+    std::mutex m_sendQueueMutex;
+    SendQueue m_sendQueue;
+    bool m_sending = false;
+    bool m_sendClosed = false;
+
     handler_type& m_handler;
     weak_connection_ptr m_connection;
 };
@@ -136,6 +171,8 @@ ConnectionImpl <WebSocket>::ConnectionImpl (
         , m_netOPs (getApp ().getOPs ())
         , m_io_service (io_service)
         , m_pingTimer (io_service)
+        , m_sendQueue (m_port.send_queue_messages, m_port.send_queue_bytes,
+            overflowPolicy (m_port))
         , m_handler (handler)
         , m_connection (cpConnection)
 {
@@ -277,7 +314,10 @@ Json::Value ConnectionImpl <WebSocket>::invokeCommand (Json::Value& jvRequest)
                               loadType, 
                               m_netOPs,
                               role,
-                              std::dynamic_pointer_cast<InfoSub> (this->shared_from_this ())};
+                              std::dynamic_pointer_cast<InfoSub> (this->shared_from_this ()),
+                              {},
+                              {},
+                              {}};
 
         RPC::doCommand (context, jvResult[jss::result]);
        // RPC::RPCInfo::update(context.params,false,jvResult[jss::result]); //
@@ -329,18 +369,147 @@ void ConnectionImpl <WebSocket>::preDestroy ()
         ScopedLockType sl (this->m_receiveQueueMutex);
         this->m_isDead = true;
     }
+
+    {
+        ScopedLockType sl (this->m_sendQueueMutex);
+        this->m_sendClosed = true;
+        this->m_sendQueue.clear ();
+    }
 }
 
 // Implement overridden functions from base class:
 template <class WebSocket>
 void ConnectionImpl <WebSocket>::send (Json::Value const& jvObj, bool broadcast)
 {
-    WriteLog (lsDEBUG, ConnectionImpl) << "WebSocket: sending '" << to_string (jvObj);
+    send (jvObj, to_string (jvObj), broadcast);
+}
+
+template <class WebSocket>
+void ConnectionImpl <WebSocket>::send (
+    Json::Value const& jvObj, std::string const& sObj, bool broadcast)
+{
+    WriteLog (lsDEBUG, ConnectionImpl) << "WebSocket: sending '" << sObj;
+
+    SendQueue::Kind kind = SendQueue::other;
+    if (broadcast && jvObj.isObject () && jvObj.isMember (jss::type))
+    {
+        auto const& type = jvObj[jss::type];
+        if (type == "ledgerClosed")
+            kind = SendQueue::ledgerClosed;
+        else if (type == "serverStatus")
+            kind = SendQueue::serverStatus;
+    }
+
+    enqueue (sObj, broadcast, kind, false);
+}
+
+template <class WebSocket>
+void ConnectionImpl <WebSocket>::sendBinary (std::string const& message)
+{
+    SendQueue::Kind kind = SendQueue::other;
+    if (! message.empty () && message[0] == BinaryStream::ledgerClosed)
+        kind = SendQueue::ledgerClosed;
+
+    enqueue (message, true, kind, true);
+}
+
+template <class WebSocket>
+void ConnectionImpl <WebSocket>::enqueue (std::string const& message,
+    bool broadcast, SendQueue::Kind kind, bool binary)
+{
+    bool accepted;
+    bool drain = false;
+    {
+        ScopedLockType sl (m_sendQueueMutex);
+        if (m_sendClosed)
+            return;
+
+        accepted = m_sendQueue.push (message, broadcast, kind, binary);
+        if (! accepted)
+            m_sendClosed = true;
+        else if (! m_sending)
+            drain = m_sending = true;
+    }
 
     connection_ptr ptr = m_connection.lock ();
+    if (! ptr)
+        return;
 
-    if (ptr)
-        m_handler.send (ptr, jvObj, broadcast);
+    if (! accepted)
+    {
+        WriteLog (lsWARNING, ConnectionImpl) <<
+            "WebSocket: send queue full, disconnecting";
+        disconnect ();
+    }
+    else if (drain)
+    {
+        // Never write from the publisher, which may hold locks
+        this->m_io_service.post (WebSocket::getStrand (*ptr).wrap (std::bind (
+            &ConnectionImpl <WebSocket>::drainSendQueue,
+                this->shared_from_this ())));
+    }
+}
+
+template <class WebSocket>
+void ConnectionImpl <WebSocket>::drainSendQueue ()
+{
+    connection_ptr ptr = m_connection.lock ();
+
+    std::string message;
+    bool binary = false;
+    bool broadcast = true;
+    for (;;)
+    {
+        if (ptr && ptr->get_buffered_amount () >= sendBufferLimit)
+        {
+            // Let the socket catch up instead of growing its buffer
+            ptr->set_timer (sendRetryMilliseconds, std::bind (
+                &ConnectionImpl <WebSocket>::sendTimer,
+                    this->shared_from_this (), std::placeholders::_1));
+            return;
+        }
+
+        {
+            ScopedLockType sl (m_sendQueueMutex);
+            if (! ptr || m_sendClosed || ! m_sendQueue.pop (message, binary, broadcast))
+            {
+                m_sending = false;
+                return;
+            }
+        }
+
+        if (binary)
+            m_handler.sendBinary (ptr, message);
+        else
+            m_handler.send (ptr, message, broadcast);
+    }
+}
+
+template <class WebSocket>
+void ConnectionImpl <WebSocket>::sendTimer (
+    typename WebSocket::ErrorCode const& e)
+{
+    if (! e)
+    {
+        drainSendQueue ();
+    }
+    else
+    {
+        ScopedLockType sl (m_sendQueueMutex);
+        m_sending = false;
+    }
+}
+
+template <class WebSocket>
+void ConnectionImpl <WebSocket>::onWrite (beast::PropertyStream::Map& map)
+{
+    map ["address"] = m_remoteAddress.address ().to_string ();
+
+    ScopedLockType sl (m_sendQueueMutex);
+    map ["queued_messages"] = m_sendQueue.messages ();
+    map ["queued_bytes"] = m_sendQueue.bytes ();
+    map ["dropped"] = m_sendQueue.dropped ();
+    map ["coalesced"] = m_sendQueue.coalesced ();
 }
 
 template <class WebSocket>
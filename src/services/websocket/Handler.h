@@ -143,6 +143,22 @@ public:
         send (cpClient, to_string (jvObj), broadcast);
     }
 
+    void sendBinary (connection_ptr const& cpClient,
+                     std::string const& strMessage)
+    {
+        try
+        {
+            WriteLog (lsTRACE, HandlerLog)
+                    << "Ws:: Sending " << strMessage.size () << " bytes";
+
+            WebSocket::sendBinary (*cpClient, strMessage);
+        }
+        catch (...)
+        {
+            WebSocket::closeTooSlowClient (*cpClient, crTooSlow);
+        }
+    }
+
     void pingTimer (connection_ptr const& cpClient)
     {
         wsc_ptr ptr;
@@ -210,6 +226,7 @@ public:
                 makeBeastEndpoint (remoteEndpoint),
                 WebSocket::getStrand (*cpClient).get_io_service ());
             connection->setPingTimer ();
+            connection->setBinary (WebSocket::isBinaryStream (*cpClient));
             auto result = mMap.emplace (cpClient, std::move (connection));
 
             assert (result.second);
@@ -402,7 +419,7 @@ public:
             jvResult[jss::error]   = "wsTextRequired";
             // We only accept text messages.
 
-            send (cpClient, jvResult, false);
+            conn->send (jvResult, false);
         }
         else if (!jrReader.parse (mpMessage->get_payload (), jvRequest) ||
                  jvRequest.isNull () || !jvRequest.isObject ())
@@ -413,7 +430,7 @@ public:
             jvResult[jss::error]   = "jsonInvalid";    // Received invalid json.
             jvResult[jss::value]   = mpMessage->get_payload ();
 
-            send (cpClient, jvResult, false);
+            conn->send (jvResult, false);
         }
         else
         {
@@ -440,7 +457,7 @@ public:
             rpc_size_.notify (static_cast <beast::insight::Event::value_type>
                              (buffer.size ()));
 
-            send (cpClient, buffer, false);
+            conn->send (jvObj, buffer, false);
         }
 
         return true;
@@ -483,6 +500,20 @@ public:
         return true;
     }
 
+    void onWrite (beast::PropertyStream::Map& map) override
+    {
+        ScopedLockType sl (mLock);
+
+        map ["connections"] = mMap.size ();
+
+        beast::PropertyStream::Set set ("clients", map);
+        for (auto const& item : mMap)
+        {
+            beast::PropertyStream::Map client (set);
+            item.second->onWrite (client);
+        }
+    }
+
     void recordMetrics (RPC::Context const& context) const
     {
         rpc_io_.notify (static_cast <beast::insight::Event::value_type> (context.metrics.fetches));
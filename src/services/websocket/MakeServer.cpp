@@ -26,7 +26,7 @@
 namespace skywell {
 namespace websocket {
 
-std::unique_ptr<beast::Stoppable>makeServer (ServerDescription const& desc)
+std::unique_ptr<Listener>makeServer (ServerDescription const& desc)
 {
     // TODO
     return makeServer04 (desc);
@@ -23,8 +23,8 @@
 #include <main/CollectorManager.h>
 #include <services/net/InfoSub.h>
 #include <services/server/Port.h>
-
-namespace beast { class Stoppable; }
+#include <beast/threads/Stoppable.h>
+#include <beast/utility/PropertyStream.h>
 
 namespace skywell {
 
@@ -44,7 +44,26 @@ struct ServerDescription
     CollectorManager& collectorManager;
 };
 
-std::unique_ptr<beast::Stoppable> makeServer (ServerDescription const&);
+/** A websocket server listening on one port.
+    Its connections and their send queues are written to the
+    PropertyStream under the name of the port.
+*/
+class Listener
+    : public beast::Stoppable
+    , public beast::PropertyStream::Source
+{
+protected:
+    Listener (char const* name, ServerDescription const& desc)
+        : beast::Stoppable (name, desc.source)
+        , beast::PropertyStream::Source (desc.port.name)
+    {
+    }
+
+public:
+    virtual ~Listener () = default;
+};
+
+std::unique_ptr<Listener> makeServer (ServerDescription const&);
 
 } // websocket
 } // skywell
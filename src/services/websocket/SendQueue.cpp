@@ -0,0 +1,171 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <services/websocket/SendQueue.h>
+
+namespace skywell {
+namespace websocket {
+
+SendQueue::SendQueue (std::size_t maxMessages, std::size_t maxBytes,
+    Overflow overflow)
+    : maxMessages_ (maxMessages)
+    , maxBytes_ (maxBytes)
+    , overflow_ (overflow)
+    , order_ (0)
+    , front_ (0)
+    , messages_ (0)
+    , bytes_ (0)
+    , dropped_ (0)
+    , coalesced_ (0)
+{
+    for (int i = 0; i < kinds; ++i)
+        hasLatest_[i] = false;
+}
+
+bool
+SendQueue::full (std::size_t size) const
+{
+    return entries () + 1 > maxMessages_ || bytes_ + size > maxBytes_;
+}
+
+void
+SendQueue::discard (Entry& entry)
+{
+    entry.live = false;
+    --messages_;
+    bytes_ -= entry.message.size ();
+    std::string ().swap (entry.message);
+}
+
+bool
+SendQueue::push (std::string const& message, bool broadcast, Kind kind,
+    bool binary)
+{
+    if (overflow_ == Overflow::coalesce && kind != other &&
+        hasLatest_[kind] && latest_[kind] >= front_)
+    {
+        auto& entry = broadcasts_[latest_[kind] - front_];
+        if (entry.live)
+        {
+            discard (entry);
+            ++coalesced_;
+        }
+    }
+
+    if (overflow_ == Overflow::disconnect && full (message.size ()))
+        return false;
+
+    // Drop the oldest subscription messages, along with any replaced
+    // ones ahead of them. The client is owed its responses, so those
+    // are kept.
+    while (full (message.size ()) && ! broadcasts_.empty ())
+    {
+        auto& entry = broadcasts_.front ();
+        if (entry.live)
+        {
+            discard (entry);
+            ++dropped_;
+        }
+        broadcasts_.pop_front ();
+        ++front_;
+    }
+
+    if (full (message.size ()) && broadcast)
+    {
+        ++dropped_;
+        return true;
+    }
+
+    Entry entry { message, order_++, binary, true };
+    ++messages_;
+    bytes_ += message.size ();
+
+    if (! broadcast)
+    {
+        responses_.push_back (std::move (entry));
+        return true;
+    }
+
+    broadcasts_.push_back (std::move (entry));
+
+    if (kind != other)
+    {
+        latest_[kind] = front_ + broadcasts_.size () - 1;
+        hasLatest_[kind] = true;
+    }
+
+    return true;
+}
+
+bool
+SendQueue::pop (std::string& message, bool& binary, bool& broadcast)
+{
+    while (! broadcasts_.empty () && ! broadcasts_.front ().live)
+    {
+        broadcasts_.pop_front ();
+        ++front_;
+    }
+
+    if (broadcasts_.empty () && responses_.empty ())
+        return false;
+
+    broadcast = responses_.empty () || (! broadcasts_.empty () &&
+        broadcasts_.front ().order < responses_.front ().order);
+
+    auto& queue = broadcast ? broadcasts_ : responses_;
+    auto& entry = queue.front ();
+    --messages_;
+    bytes_ -= entry.message.size ();
+    message.swap (entry.message);
+    binary = entry.binary;
+    queue.pop_front ();
+
+    if (broadcast)
+        ++front_;
+
+    return true;
+}
+
+void
+SendQueue::clear ()
+{
+    front_ += broadcasts_.size ();
+    broadcasts_.clear ();
+    responses_.clear ();
+    messages_ = 0;
+    bytes_ = 0;
+}
+
+bool
+SendQueue::parse (std::string const& name, Overflow& overflow)
+{
+    if (name == "drop")
+        overflow = Overflow::drop;
+    else if (name == "coalesce")
+        overflow = Overflow::coalesce;
+    else if (name == "disconnect")
+        overflow = Overflow::disconnect;
+    else
+        return false;
+    return true;
+}
+
+} // websocket
+} // skywell
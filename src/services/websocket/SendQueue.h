@@ -0,0 +1,170 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef SKYWELL_WEBSOCKET_SENDQUEUE_H_INCLUDED
+#define SKYWELL_WEBSOCKET_SENDQUEUE_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+namespace skywell {
+namespace websocket {
+
+/** Messages waiting to be handed to one websocket connection.
+
+    The queue is bounded by a count of messages and of bytes. Adding a
+    message never blocks; when it would exceed a bound, the overflow
+    policy decides what gives. Responses to the client's own requests
+    are never dropped, since the client is waiting for them.
+
+    @note This is not thread safe.
+*/
+class SendQueue
+{
+public:
+    enum class Overflow
+    {
+        // Discard the oldest subscription messages
+        drop,
+
+        // As drop, and a ledger or server status message also replaces
+        // a queued one of the same type
+        coalesce,
+
+        // Close the connection
+        disconnect
+    };
+
+    /** Subscription messages which make earlier ones obsolete. */
+    enum Kind
+    {
+        other,
+        ledgerClosed,
+        serverStatus,
+        kinds
+    };
+
+    SendQueue (std::size_t maxMessages, std::size_t maxBytes,
+        Overflow overflow);
+
+    /** Add a message.
+        @param broadcast `false` for a response to the client.
+        @param binary `true` to send the message in a binary frame.
+        @return `false` if the connection should be closed instead.
+    */
+    bool
+    push (std::string const& message, bool broadcast, Kind kind = other,
+        bool binary = false);
+
+    /** Remove the oldest message.
+        @param broadcast Set to `false` for a response to the client.
+        @return `false` if the queue is empty.
+    */
+    bool
+    pop (std::string& message, bool& binary, bool& broadcast);
+
+    /** Discard every queued message. */
+    void
+    clear ();
+
+    std::size_t
+    messages () const
+    {
+        return messages_;
+    }
+
+    std::size_t
+    bytes () const
+    {
+        return bytes_;
+    }
+
+    /** Entries held, counting replaced messages not yet removed. */
+    std::size_t
+    entries () const
+    {
+        return responses_.size () + broadcasts_.size ();
+    }
+
+    /** Messages discarded because the queue was full. */
+    std::uint64_t
+    dropped () const
+    {
+        return dropped_;
+    }
+
+    /** Messages replaced by a newer one of the same kind. */
+    std::uint64_t
+    coalesced () const
+    {
+        return coalesced_;
+    }
+
+    /** Parse an overflow policy named in the configuration.
+        @return `false` if the name is not recognized.
+    */
+    static
+    bool
+    parse (std::string const& name, Overflow& overflow);
+
+private:
+    struct Entry
+    {
+        std::string message;
+        std::uint64_t order;
+        bool binary;
+        bool live;
+    };
+
+    bool
+    full (std::size_t size) const;
+
+    void
+    discard (Entry& entry);
+
+    std::size_t const maxMessages_;
+    std::size_t const maxBytes_;
+    Overflow const overflow_;
+
+    // Responses are kept apart, so one the client has not read cannot
+    // hold subscription messages behind it. `order` merges the two.
+    std::deque <Entry> responses_;
+    std::deque <Entry> broadcasts_;
+    std::uint64_t order_;
+
+    // Replaced broadcasts stay in place, counted against the bound on
+    // messages, until they reach the front, so that coalescing does not
+    // search the queue.
+    // Sequence of the front broadcast, and of the latest of each kind
+    std::uint64_t front_;
+    std::uint64_t latest_[kinds];
+    bool hasLatest_[kinds];
+
+    std::size_t messages_;
+    std::size_t bytes_;
+    std::uint64_t dropped_;
+    std::uint64_t coalesced_;
+};
+
+} // websocket
+} // skywell
+
+#endif
@@ -30,7 +30,7 @@ namespace websocket {
 
 template <class WebSocket>
 class Server
-    : public beast::Stoppable
+    : public Listener
     , protected beast::Thread
 {
 private:
@@ -44,7 +44,7 @@ private:
 
 public:
     Server (ServerDescription const& desc)
-       : beast::Stoppable (WebSocket::versionName(), desc.source)
+        : Listener (WebSocket::versionName(), desc)
         , Thread ("websocket")
         , desc_(desc)
     {
@@ -101,6 +101,18 @@ private:
         signalThreadShouldExit ();
     }
 
+    void onWrite (beast::PropertyStream::Map& map) override
+    {
+        typename WebSocket::EndpointPtr endpoint;
+        {
+            ScopedLockType lock (m_endpointLock);
+            endpoint = m_endpoint;
+        }
+
+        if (endpoint)
+            endpoint->handler ()->onWrite (map);
+    }
+
     void listen();
 };
 
@@ -29,7 +29,7 @@ namespace websocket {
 using ScopedLockType = std::lock_guard <std::mutex>;
 
 // std::unique_ptr<beast::Stoppable> makeServer02 (ServerDescription const&);
-std::unique_ptr<beast::Stoppable> makeServer04 (ServerDescription const&);
+std::unique_ptr<Listener> makeServer04 (ServerDescription const&);
 
 } // websocket
 } // skywell
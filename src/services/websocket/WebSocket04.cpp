@@ -20,6 +20,7 @@
 #include <services/websocket/WebSocket04.h>
 #include <services/websocket/Handler.h>
 #include <services/websocket/Server.h>
+#include <common/misc/impl/BinaryStream.h>
 #include <boost/make_shared.hpp>
 
 namespace skywell {
@@ -47,6 +48,17 @@ bool WebSocket04::isTextMessage (Message const& message)
     return message.get_opcode () == websocketpp::frame::opcode::text;
 }
 
+void WebSocket04::sendBinary (Connection& connection,
+                              std::string const& message)
+{
+    connection.send (message, websocketpp::frame::opcode::binary);
+}
+
+bool WebSocket04::isBinaryStream (Connection const& connection)
+{
+    return connection.get_subprotocol () == BinaryStream::subprotocol;
+}
+
 using HandlerPtr04 = WebSocket04::HandlerPtr;
 using EndpointPtr04 = WebSocket04::EndpointPtr;
 
@@ -89,6 +101,23 @@ EndpointPtr04  WebSocket04::makeEndpoint (HandlerPtr&& handler)
                 endpoint->handler()->http (conn);
         });
 
+    // Accept the binary stream format when the client asks for it
+    endpoint->set_validate_handler (
+        [endpoint] (websocketpp::connection_hdl hdl) {
+            if (auto conn = endpoint->get_con_from_hdl(hdl))
+            {
+                for (auto const& protocol : conn->get_requested_subprotocols ())
+                {
+                    if (protocol == BinaryStream::subprotocol)
+                    {
+                        conn->select_subprotocol (protocol);
+                        break;
+                    }
+                }
+            }
+            return true;
+        });
+
     endpoint->set_message_handler (
         [endpoint] (websocketpp::connection_hdl hdl,
                     MessagePtr msg) {
@@ -141,7 +170,7 @@ void Server <WebSocket04>::listen()
 
 }
 
-std::unique_ptr<beast::Stoppable> makeServer04 (ServerDescription const& desc)
+std::unique_ptr<Listener> makeServer04 (ServerDescription const& desc)
 {
     return std::make_unique <Server <WebSocket04>> (desc);
 }
@@ -49,6 +49,9 @@ struct WebSocket04
         virtual void on_message (ConnectionPtr, MessagePtr) = 0;
         // This is a new method added by Skywell.
         virtual void on_send_empty (ConnectionPtr) = 0;
+
+        // Report the connections and their send queues.
+        virtual void onWrite (beast::PropertyStream::Map&) = 0;
     };
 
     using HandlerPtr = std::shared_ptr<Handler>;
@@ -88,6 +91,14 @@ struct WebSocket04
     static
     bool isTextMessage (Message const&);
 
+    /** Send a message in a BINARY frame. */
+    static
+    void sendBinary (Connection&, std::string const& message);
+
+    /** Return true if the client negotiated the binary stream format. */
+    static
+    bool isBinaryStream (Connection const&);
+
     /** Create a new Handler. */
     static
     HandlerPtr makeHandler (ServerDescription const&);
@@ -0,0 +1,233 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of skywelld: https://github.com/skywell/skywelld
+    Copyright (c) 2012, 2013 Skywell Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <services/websocket/SendQueue.h>
+#include <beast/unit_test/suite.h>
+#include <string>
+#include <vector>
+
+namespace skywell {
+namespace websocket {
+
+class SendQueue_test : public beast::unit_test::suite
+{
+public:
+    // Pops everything, in order
+    static
+    std::vector <std::string>
+    drain (SendQueue& q)
+    {
+        std::vector <std::string> result;
+        std::string message;
+        bool binary;
+        bool broadcast;
+        while (q.pop (message, binary, broadcast))
+            result.push_back (message);
+        return result;
+    }
+
+    void testDrop ()
+    {
+        testcase ("drop");
+
+        {
+            SendQueue q (3, 1000, SendQueue::Overflow::drop);
+            expect (q.push ("a", true));
+            expect (q.push ("r", false));
+            expect (q.push ("b", true));
+            expect (q.push ("c", true));
+            expect (q.messages () == 3 && q.dropped () == 1, "oldest dropped");
+            expect (drain (q) == std::vector <std::string> ({"r", "b", "c"}));
+            expect (q.messages () == 0 && q.bytes () == 0, "empty");
+        }
+
+        {
+            // A response at the front does not shield the broadcasts
+            SendQueue q (3, 1000, SendQueue::Overflow::drop);
+            expect (q.push ("r1", false));
+            expect (q.push ("a", true));
+            expect (q.push ("b", true));
+            expect (q.push ("c", true));
+            expect (q.messages () == 3 && q.dropped () == 1, "skip response");
+            expect (q.push ("r2", false));
+            expect (q.messages () == 3 && q.dropped () == 2, "room for r2");
+            expect (drain (q) ==
+                std::vector <std::string> ({"r1", "c", "r2"}));
+        }
+
+        {
+            // Responses are kept even past the limits
+            SendQueue q (2, 1000, SendQueue::Overflow::drop);
+            expect (q.push ("r1", false));
+            expect (q.push ("r2", false));
+            expect (q.push ("a", true));
+            expect (q.push ("r3", false));
+            expect (q.messages () == 3 && q.dropped () == 1, "responses kept");
+            expect (drain (q) ==
+                std::vector <std::string> ({"r1", "r2", "r3"}));
+        }
+
+        {
+            SendQueue q (100, 10, SendQueue::Overflow::drop);
+            q.push ("123456", false);
+            expect (q.push ("12345", true));
+            expect (q.messages () == 1 && q.dropped () == 1, "bytes bound");
+            expect (q.push ("1234567", false));
+            expect (q.messages () == 2, "response past the bytes bound");
+        }
+    }
+
+    void testCoalesce ()
+    {
+        testcase ("coalesce");
+
+        {
+            SendQueue q (100, 1000, SendQueue::Overflow::coalesce);
+            q.push ("L1", true, SendQueue::ledgerClosed);
+            q.push ("t1", true);
+            q.push ("L2", true, SendQueue::ledgerClosed);
+            q.push ("S1", true, SendQueue::serverStatus);
+            expect (q.messages () == 3 && q.coalesced () == 1, "replaced");
+
+            std::string m;
+            bool binary;
+            bool broadcast;
+            expect (q.pop (m, binary, broadcast) && m == "t1");
+            expect (q.pop (m, binary, broadcast) && m == "L2");
+
+            // The queued one was already sent, so nothing is replaced
+            q.push ("L3", true, SendQueue::ledgerClosed);
+            expect (drain (q) == std::vector <std::string> ({"S1", "L3"}));
+
+            q.push ("L4", true, SendQueue::ledgerClosed);
+            q.push ("L5", true, SendQueue::ledgerClosed);
+            expect (drain (q) == std::vector <std::string> ({"L5"}));
+        }
+
+        {
+            SendQueue q (10, 1000, SendQueue::Overflow::coalesce);
+            q.push ("B1", true, SendQueue::ledgerClosed, true);
+            q.push ("j", true);
+            q.push ("B2", true, SendQueue::ledgerClosed, true);
+
+            std::string m;
+            bool binary;
+            bool broadcast;
+            expect (q.pop (m, binary, broadcast) && m == "j" && ! binary,
+                "text frame");
+            expect (q.pop (m, binary, broadcast) && m == "B2" && binary,
+                "binary frame");
+            expect (! q.pop (m, binary, broadcast));
+        }
+    }
+
+    void testStuckResponse ()
+    {
+        testcase ("stuck response");
+
+        {
+            // Nothing is read, so the response stays at the front
+            SendQueue q (3, 1000, SendQueue::Overflow::drop);
+            expect (q.push ("r", false));
+            for (int i = 0; i < 1000; ++i)
+                expect (q.push (std::to_string (i), true));
+            expect (q.messages () == 3 && q.entries () == 3, "bounded");
+            expect (q.dropped () == 998);
+            expect (drain (q) ==
+                std::vector <std::string> ({"r", "998", "999"}));
+        }
+
+        {
+            // Replaced messages count against the bound
+            SendQueue q (4, 1000, SendQueue::Overflow::coalesce);
+            expect (q.push ("r", false));
+            for (int i = 0; i < 1000; ++i)
+                expect (q.push ("L" + std::to_string (i), true,
+                    SendQueue::ledgerClosed));
+            expect (q.messages () == 2 && q.entries () <= 4, "bounded");
+            expect (drain (q) ==
+                std::vector <std::string> ({"r", "L999"}));
+        }
+
+        {
+            // Responses and broadcasts leave in the order they came
+            SendQueue q (10, 1000, SendQueue::Overflow::drop);
+            q.push ("a", true);
+            q.push ("r1", false);
+            q.push ("b", true);
+            q.push ("r2", false);
+
+            std::string m;
+            bool binary;
+            bool broadcast;
+            expect (q.pop (m, binary, broadcast) && m == "a" && broadcast);
+            expect (q.pop (m, binary, broadcast) && m == "r1" && ! broadcast,
+                "a response");
+            expect (q.pop (m, binary, broadcast) && m == "b" && broadcast);
+            expect (q.pop (m, binary, broadcast) && m == "r2" && ! broadcast);
+            expect (! q.pop (m, binary, broadcast));
+        }
+    }
+
+    void testDisconnect ()
+    {
+        testcase ("disconnect");
+
+        SendQueue q (2, 1000, SendQueue::Overflow::disconnect);
+        expect (q.push ("a", true));
+        expect (q.push ("b", true));
+        expect (! q.push ("c", true), "broadcast");
+        expect (! q.push ("r", false), "response");
+        expect (q.dropped () == 0);
+
+        q.clear ();
+        expect (q.messages () == 0 && q.bytes () == 0, "cleared");
+        expect (q.push ("d", true));
+    }
+
+    void testParse ()
+    {
+        testcase ("parse");
+
+        SendQueue::Overflow overflow;
+        expect (SendQueue::parse ("drop", overflow) &&
+            overflow == SendQueue::Overflow::drop);
+        expect (SendQueue::parse ("coalesce", overflow) &&
+            overflow == SendQueue::Overflow::coalesce);
+        expect (SendQueue::parse ("disconnect", overflow) &&
+            overflow == SendQueue::Overflow::disconnect);
+        expect (! SendQueue::parse ("block", overflow));
+    }
+
+    void run ()
+    {
+        testDrop ();
+        testCoalesce ();
+        testStuckResponse ();
+        testDisconnect ();
+        testParse ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SendQueue,websocket,skywell);
+
+} // websocket
+} // skywell